@@ -0,0 +1,137 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <yave/assets/AssetLoader.h>
+#include <yave/assets/FolderAssetStore.h>
+
+#include <y/core/Chrono.h>
+
+#include <filesystem>
+
+#ifndef YAVE_NO_STDFS
+
+namespace yave {
+namespace {
+
+struct BenchAssetData {
+	core::Vector<u32> values;
+
+	y_serde2(values)
+};
+
+struct BenchAsset {
+	BenchAsset(DevicePtr, BenchAssetData&& data) {
+		for(u32 v : data.values) {
+			checksum += v;
+		}
+	}
+
+	u64 checksum = 0;
+};
+
+}
+
+YAVE_DECLARE_ASSET_TRAITS(BenchAsset, BenchAssetData, AssetType::Unknown);
+
+}
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static constexpr usize bench_asset_count = 1000;
+static constexpr usize bench_asset_values = 16 * 1024;
+
+static u64 expected_checksum(usize index, usize size) {
+	return u64(index) * size + (u64(size) * (size - 1)) / 2;
+}
+
+static core::String store_path(std::string_view name) {
+	return core::String((std::filesystem::temp_directory_path() / std::string(name)).string());
+}
+
+static core::Vector<AssetId> fill_store(AssetStore& store, usize count, usize size) {
+	core::Vector<AssetId> ids;
+	for(usize i = 0; i != count; ++i) {
+		BenchAssetData data;
+		for(usize j = 0; j != size; ++j) {
+			data.values << u32(i + j);
+		}
+
+		io2::Buffer buffer;
+		serde2::WritableArchive arc(buffer);
+		arc(data).unwrap();
+		ids << store.import(buffer, fmt("asset_%", i)).unwrap();
+	}
+	return ids;
+}
+
+y_test_func("AssetLoader load_async benchmark") {
+	const core::String path = store_path("yave_asset_loader_bench");
+	std::filesystem::remove_all(path.data());
+	std::filesystem::create_directories(path.data());
+	{
+		auto store = std::make_shared<FolderAssetStore>(path);
+		const auto ids = fill_store(*store, bench_asset_count, bench_asset_values);
+
+		auto check = [&](usize i, const AssetLoader::Result<BenchAsset>& asset) {
+			return asset && asset.unwrap()->checksum == expected_checksum(i, bench_asset_values);
+		};
+
+		double single_ms = 0.0;
+		{
+			AssetLoader loader(store);
+			core::Chrono chrono;
+			usize valid = 0;
+			for(usize i = 0; i != ids.size(); ++i) {
+				valid += check(i, loader.load<BenchAsset>(ids[i]));
+			}
+			single_ms = chrono.elapsed().to_millis();
+			y_test_assert(valid == ids.size());
+		}
+
+		double async_ms = 0.0;
+		{
+			AssetLoader loader(store);
+			core::Chrono chrono;
+			core::Vector<AssetLoader::AsyncResult<BenchAsset>> results;
+			for(AssetId id : ids) {
+				results << loader.load_async<BenchAsset>(id);
+			}
+			usize valid = 0;
+			for(usize i = 0; i != results.size(); ++i) {
+				valid += check(i, results[i].get());
+			}
+			async_ms = chrono.elapsed().to_millis();
+			y_test_assert(valid == ids.size());
+		}
+
+		log_msg(fmt("Asset loading: % assets in %ms on 1 thread, %ms on % threads",
+			ids.size(), single_ms, async_ms, concurrent::default_thread_pool().concurency()));
+	}
+	std::filesystem::remove_all(path.data());
+}
+
+}
+
+#endif // YAVE_NO_STDFS
@@ -0,0 +1,93 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+
+#include <yave/device/Instance.h>
+#include <yave/device/Device.h>
+#include <yave/graphics/bindings/DescriptorSet.h>
+#include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/queues/submit.h>
+
+#include <y/core/Chrono.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+// submits and waits for an empty command buffer, so every set freed before it can be recycled
+static void advance_fences(DevicePtr dptr) {
+	CmdBufferRecorder recorder = dptr->create_disposable_cmd_buffer();
+	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+}
+
+y_test_func("DescriptorSetAllocator recycles and releases persistent sets") {
+	Instance instance(DebugParams::none());
+	Device device(instance);
+	DevicePtr dptr = &device;
+
+	const Texture& texture = *dptr->device_resources()[DeviceResources::BlackTexture];
+	const DescriptorSetAllocator& allocator = dptr->descriptor_set_allocator();
+
+	const usize set_count = 10000;
+	const usize rounds = 8;
+
+	for(usize r = 0; r != rounds; ++r) {
+		const auto before = allocator.stats();
+
+		core::Chrono chrono;
+		{
+			auto sets = core::vector_with_capacity<DescriptorSet>(set_count);
+			for(usize i = 0; i != set_count; ++i) {
+				sets.emplace_back(dptr, core::ArrayView<Binding>{Binding(texture)});
+			}
+		}
+		const auto time = chrono.reset();
+		advance_fences(dptr);
+
+		const auto after = allocator.stats();
+		const usize recycled = after.recycled - before.recycled;
+		const usize fresh = after.allocations - before.allocations - recycled;
+		log_msg(fmt("round %: % sets in %ms, % recycled, % fresh, % new pools", r, set_count, time.to_millis(), recycled, fresh, after.pools - before.pools));
+
+		// every set of the previous round was freed and its fence reached
+		y_test_assert(!r || !fresh);
+	}
+
+	// pools left empty are released after enough idle windows, each allocation after advance_fences closes one
+	for(usize i = 0; i != 32; ++i) {
+		DescriptorSet set(dptr, {Binding(texture)});
+		advance_fences(dptr);
+	}
+	const auto stats = allocator.stats();
+	log_msg(fmt("% pools created, % released", stats.pools, stats.released_pools));
+	y_test_assert(stats.released_pools);
+	y_test_assert(stats.pools - stats.released_pools <= 1);
+
+	for(usize i = 0; i != set_count; ++i) {
+		DescriptorSet set(dptr, {Binding(texture)}, DescriptorSet::Lifetime::Transient);
+	}
+	advance_fences(dptr);
+	log_msg(fmt("% transient sets: % pools, % resets", set_count, allocator.stats().transient_pools, allocator.stats().transient_resets));
+}
+
+}
@@ -0,0 +1,135 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <yave/scene/AABBTree.h>
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/core/Chrono.h>
+
+#include <random>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+struct CullingBounds {
+	AABB aabb;
+};
+
+static constexpr float world_size = 1000.0f;
+
+static AABB random_aabb(std::mt19937& rng) {
+	std::uniform_real_distribution<float> pos(0.0f, world_size);
+	std::uniform_real_distribution<float> size(0.5f, 5.0f);
+	const math::Vec3 min(pos(rng), pos(rng), pos(rng));
+	return AABB(min, min + math::Vec3(size(rng), size(rng), size(rng)));
+}
+
+// axis aligned box covering [begin, end] on every axis
+static Frustum box_frustum(float begin, float end) {
+	return Frustum(std::array<Plane, 6>{{
+			Plane(1.0f, 0.0f, 0.0f, -begin),
+			Plane(-1.0f, 0.0f, 0.0f, end),
+			Plane(0.0f, 1.0f, 0.0f, -begin),
+			Plane(0.0f, -1.0f, 0.0f, end),
+			Plane(0.0f, 0.0f, 1.0f, -begin),
+			Plane(0.0f, 0.0f, -1.0f, end)
+		}});
+}
+
+static usize count_visible(const AABBTree& tree, const Frustum& frustum) {
+	usize visible = 0;
+	tree.for_each_in_frustum(frustum, [&](u32) { ++visible; });
+	return visible;
+}
+
+static usize count_fat_visible(const AABBTree& tree, core::Span<AABBTree::NodeId> leaves, const Frustum& frustum) {
+	usize visible = 0;
+	for(AABBTree::NodeId leaf : leaves) {
+		visible += AABBTree::intersects(frustum, tree.fat_aabb(leaf));
+	}
+	return visible;
+}
+
+y_test_func("AABBTree culling benchmark") {
+	std::mt19937 rng(7);
+	const Frustum frustum = box_frustum(world_size * 0.25f, world_size * 0.75f);
+
+	for(usize count : {10000, 100000, 1000000}) {
+		ecs::EntityWorld world;
+		auto items = core::vector_with_capacity<AABBTree::Item>(count);
+		for(usize i = 0; i != count; ++i) {
+			const ecs::EntityId id = world.create_entity();
+			y_test_assert(id.index() == i);
+			const AABB aabb = random_aabb(rng);
+			world.create_component<CullingBounds>(id, CullingBounds{aabb});
+			items << AABBTree::Item{aabb, u32(id.index())};
+		}
+		world.flush();
+
+		core::Chrono chrono;
+		AABBTree tree;
+		const core::Vector<AABBTree::NodeId> leaves = tree.build(items);
+		const double build_ms = chrono.reset().to_millis();
+
+		const usize visible = count_visible(tree, frustum);
+		const double cull_ms = chrono.reset().to_millis();
+
+		usize linear_visible = 0;
+		for(const AABBTree::Item& item : items) {
+			linear_visible += AABBTree::intersects(frustum, item.aabb);
+		}
+		const double linear_ms = chrono.reset().to_millis();
+
+		// fat AABBs can only add false positives
+		y_test_assert(visible >= linear_visible);
+		y_test_assert(visible == count_fat_visible(tree, leaves, frustum));
+
+		// move 1% of the instances and only refit those, like SceneBVH::update does after a flush
+		const usize moved = count / 100;
+		for(usize i = 0; i != moved; ++i) {
+			const ecs::EntityId id = world.id_from_index(ecs::EntityIndex(rng() % count));
+			world.component<CullingBounds>(id)->aabb = random_aabb(rng);
+		}
+		world.flush();
+
+		const ecs::EntityWorld& const_world = world;
+		const ecs::ComponentMutations& mutations = const_world.flushed_mutations<CullingBounds>();
+		y_test_assert(!mutations.all);
+		y_test_assert(mutations.indexes.size() <= moved);
+
+		chrono.reset();
+		for(ecs::EntityIndex index : mutations.indexes) {
+			tree.update(leaves[index], const_world.component<CullingBounds>(const_world.id_from_index(index))->aabb);
+		}
+		const double refit_ms = chrono.reset().to_millis();
+
+		y_test_assert(tree.size() == count);
+		y_test_assert(count_visible(tree, frustum) == count_fat_visible(tree, leaves, frustum));
+
+		log_msg(fmt("Culling (% instances): build %ms, frustum query %ms (% visible), linear scan %ms, refit of % moved instances %ms",
+			count, build_ms, cull_ms, visible, linear_ms, mutations.indexes.size(), refit_ms));
+	}
+}
+
+}
@@ -35,9 +35,11 @@ EngineView::EngineView(ContextPtr cptr) :
 		Widget(ICON_FA_DESKTOP " Engine View"),
 		ContextLinked(cptr),
 		_ibl_data(std::make_shared<IBLData>(device())),
-		_scene_view(&context()->world()),
+		_scene_view(&context()->world(), &context()->scene_bvh()),
 		_gizmo(context(), &_scene_view) {
-	;
+
+	// don't stall the editor on first use of a material
+	_scene_view.set_async_pipeline_compilation(true);
 }
 
 EngineView::~EngineView() {
@@ -55,9 +57,12 @@ void EngineView::paint_ui(CmdBufferRecorder& recorder, const FrameToken& token)
 		EditorRenderer renderer = EditorRenderer::create(context(), graph, _scene_view, content_size(), _ibl_data);
 
 		FrameGraphImageId output_image = renderer.out;
+		graph.mark_as_output(output_image);
 		{
 			FrameGraphPassBuilder builder = graph.add_pass("ImGui texture pass");
 			builder.add_texture_input(output_image, PipelineStage::FragmentBit);
+			// hands the output to ImGui
+			builder.set_has_side_effects();
 			builder.set_render_func([&output, output_image](CmdBufferRecorder& rec, const FrameGraphPass* pass) {
 					auto out = std::make_unique<TextureView>(pass->resources()->image<ImageUsage::TextureBit>(output_image));
 					output = out.get();
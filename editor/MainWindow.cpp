@@ -59,28 +59,9 @@ void MainWindow::create_swapchain() {
 
 void MainWindow::present(CmdBufferRecorder& recorder, const FrameToken& token) {
 	y_profile();
-	{
-		RecordedCmdBuffer cmd_buffer(std::move(recorder));
-
-		vk::PipelineStageFlags pipe_stage_flags = vk::PipelineStageFlagBits::eBottomOfPipe;
-		Y_TODO(manual locking needs for queue presentation needs to go)
-		const auto& queue = device()->graphic_queue();
-		std::unique_lock lock(queue.lock());
-		auto graphic_queue = queue.vk_queue();
-		auto vk_buffer = cmd_buffer.vk_cmd_buffer();
-
-		graphic_queue.submit(vk::SubmitInfo()
-				.setWaitSemaphoreCount(1)
-				.setPWaitSemaphores(&token.image_aquired)
-				.setPWaitDstStageMask(&pipe_stage_flags)
-				.setCommandBufferCount(1)
-				.setPCommandBuffers(&vk_buffer)
-				.setSignalSemaphoreCount(1)
-				.setPSignalSemaphores(&token.render_finished),
-			cmd_buffer.vk_fence());
-
-		_swapchain->present(token, graphic_queue);
-	}
+	SubmitBatch batch;
+	batch.add(RecordedCmdBuffer(std::move(recorder)));
+	device()->graphic_queue().present(batch, *_swapchain, token);
 }
 
 }
@@ -53,6 +53,9 @@ void EditorContext::flush_reload() {
 	defer([this]() {
 		y_profile_zone("flush reload");
 		_thumb_cache.clear();
+		// reloaded meshes might have different bounds and geometry
+		_scene_bvh.clear();
+		_picking_manager.clear_cache();
 		_selection.flush_reload();
 		_ui.refresh_all();
 	});
@@ -79,6 +82,7 @@ void EditorContext::flush_deferred() {
 		_is_flushing_deferred = false;
 	}
 	_world.flush();
+	_scene_bvh.update(_world);
 }
 
 void EditorContext::log_message(std::string_view msg, Log type) {
@@ -111,6 +115,10 @@ ecs::EntityWorld& EditorContext::world() {
 	return _world;
 }
 
+const SceneBVH& EditorContext::scene_bvh() const {
+	return _scene_bvh;
+}
+
 const FileSystemModel* EditorContext::filesystem() const {
 	return _filesystem.get() ? _filesystem.get() : FileSystemModel::local_filesystem();
 }
@@ -179,6 +187,14 @@ void EditorContext::load_world() {
 		return;
 	}
 
+	// loads all the assets referenced by the world in parallel, the world is then deserialized from the start
+	AssetPrefetch prefetch = _loader.prefetch_dependencies<ecs::EntityWorld>(file.unwrap());
+	file = io2::File::open("world.yw");
+	if(!file) {
+		log_msg("Unable to open file.", Log::Error);
+		return;
+	}
+
 	ecs::EntityWorld world;
 	ReadableAssetArchive ar(file.unwrap(), _loader);
 	if(!world.deserialize(ar)) {
@@ -187,10 +203,13 @@ void EditorContext::load_world() {
 	}
 
 	_world = std::move(world);
+	_scene_bvh.clear();
+	_scene_bvh.update(_world);
 }
 
 void EditorContext::new_world() {
 	_world = ecs::EntityWorld();
+	_scene_bvh.clear();
 }
 
 }
@@ -23,6 +23,7 @@ SOFTWARE.
 #define EDITOR_CONTEXT_EDITORCONTEXT_H
 
 #include <yave/ecs/EntityWorld.h>
+#include <yave/scene/SceneBVH.h>
 
 #include "EditorState.h"
 #include "Settings.h"
@@ -60,6 +61,7 @@ class EditorContext : NonMovable, public DeviceLinked {
 		SceneView& default_scene_view();
 
 		ecs::EntityWorld& world();
+		const SceneBVH& scene_bvh() const;
 
 
 		const FileSystemModel* filesystem() const;
@@ -105,6 +107,7 @@ class EditorContext : NonMovable, public DeviceLinked {
 		Logs _logs;
 
 		ecs::EntityWorld _world;
+		SceneBVH _scene_bvh;
 };
 
 }
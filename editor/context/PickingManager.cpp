@@ -25,11 +25,76 @@ SOFTWARE.
 
 #include <yave/graphics/shaders/ComputeProgram.h>
 
+#include <yave/scene/SceneBVH.h>
+#include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/components/PointLightComponent.h>
+
 #include <editor/renderer/EditorEntityPass.h>
 #include <editor/renderer/ScenePickingPass.h>
 
 namespace editor {
 
+static math::Vec3 unproject(const math::Matrix4<>& inv_matrix, const math::Vec2& uv, float depth) {
+	math::Vec4 p = inv_matrix * math::Vec4(uv * 2.0f - 1.0f, depth, 1.0f);
+	return p.to<3>() / p.w();
+}
+
+// Möller–Trumbore, both faces are tested
+static bool intersect_triangle(const math::Vec3& origin, const math::Vec3& dir, const math::Vec3& v0, const math::Vec3& v1, const math::Vec3& v2, float& t) {
+	const math::Vec3 e1 = v1 - v0;
+	const math::Vec3 e2 = v2 - v0;
+	const math::Vec3 p = dir.cross(e2);
+	const float det = e1.dot(p);
+	if(std::abs(det) < 1e-12f) {
+		return false;
+	}
+
+	const float inv_det = 1.0f / det;
+	const math::Vec3 s = origin - v0;
+	const float u = s.dot(p) * inv_det;
+	if(u < 0.0f || u > 1.0f) {
+		return false;
+	}
+
+	const math::Vec3 q = s.cross(e1);
+	const float v = dir.dot(q) * inv_det;
+	if(v < 0.0f || u + v > 1.0f) {
+		return false;
+	}
+
+	t = e2.dot(q) * inv_det;
+	return t > 0.0f;
+}
+
+// origin and dir are in object space, dir is not normalized so that distances stay in world units
+// without geometry the mesh is picked using its bounding box
+static bool intersect_mesh(const StaticMesh& mesh, const PickingManager::MeshGeometry* geometry, const math::Vec3& origin, const math::Vec3& dir, float& dist) {
+	const math::Vec3 inv_dir(1.0f / dir.x(), 1.0f / dir.y(), 1.0f / dir.z());
+	float aabb_dist = 0.0f;
+	if(!AABBTree::intersects(origin, inv_dir, dist, mesh.aabb(), aabb_dist)) {
+		return false;
+	}
+
+	if(!geometry) {
+		dist = aabb_dist;
+		return true;
+	}
+
+	bool hit = false;
+	const auto& positions = geometry->positions;
+	for(const IndexedTriangle& tri : geometry->triangles) {
+		float t = 0.0f;
+		if(intersect_triangle(origin, dir, positions[tri[0]], positions[tri[1]], positions[tri[2]], t) && t < dist) {
+			dist = t;
+			hit = true;
+		}
+	}
+	return hit;
+}
+
+
+
 bool PickingManager::PickingData::hit() const {
 	return depth > 0.0f;
 }
@@ -40,6 +105,120 @@ PickingManager::PickingManager(ContextPtr ctx) :
 }
 
 PickingManager::PickingData PickingManager::pick_sync(const math::Vec2& uv, const math::Vec2ui& size) {
+	if(!context()->scene_view().has_bvh() || is_over_editor_entity(uv, size)) {
+		return pick_gpu(uv, size);
+	}
+	return pick_cpu(uv);
+}
+
+PickingManager::PickingData PickingManager::pick_cpu(const math::Vec2& uv) {
+	y_profile();
+
+	const SceneView& scene_view = context()->scene_view();
+	const ecs::EntityWorld& world = scene_view.world();
+	const Camera& camera = scene_view.camera();
+	const auto inv_matrix = camera.inverse_matrix();
+
+	// depth is reversed: the near plane is at 1
+	const math::Vec3 origin = unproject(inv_matrix, uv, 1.0f);
+	const math::Vec3 dir = (unproject(inv_matrix, uv, 0.5f) - origin).normalized();
+
+	const float max_dist = std::numeric_limits<float>::max();
+	float dist = max_dist;
+	u32 entity_index = 0;
+
+	scene_view.bvh().for_each_on_ray(origin, dir, max_dist, [&](ecs::EntityIndex index, float aabb_dist) {
+		if(aabb_dist >= dist) {
+			return;
+		}
+
+		const ecs::EntityId id = world.id_from_index(index);
+		const TransformableComponent* tr = world.component<TransformableComponent>(id);
+		const StaticMeshComponent* me = world.component<StaticMeshComponent>(id);
+		if(!tr || !me || !me->mesh()) {
+			return;
+		}
+
+		const math::Matrix4<> inv_transform = tr->transform().inverse();
+		const math::Vec3 obj_origin = (inv_transform * math::Vec4(origin, 1.0f)).to<3>();
+		const math::Vec3 obj_dir = (inv_transform * math::Vec4(dir, 0.0f)).to<3>();
+		if(intersect_mesh(*me->mesh(), mesh_geometry(me->mesh().id()), obj_origin, obj_dir, dist)) {
+			entity_index = index;
+		}
+	});
+
+	if(dist == max_dist) {
+		return PickingData{unproject(inv_matrix, uv, 0.0f), 0.0f, uv, entity_index};
+	}
+
+	const math::Vec3 world_pos = origin + dir * dist;
+	const math::Vec4 p = camera.viewproj_matrix() * math::Vec4(world_pos, 1.0f);
+	return PickingData{world_pos, p.z() / p.w(), uv, entity_index};
+}
+
+void PickingManager::clear_cache() {
+	_geometry.clear();
+}
+
+const PickingManager::MeshGeometry* PickingManager::mesh_geometry(AssetId id) {
+	if(const auto it = _geometry.find(id); it != _geometry.end()) {
+		return it->second.get();
+	}
+
+	std::unique_ptr<MeshGeometry>& geometry = _geometry[id];
+	if(id == AssetId::invalid_id()) {
+		return nullptr;
+	}
+
+	y_profile();
+
+	auto data = context()->asset_store().data(id);
+	if(!data) {
+		return nullptr;
+	}
+
+	MeshData mesh;
+	serde2::ReadableArchive ar(*data.unwrap());
+	if(!mesh.deserialize(ar)) {
+		log_msg("Unable to load mesh for picking.", Log::Error);
+		return nullptr;
+	}
+
+	geometry = std::make_unique<MeshGeometry>();
+	geometry->positions = core::vector_with_capacity<math::Vec3>(mesh.vertices().size());
+	for(const Vertex& v : mesh.vertices()) {
+		geometry->positions << v.position;
+	}
+	geometry->triangles = core::Vector<IndexedTriangle>(mesh.triangles().begin(), mesh.triangles().end());
+	return geometry.get();
+}
+
+bool PickingManager::is_over_editor_entity(const math::Vec2& uv, const math::Vec2ui& size) {
+	const SceneView& scene_view = context()->scene_view();
+	const ecs::EntityWorld& world = scene_view.world();
+	const math::Matrix4<>& view_proj = scene_view.camera().viewproj_matrix();
+
+	// billboards span billboard_size pixels of clip space, see imgui_billboard.geom
+	const math::Vec2 half_extent = math::Vec2(EditorEntityPass::billboard_size * 0.25f) / math::Vec2(size);
+
+	for(ecs::EntityIndex index : world.indexes<PointLightComponent>()) {
+		if(const TransformableComponent* tr = world.component<TransformableComponent>(world.id_from_index(index))) {
+			const math::Vec4 p = view_proj * math::Vec4(tr->position(), 1.0f);
+			if(p.w() <= 0.0f) {
+				continue;
+			}
+
+			const math::Vec2 center = (p.to<2>() / p.w()) * 0.5f + 0.5f;
+			const math::Vec2 delta = center - uv;
+			if(std::abs(delta.x()) <= half_extent.x() && std::abs(delta.y()) <= half_extent.y()) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+PickingManager::PickingData PickingManager::pick_gpu(const math::Vec2& uv, const math::Vec2ui& size) {
 	y_profile();
 
 	FrameGraph framegraph(context()->resource_pool());
@@ -55,6 +234,7 @@ PickingManager::PickingData PickingManager::pick_sync(const math::Vec2& uv, cons
 		builder.add_uniform_input(entity_pass.depth);
 		builder.add_uniform_input(entity_pass.id);
 		builder.add_descriptor_binding(Binding(_buffer));
+		builder.set_has_side_effects();
 
 		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
 			const auto& program = context()->resources()[EditorResources::PickingProgram];
@@ -70,10 +250,9 @@ PickingManager::PickingData PickingManager::pick_sync(const math::Vec2& uv, cons
 	float depth = read_back.depth;
 
 	auto inv_matrix = context()->scene_view().camera().inverse_matrix();
-	math::Vec4 p = inv_matrix * math::Vec4(uv * 2.0f - 1.0f, depth, 1.0f);
 
 	PickingData data{
-			p.to<3>() / p.w(),
+			unproject(inv_matrix, uv, depth),
 			depth,
 			uv,
 			read_back.id
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include <editor/editor.h>
 #include <yave/framegraph/FrameGraph.h>
+#include <yave/meshes/MeshData.h>
+
+#include <unordered_map>
 
 namespace editor {
 
@@ -34,7 +37,14 @@ class PickingManager : public ContextLinked {
 	};
 
 	using ReadBackBuffer = TypedBuffer<ReadBackData, BufferUsage::StorageBit, MemoryType::CpuVisible>;
+
 	public:
+		// object space copy of a mesh, StaticMesh only keeps its geometry on the GPU
+		struct MeshGeometry {
+			core::Vector<math::Vec3> positions;
+			core::Vector<IndexedTriangle> triangles;
+		};
+
 		struct PickingData {
 			math::Vec3 world_pos;
 			float depth;
@@ -46,10 +56,27 @@ class PickingManager : public ContextLinked {
 
 		PickingManager(ContextPtr ctx);
 
+		// uses the CPU path when possible and falls back to the GPU path for what the CPU can not see
 		PickingData pick_sync(const math::Vec2& uv, const math::Vec2ui& size = math::Vec2ui(512));
 
+		// ray-casts against the scene BVH and mesh triangles, does not see editor entities
+		PickingData pick_cpu(const math::Vec2& uv);
+
+		// renders the scene and reads back the picked pixel, stalls the graphic queue
+		PickingData pick_gpu(const math::Vec2& uv, const math::Vec2ui& size);
+
+		// drops the mesh geometry loaded for the CPU path, it is read again from the asset store when needed
+		void clear_cache();
+
 	private:
+		bool is_over_editor_entity(const math::Vec2& uv, const math::Vec2ui& size);
+
+		// null if the mesh data can not be read
+		const MeshGeometry* mesh_geometry(AssetId id);
+
 		ReadBackBuffer _buffer;
+
+		std::unordered_map<AssetId, std::unique_ptr<MeshGeometry>> _geometry;
 };
 
 }
@@ -186,6 +186,7 @@ std::unique_ptr<ThumbmailCache::Thumbmail> ThumbmailCache::render_thumbmail(CmdB
 			builder.add_uniform_input(output_image);
 			builder.add_uniform_input(renderer.gbuffer.depth);
 			builder.add_uniform_input(StorageView(thumbmail->image));
+			builder.set_has_side_effects();
 			builder.set_render_func([=](CmdBufferRecorder& rec, const FrameGraphPass* self) {
 					rec.dispatch_size(context()->resources()[EditorResources::DepthAlphaProgram], math::Vec2ui(_size), {self->descriptor_sets()[0]});
 				});
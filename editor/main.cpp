@@ -29,6 +29,8 @@ SOFTWARE.
 
 #include <yave/graphics/swapchain/Swapchain.h>
 
+#include <y/io2/File.h>
+
 using namespace editor;
 
 
@@ -87,6 +89,22 @@ static Instance create_instance() {
 }
 
 
+static void load_pipeline_cache(Device& device) {
+	PipelineCache& cache = device.pipeline_cache();
+	if(auto file = io2::File::open(cache.file_name())) {
+		cache.load(file.unwrap());
+	} else {
+		log_msg("No pipeline cache found.");
+	}
+}
+
+static void save_pipeline_cache(Device& device) {
+	PipelineCache& cache = device.pipeline_cache();
+	auto file = io2::File::create(cache.file_name());
+	if(!file || !cache.save(file.unwrap())) {
+		log_msg("Unable to write pipeline cache.", Log::Error);
+	}
+}
 
 
 
@@ -98,6 +116,8 @@ int main(int argc, char** argv) {
 	Instance instance = create_instance();
 
 	Device device(instance);
+	load_pipeline_cache(device);
+
 	EditorContext ctx(&device);
 	context = &ctx;
 
@@ -105,6 +125,7 @@ int main(int argc, char** argv) {
 	window.set_event_handler(std::make_unique<MainEventHandler>());
 	window.show();
 
+	bool first_frame = true;
 	for(;;) {
 		if(!window.update()) {
 			if(ctx.ui().confirm("Quit ?")) {
@@ -122,11 +143,19 @@ int main(int argc, char** argv) {
 			ctx.ui().paint(recorder, frame);
 
 			window.present(recorder, frame);
+
+			if(first_frame) {
+				first_frame = false;
+				const auto stats = device.pipeline_cache().stats();
+				log_msg(fmt("First frame presented after %ms (% pipelines created in %ms)", core::Chrono::program().to_millis(), stats.pipelines, stats.pipeline_time_ms));
+			}
 		}
 
 		ctx.flush_deferred();
 	}
 
+	save_pipeline_cache(device);
+
 	return 0;
 }
 
@@ -81,7 +81,7 @@ static void render_editor_entities(ContextPtr ctx, bool picking,
 		auto mapping = pass->resources()->mapped_buffer(pass_buffer);
 		mapping->view_proj = scene_view.camera().viewproj_matrix();
 		mapping->viewport_size = pass->framebuffer().size();
-		mapping->size = 64.0f;
+		mapping->size = EditorEntityPass::billboard_size;
 
 	}
 
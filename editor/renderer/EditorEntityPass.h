@@ -30,6 +30,7 @@ namespace editor {
 
 struct EditorEntityPass {
 	static constexpr usize max_batch_size = 128 * 1024;
+	static constexpr float billboard_size = 64.0f;
 
 	FrameGraphImageId depth;
 	FrameGraphImageId color;
@@ -28,7 +28,7 @@ namespace editor {
 
 struct EditorRendererSettings {
 	bool enable_editor_entities = true;
-	float billboard_size = 64.0f;
+	float billboard_size = EditorEntityPass::billboard_size;
 };
 
 
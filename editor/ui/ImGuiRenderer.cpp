@@ -79,7 +79,7 @@ const Texture& ImGuiRenderer::font_texture() const {
 
 DescriptorSet ImGuiRenderer::create_descriptor_set(const void* data) {
 	auto tex = data ? reinterpret_cast<const TextureView*>(data) : &_font_view;
-	return DescriptorSet(device(), {Binding(*tex), Binding(_uniform_buffer)});
+	return DescriptorSet(device(), {Binding(*tex), Binding(_uniform_buffer)}, DescriptorSet::Lifetime::Transient);
 }
 
 void ImGuiRenderer::setup_state(RenderPassRecorder& recorder, const FrameToken& token, const void* tex) {
@@ -23,6 +23,7 @@ SOFTWARE.
 
 #include <editor/context/EditorContext.h>
 #include <yave/device/Device.h>
+#include <yave/framegraph/FrameGraphResourcePool.h>
 
 #include <imgui/yave_imgui.h>
 
@@ -60,7 +61,7 @@ void MemoryInfo::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 			total_allocated += heap->size();
 
 			ImGui::ProgressBar(used / float(heap->size()), ImVec2(0, 0), fmt("%KB / %KB", to_kb(used), to_kb(heap->size())).data());
-			ImGui::Text("Free blocks: %u", unsigned(heap->free_blocks()));
+			ImGui::Text("Free blocks: %u, largest: %uKB, fragmentation: %.1f%%", unsigned(heap->free_blocks()), unsigned(to_kb(heap->largest_free_block())), heap->fragmentation() * 100.0f);
 			ImGui::Spacing();
 		}
 		ImGui::Unindent();
@@ -85,6 +86,30 @@ void MemoryInfo::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 		ImGui::SetNextItemWidth(-1);
 		ImGui::ProgressBar(total_used / float(total_allocated), ImVec2(0, 0), fmt("%MB / %MB", usize(to_mb(total_used)), usize(to_mb(total_allocated))).data());
 
+		ImGui::Spacing();
+		ImGui::Separator();
+		const FrameGraphResourcePool* pool = context()->resource_pool().get();
+		ImGui::Text("Transient memory: %.1fMB", to_mb(pool->aliased_memory_size()));
+		ImGui::Text("Transient memory without aliasing: %.1fMB", to_mb(pool->aliased_resources_size()));
+
+		const auto stats = pool->pool_stats();
+		ImGui::Text("Placed resources: %u", unsigned(stats.placed_resources));
+		ImGui::Text("Pooled buffers: %.1fMB (%.1fMB released)", to_mb(stats.resident_bytes), to_mb(stats.released_bytes));
+		ImGui::Text("Pool hits: %u, misses: %u, evictions: %u", unsigned(stats.hits), unsigned(stats.misses), unsigned(stats.evictions));
+
+		ImGui::Spacing();
+		ImGui::Separator();
+		const auto ds_stats = device()->descriptor_set_allocator().stats();
+		ImGui::Text("Descriptor sets: %u allocated (%u recycled), %u released, %u pools (%u released)", unsigned(ds_stats.allocations), unsigned(ds_stats.recycled), unsigned(ds_stats.releases), unsigned(ds_stats.pools), unsigned(ds_stats.released_pools));
+		ImGui::Text("Transient descriptor sets: %u allocated, %u pools, %u resets", unsigned(ds_stats.transient_allocations), unsigned(ds_stats.transient_pools), unsigned(ds_stats.transient_resets));
+
+		ImGui::Spacing();
+		ImGui::Separator();
+		const auto staging_stats = device()->staging_ring().stats();
+		ImGui::Text("Staging ring: %.1fMB / %.1fMB", to_mb(staging_stats.used), to_mb(staging_stats.capacity));
+		ImGui::Text("Uploads: %u (%.1fMB), %u spilled, %u batches", unsigned(staging_stats.uploads), to_mb(staging_stats.uploaded_bytes), unsigned(staging_stats.spills), unsigned(staging_stats.batches));
+		ImGui::Text("Transfer queue: %s, %u transfer batches", staging_stats.async_transfers ? "async" : "graphic", unsigned(staging_stats.transfer_batches));
+
 		ImGui::Spacing();
 		ImGui::Separator();
 		ImGui::Text("Max usage: %.1fMB", to_mb(_max_usage));
@@ -72,6 +72,8 @@ void MeshImporter::paint_ui(CmdBufferRecorder& recorder, const FrameToken& token
 		ImGui::Checkbox("Import materials", &import_materials);
 		ImGui::Separator();
 		ImGui::Checkbox("Import objects and create world", &import_objects);
+		ImGui::Separator();
+		ImGui::Checkbox("Compress meshes and images", &_compress);
 
 		_flags = (import_meshes ? SceneImportFlags::ImportMeshes : SceneImportFlags::None) |
 				 (import_anims ? SceneImportFlags::ImportAnims : SceneImportFlags::None) |
@@ -203,6 +205,13 @@ void MeshImporter::import(import::SceneData scene) {
 
 
 
+	for(auto& mesh : scene.meshes) {
+		mesh.obj().set_compressed(_compress);
+	}
+	for(auto& image : scene.images) {
+		image.obj().set_compressed(_compress);
+	}
+
 	{
 		bool separate_folders = !scene.meshes.is_empty() + !scene.animations.is_empty() + !scene.images.is_empty();
 		core::String mesh_import_path = separate_folders ? "meshes" : "";
@@ -57,6 +57,8 @@ class MeshImporter final : public Widget, public ContextLinked {
 
 		import::SceneImportFlags _flags = import::SceneImportFlags::ImportAll;
 
+		bool _compress = true;
+
 		usize _forward_axis = 0;
 		usize _up_axis = 4;
 
@@ -22,7 +22,9 @@ SOFTWARE.
 
 #include "PerformanceMetrics.h"
 
+#include <editor/context/EditorContext.h>
 #include <yave/device/Device.h>
+#include <yave/framegraph/FrameGraphResourcePool.h>
 
 #include <imgui/yave_imgui.h>
 
@@ -43,6 +45,27 @@ void PerformanceMetrics::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 	ImGui::PlotLines("###graph", _frames.begin(), _frames.size(), _current_index, "", 0.0f, 50.0f, ImVec2(ImGui::GetWindowContentRegionWidth(), 80));
 
 
+	const SceneRenderStats stats = context()->scene_view().stats();
+	ImGui::Text("%u meshes visible, %u culled", unsigned(stats.visible_meshes), unsigned(stats.culled_meshes));
+	ImGui::Text("%u draw calls", unsigned(stats.draw_calls));
+	if(stats.pending_pipelines) {
+		ImGui::Text("%u draws waiting for pipeline compilation", unsigned(stats.pending_pipelines));
+	}
+	if(stats.pending_uploads) {
+		ImGui::Text("%u meshes waiting for their data to be uploaded", unsigned(stats.pending_uploads));
+	}
+	if(stats.dropped_meshes) {
+		ImGui::Text("%u meshes dropped: too many visible meshes", unsigned(stats.dropped_meshes));
+	}
+
+	const FrameGraphTimings& timings = context()->resource_pool()->pass_timings();
+	if(ImGui::CollapsingHeader("GPU", ImGuiTreeNodeFlags_DefaultOpen)) {
+		ImGui::Text("GPU time: %.2fms", timings.total_average().to_millis());
+		for(const auto& pass : timings.pass_timings()) {
+			ImGui::Text("%s: %.3fms (min: %.3fms, max: %.3fms)", pass.name.data(), pass.average.to_millis(), pass.min.to_millis(), pass.max.to_millis());
+		}
+	}
+
 	ImGui::Text("%.3u resources waiting deletion", unsigned(device()->lifetime_manager().pending_deletions()));
 	ImGui::Text("%.3u active command buffers", unsigned(device()->lifetime_manager().active_cmd_buffers()));
 }
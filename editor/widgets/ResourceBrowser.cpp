@@ -26,6 +26,7 @@ SOFTWARE.
 #include <editor/utils/assets.h>
 #include <editor/context/EditorContext.h>
 #include <yave/assets/FolderAssetStore.h>
+#include <yave/assets/PackedAssetStore.h>
 
 #include <y/io2/Buffer.h>
 
@@ -241,6 +242,11 @@ void ResourceBrowser::paint_context_menu() {
 				store->clean_index();
 				refresh();
 			}
+			if(ImGui::Selectable("Pack store")) {
+				if(!PackedAssetStore::pack(*store, "store.pack", true)) {
+					log_msg("Unable to pack store.", Log::Error);
+				}
+			}
 		}
 
 		ImGui::EndPopup();
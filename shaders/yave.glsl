@@ -7,7 +7,6 @@ const float epsilon = 0.001;
 const uint max_uint = uint(0xFFFFFFF);
 
 const uint max_bones = 256;
-const uint max_tile_lights = 256;
 
 
 // -------------------------------- TYPES --------------------------------
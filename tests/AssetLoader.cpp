@@ -0,0 +1,412 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/test.h>
+#include <yave/assets/AssetLoader.h>
+#include <yave/assets/FolderAssetStore.h>
+
+#include <y/serde2/compressed.h>
+
+#include <filesystem>
+#include <thread>
+#include <array>
+
+#ifndef YAVE_NO_STDFS
+
+namespace yave {
+namespace {
+
+static std::atomic<usize> created_assets = 0;
+
+struct TestAssetData {
+	core::Vector<u32> values;
+
+	y_serde2(values)
+};
+
+struct TestAsset {
+	TestAsset(DevicePtr, TestAssetData&& data) {
+		++created_assets;
+		for(u32 v : data.values) {
+			checksum += v;
+		}
+	}
+
+	u64 checksum = 0;
+};
+
+static std::atomic<usize> dependency_scans = 0;
+
+struct TestParentData {
+	static constexpr bool has_asset_dependencies = true;
+
+	core::Vector<AssetPtr<TestAsset>> children;
+
+	serde2::Result deserialize(ReadableAssetArchive& arc) noexcept {
+		if(arc.prefetch()) {
+			++dependency_scans;
+		}
+		return arc(children);
+	}
+};
+
+struct TestParent {
+	TestParent(DevicePtr, TestParentData&& data) : children(std::move(data.children)) {
+	}
+
+	core::Vector<AssetPtr<TestAsset>> children;
+};
+
+struct TestCompressedData {
+	core::Span<u32> values;
+	core::Vector<u32> storage;
+
+	y_serialize2(u64(values.size()), serde2::compressed_array(true, values.size(), values.data()))
+	y_deserialize2(serde2::compressed_array_view(values, storage))
+};
+
+struct TestCompressed {
+	TestCompressed(DevicePtr, TestCompressedData&& data) {
+		for(u32 v : data.values) {
+			checksum += v;
+		}
+	}
+
+	u64 checksum = 0;
+};
+
+struct TestCompressedParentData {
+	static constexpr bool has_asset_dependencies = true;
+
+	AssetPtr<TestCompressed> child;
+
+	y_serde2(child)
+};
+
+struct TestCompressedParent {
+	TestCompressedParent(DevicePtr, TestCompressedParentData&& data) : child(std::move(data.child)) {
+	}
+
+	AssetPtr<TestCompressed> child;
+};
+
+}
+
+YAVE_DECLARE_ASSET_TRAITS(TestAsset, TestAssetData, AssetType::Unknown);
+YAVE_DECLARE_ASSET_TRAITS(TestParent, TestParentData, AssetType::Unknown);
+YAVE_DECLARE_ASSET_TRAITS(TestCompressed, TestCompressedData, AssetType::Unknown);
+YAVE_DECLARE_ASSET_TRAITS(TestCompressedParent, TestCompressedParentData, AssetType::Unknown);
+
+}
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static u64 expected_checksum(usize index, usize size) {
+	return u64(index) * size + (u64(size) * (size - 1)) / 2;
+}
+
+static core::String store_path(std::string_view name) {
+	return core::String((std::filesystem::temp_directory_path() / std::string(name)).string());
+}
+
+static core::Vector<AssetId> fill_store(AssetStore& store, usize count, usize size) {
+	core::Vector<AssetId> ids;
+	for(usize i = 0; i != count; ++i) {
+		TestAssetData data;
+		for(usize j = 0; j != size; ++j) {
+			data.values << u32(i + j);
+		}
+
+		io2::Buffer buffer;
+		serde2::WritableArchive arc(buffer);
+		arc(data).unwrap();
+		ids << store.import(buffer, fmt("asset_%", i)).unwrap();
+	}
+	return ids;
+}
+
+y_test_func("AssetLoader de-duplicates concurrent loads") {
+	const core::String path = store_path("yave_asset_loader_test");
+	std::filesystem::remove_all(path.data());
+	std::filesystem::create_directories(path.data());
+	{
+		auto store = std::make_shared<FolderAssetStore>(path);
+		const auto ids = fill_store(*store, 4, 256);
+
+		AssetLoader loader(store);
+		created_assets = 0;
+
+		auto a = loader.load_async<TestAsset>(ids[0]);
+		auto b = loader.load_async<TestAsset>(ids[0]);
+		auto c = loader.load_async<TestAsset>(ids[1]);
+
+		core::Vector<std::thread> threads;
+		std::atomic<usize> matches = 0;
+		for(usize i = 0; i != 8; ++i) {
+			threads.emplace_back([&] {
+				auto asset = loader.load<TestAsset>(ids[0]);
+				if(asset && asset.unwrap() == a.get().unwrap()) {
+					++matches;
+				}
+			});
+		}
+		for(auto& thread : threads) {
+			thread.join();
+		}
+
+		y_test_assert(matches == 8);
+		y_test_assert(a.get().unwrap() == b.get().unwrap());
+		y_test_assert(c.get().unwrap()->checksum == expected_checksum(1, 256));
+		y_test_assert(created_assets == 2);
+
+		y_test_assert(loader.load_async<TestAsset>(AssetId::invalid_id()).get().error() == AssetLoader::ErrorType::InvalidID);
+	}
+	std::filesystem::remove_all(path.data());
+}
+
+y_test_func("AssetLoader prefetches dependencies") {
+	const core::String path = store_path("yave_asset_prefetch_test");
+	std::filesystem::remove_all(path.data());
+	std::filesystem::create_directories(path.data());
+	{
+		AssetId parent_id;
+		core::Vector<AssetId> ids;
+		{
+			auto store = std::make_shared<FolderAssetStore>(path);
+			ids = fill_store(*store, 16, 256);
+
+			core::Vector<AssetId> children = ids;
+			children << ids[0];
+
+			io2::Buffer buffer;
+			serde2::WritableArchive arc(buffer);
+			arc(children).unwrap();
+			parent_id = store->import(buffer, "parent").unwrap();
+
+			AssetLoader loader(store);
+			dependency_scans = 0;
+			created_assets = 0;
+
+			auto parent = loader.load<TestParent>(parent_id);
+			y_test_assert(parent);
+			y_test_assert(parent.unwrap()->children.size() == ids.size() + 1);
+			for(usize i = 0; i != ids.size(); ++i) {
+				y_test_assert(parent.unwrap()->children[i]->checksum == expected_checksum(i, 256));
+			}
+			y_test_assert(dependency_scans == 1);
+			y_test_assert(created_assets == ids.size());
+
+			auto deps = store->dependencies(parent_id);
+			y_test_assert(deps && deps.unwrap().size() == ids.size());
+			y_test_assert(deps.unwrap()[0].type == "TestAsset");
+		}
+
+		{
+			// the dependencies are persisted with the store
+			auto store = std::make_shared<FolderAssetStore>(path);
+			y_test_assert(store->dependencies(parent_id));
+
+			AssetLoader loader(store);
+			dependency_scans = 0;
+
+			y_test_assert(loader.load<TestAsset>(ids[0]));
+			auto parent = loader.load<TestParent>(parent_id);
+			y_test_assert(parent && parent.unwrap()->children.size() == ids.size() + 1);
+			y_test_assert(dependency_scans == 0);
+		}
+
+		{
+			// rewriting an asset invalidates its dependencies
+			auto store = std::make_shared<FolderAssetStore>(path);
+			y_test_assert(store->dependencies(parent_id));
+
+			core::Vector<AssetId> children;
+			children << ids[1] << ids[2];
+
+			io2::Buffer buffer;
+			serde2::WritableArchive arc(buffer);
+			arc(children).unwrap();
+			y_test_assert(store->write(parent_id, buffer));
+			y_test_assert(!store->dependencies(parent_id));
+
+			AssetLoader loader(store);
+			auto parent = loader.load<TestParent>(parent_id);
+			y_test_assert(parent && parent.unwrap()->children.size() == 2);
+
+			auto deps = store->dependencies(parent_id);
+			y_test_assert(deps && deps.unwrap().size() == 2);
+		}
+
+		{
+			// and the rebuilt ones are persisted
+			auto store = std::make_shared<FolderAssetStore>(path);
+			auto deps = store->dependencies(parent_id);
+			y_test_assert(deps && deps.unwrap().size() == 2);
+		}
+	}
+	std::filesystem::remove_all(path.data());
+}
+
+y_test_func("FolderAssetStore keeps mapped data valid across writes") {
+	const core::String path = store_path("yave_asset_store_write_test");
+	std::filesystem::remove_all(path.data());
+	std::filesystem::create_directories(path.data());
+	{
+		auto store = std::make_shared<FolderAssetStore>(path);
+		const auto ids = fill_store(*store, 2, 64 * 1024);
+
+		core::Vector<u8> expected;
+		store->data(ids[0]).unwrap()->read_all(expected).unwrap();
+
+		// mapped before the write, read after
+		io2::ReaderPtr old_data = std::move(store->data(ids[0]).unwrap());
+
+		core::Vector<u8> other;
+		store->data(ids[1]).unwrap()->read_all(other).unwrap();
+		const core::Vector<u8> smaller(other.begin(), other.begin() + other.size() / 2);
+		{
+			io2::Buffer buffer{core::Vector<u8>(smaller)};
+			y_test_assert(store->write(ids[0], buffer));
+		}
+
+		core::Vector<u8> old_bytes;
+		y_test_assert(old_data->read_all(old_bytes));
+		y_test_assert(old_bytes.size() == expected.size());
+		y_test_assert(std::equal(old_bytes.begin(), old_bytes.end(), expected.begin()));
+
+		core::Vector<u8> new_bytes;
+		store->data(ids[0]).unwrap()->read_all(new_bytes).unwrap();
+		y_test_assert(new_bytes.size() == smaller.size());
+		y_test_assert(std::equal(new_bytes.begin(), new_bytes.end(), smaller.begin()));
+
+		// no temporary file is left behind
+		usize files = 0;
+		for(const auto& entry : std::filesystem::directory_iterator(path.data())) {
+			files += entry.is_regular_file() && entry.path().filename().string()[0] != '.';
+		}
+		y_test_assert(files == ids.size());
+	}
+	std::filesystem::remove_all(path.data());
+}
+
+y_test_func("AssetLoader loads shared compressed dependencies asynchronously") {
+	const core::String path = store_path("yave_asset_shared_dependency_test");
+	std::filesystem::remove_all(path.data());
+	std::filesystem::create_directories(path.data());
+	{
+		auto store = std::make_shared<FolderAssetStore>(path);
+
+		// large enough to span several compressed blocks, which are decompressed in parallel
+		core::Vector<u32> values;
+		for(usize i = 0; i != 1024 * 1024; ++i) {
+			values << u32(i);
+		}
+
+		AssetId child_id;
+		{
+			TestCompressedData data;
+			data.values = values;
+			io2::Buffer buffer;
+			serde2::WritableArchive arc(buffer);
+			arc(data).unwrap();
+			child_id = store->import(buffer, "child").unwrap();
+		}
+
+		core::Vector<AssetId> parent_ids;
+		for(usize i = 0; i != 8; ++i) {
+			io2::Buffer buffer;
+			serde2::WritableArchive arc(buffer);
+			arc(child_id).unwrap();
+			parent_ids << store->import(buffer, fmt("parent_%", i)).unwrap();
+		}
+
+		for(usize k = 0; k != 4; ++k) {
+			AssetLoader loader(store);
+			core::Vector<AssetLoader::AsyncResult<TestCompressedParent>> results;
+			for(AssetId id : parent_ids) {
+				results << loader.load_async<TestCompressedParent>(id);
+			}
+
+			const TestCompressed* child = nullptr;
+			for(auto& result : results) {
+				auto parent = result.get();
+				y_test_assert(parent);
+				y_test_assert(parent.unwrap()->child->checksum == expected_checksum(0, values.size()));
+				y_test_assert(!child || child == &*parent.unwrap()->child);
+				child = &*parent.unwrap()->child;
+			}
+		}
+	}
+	std::filesystem::remove_all(path.data());
+}
+
+y_test_func("AssetLoader loads assets concurrently") {
+	const core::String path = store_path("yave_asset_loader_concurrent_test");
+	std::filesystem::remove_all(path.data());
+	std::filesystem::create_directories(path.data());
+	{
+		auto store = std::make_shared<FolderAssetStore>(path);
+		const auto ids = fill_store(*store, 16, 1024);
+
+		AssetLoader loader(store);
+		created_assets = 0;
+
+		// every thread loads every asset, half of them through load_async
+		std::array<core::Vector<AssetPtr<TestAsset>>, 4> loaded;
+		core::Vector<std::thread> threads;
+		for(usize t = 0; t != loaded.size(); ++t) {
+			threads.emplace_back([&, t] {
+				core::Vector<std::pair<usize, AssetLoader::AsyncResult<TestAsset>>> results;
+				loaded[t] = core::Vector<AssetPtr<TestAsset>>(ids.size(), AssetPtr<TestAsset>());
+				for(usize i = 0; i != ids.size(); ++i) {
+					if((i + t) % 2) {
+						results.emplace_back(i, loader.load_async<TestAsset>(ids[i]));
+					} else if(auto asset = loader.load<TestAsset>(ids[i])) {
+						loaded[t][i] = asset.unwrap();
+					}
+				}
+				for(auto& [i, result] : results) {
+					if(auto asset = result.get()) {
+						loaded[t][i] = asset.unwrap();
+					}
+				}
+			});
+		}
+		for(auto& thread : threads) {
+			thread.join();
+		}
+
+		for(usize i = 0; i != ids.size(); ++i) {
+			y_test_assert(loaded[0][i] && loaded[0][i]->checksum == expected_checksum(i, 1024));
+			for(usize t = 1; t != loaded.size(); ++t) {
+				y_test_assert(loaded[t][i] == loaded[0][i]);
+			}
+		}
+		y_test_assert(created_assets == ids.size());
+	}
+	std::filesystem::remove_all(path.data());
+}
+
+}
+
+#endif // YAVE_NO_STDFS
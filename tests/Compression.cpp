@@ -0,0 +1,184 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/test.h>
+#include <yave/meshes/MeshData.h>
+
+#include <y/io2/Buffer.h>
+#include <y/io2/CompressedWriter.h>
+#include <y/io2/DecompressedReader.h>
+#include <y/core/Chrono.h>
+
+#include <random>
+
+namespace yave {
+MeshData sphere_mesh_data();
+}
+
+namespace {
+using namespace y;
+using namespace yave;
+
+// heightfield shaped like the terrains and props we import, with smooth normals and tangents
+static MeshData grid_mesh_data(usize size) {
+	core::Vector<Vertex> vertices;
+	core::Vector<IndexedTriangle> triangles;
+	for(usize y = 0; y != size; ++y) {
+		for(usize x = 0; x != size; ++x) {
+			const float u = float(x) / (size - 1);
+			const float v = float(y) / (size - 1);
+			const float h = std::sin(u * 12.0f) * std::cos(v * 9.0f) * 0.1f;
+			const math::Vec3 normal = math::Vec3(-std::cos(u * 12.0f) * 1.2f, std::sin(v * 9.0f) * 0.9f, 1.0f).normalized();
+			vertices << Vertex{{u, v, h}, normal, math::Vec3(1.0f, 0.0f, normal.x()).normalized(), {u, v}};
+		}
+	}
+	for(usize y = 0; y + 1 != size; ++y) {
+		for(usize x = 0; x + 1 != size; ++x) {
+			const u32 i = u32(y * size + x);
+			triangles << IndexedTriangle{{i, i + 1, i + u32(size)}};
+			triangles << IndexedTriangle{{i + 1, i + u32(size) + 1, i + u32(size)}};
+		}
+	}
+	return MeshData(std::move(vertices), std::move(triangles));
+}
+
+// RGBA8 image with smooth gradients, flat areas and sensor like noise
+static core::Vector<u8> texture_data(usize size) {
+	std::mt19937 gen(17);
+	core::Vector<u8> data;
+	for(usize y = 0; y != size; ++y) {
+		for(usize x = 0; x != size; ++x) {
+			const bool flat = (x / 128 + y / 128) % 3 == 0;
+			const u8 noise = flat ? 0 : u8(gen() % 4);
+			data << u8(x * 255 / size + noise) << u8(y * 255 / size + noise) << u8(flat ? 128 : (x ^ y) & 0xFF) << u8(255);
+		}
+	}
+	return data;
+}
+
+template<typename T>
+static core::Vector<u8> serialized(const T& t) {
+	io2::Buffer buffer;
+	WritableAssetArchive arc(buffer);
+	arc(t).unwrap();
+	core::Vector<u8> bytes;
+	buffer.read_all(bytes).unwrap();
+	return bytes;
+}
+
+static bool bench(std::string_view name, const u8* data, usize size) {
+	io2::Buffer buffer;
+	core::Chrono chrono;
+	{
+		io2::CompressedWriter writer(buffer);
+		writer.write(data, size).unwrap();
+		writer.finish().unwrap();
+	}
+	const double compress_secs = chrono.reset().to_secs();
+	const usize compressed = buffer.remaining();
+
+	chrono.reset();
+	core::Vector<u8> decompressed(size, u8(0));
+	{
+		io2::DecompressedReader reader(buffer);
+		reader.read(decompressed.data(), size).unwrap();
+	}
+	const double decompress_secs = chrono.reset().to_secs();
+
+	const double mb = size / (1024.0 * 1024.0);
+	log_msg(fmt("Compression (%): %MB, ratio %, compression %MB/s, decompression %MB/s",
+		name, mb, double(compressed) / size, mb / compress_secs, mb / decompress_secs));
+
+	return std::equal(data, data + size, decompressed.begin(), decompressed.end());
+}
+
+y_test_func("Compression mesh round trip") {
+	const MeshData mesh = grid_mesh_data(64);
+	const core::Vector<u8> bytes = serialized(mesh);
+
+	io2::Buffer buffer{core::Vector<u8>(bytes)};
+	serde2::ReadableArchive arc(buffer);
+	MeshData loaded;
+	arc(loaded).unwrap();
+
+	y_test_assert(buffer.at_end());
+	y_test_assert(loaded.vertices().size() == mesh.vertices().size());
+	y_test_assert(loaded.triangles().size() == mesh.triangles().size());
+	y_test_assert(std::equal(mesh.triangles().begin(), mesh.triangles().end(), loaded.triangles().begin()));
+	y_test_assert(!std::memcmp(mesh.vertices().data(), loaded.vertices().data(), mesh.vertices().size() * sizeof(Vertex)));
+	y_test_assert(bytes.size() < mesh.vertices().size() * sizeof(Vertex) + mesh.triangles().size() * sizeof(IndexedTriangle));
+}
+
+y_test_func("Compression mesh options and legacy version") {
+	MeshData mesh = grid_mesh_data(64);
+	const usize raw_size = mesh.vertices().size() * sizeof(Vertex) + mesh.triangles().size() * sizeof(IndexedTriangle);
+
+	auto same_geometry = [&](const MeshData& loaded) {
+		return loaded.vertices().size() == mesh.vertices().size() &&
+			   std::equal(mesh.triangles().begin(), mesh.triangles().end(), loaded.triangles().begin(), loaded.triangles().end()) &&
+			   !std::memcmp(mesh.vertices().data(), loaded.vertices().data(), mesh.vertices().size() * sizeof(Vertex));
+	};
+
+	{
+		mesh.set_compressed(false);
+		io2::Buffer buffer{serialized(mesh)};
+		y_test_assert(buffer.remaining() > raw_size);
+
+		serde2::ReadableArchive arc(buffer);
+		MeshData loaded;
+		y_test_assert(arc(loaded));
+		y_test_assert(same_geometry(loaded));
+	}
+
+	{
+		// version 7, written before compression was added
+		io2::Buffer buffer;
+		serde2::WritableArchive out(buffer);
+		out(fs::magic_number, AssetType::Mesh, u32(7), mesh.aabb(),
+			u64(mesh.vertices().size()), serde2::array(mesh.vertices().size(), mesh.vertices().data()),
+			u64(mesh.triangles().size()), serde2::array(mesh.triangles().size(), mesh.triangles().data()),
+			u32(0)).unwrap();
+
+		serde2::ReadableArchive arc(buffer);
+		MeshData loaded;
+		y_test_assert(arc(loaded));
+		y_test_assert(buffer.at_end());
+		y_test_assert(same_geometry(loaded));
+	}
+}
+
+y_test_func("Compression benchmark") {
+	{
+		const MeshData sphere = sphere_mesh_data();
+		y_test_assert(bench("sphere vertices", reinterpret_cast<const u8*>(sphere.vertices().data()), sphere.vertices().size() * sizeof(Vertex)));
+	}
+	{
+		const MeshData grid = grid_mesh_data(512);
+		y_test_assert(bench("mesh vertices", reinterpret_cast<const u8*>(grid.vertices().data()), grid.vertices().size() * sizeof(Vertex)));
+		y_test_assert(bench("mesh triangles", reinterpret_cast<const u8*>(grid.triangles().data()), grid.triangles().size() * sizeof(IndexedTriangle)));
+	}
+	{
+		const core::Vector<u8> texture = texture_data(2048);
+		y_test_assert(bench("texture", texture.data(), texture.size()));
+	}
+}
+
+}
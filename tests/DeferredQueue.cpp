@@ -0,0 +1,137 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/test.h>
+#include <yave/device/DeferredQueue.h>
+
+#include <thread>
+#include <memory>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+// stands for a buffer: counts how many times it has been destroyed
+class FakeBuffer : NonCopyable {
+	public:
+		FakeBuffer(std::atomic<u32>* destroyed) : _destroyed(destroyed) {
+		}
+
+		FakeBuffer(FakeBuffer&& other) {
+			std::swap(_destroyed, other._destroyed);
+		}
+
+		FakeBuffer& operator=(FakeBuffer&& other) {
+			std::swap(_destroyed, other._destroyed);
+			return *this;
+		}
+
+		~FakeBuffer() {
+			destroy();
+		}
+
+		void destroy() {
+			if(_destroyed) {
+				++*_destroyed;
+				_destroyed = nullptr;
+			}
+		}
+
+	private:
+		std::atomic<u32>* _destroyed = nullptr;
+};
+
+y_test_func("DeferredQueue collects in fence order") {
+	std::atomic<u32> destroyed[3] = {};
+	{
+		DeferredQueue<FakeBuffer> queue;
+		queue.push(1, FakeBuffer(&destroyed[0]));
+		queue.push(2, FakeBuffer(&destroyed[1]));
+		queue.push(4, FakeBuffer(&destroyed[2]));
+		y_test_assert(queue.size() == 3);
+
+		queue.collect(0, [](FakeBuffer& b) { b.destroy(); });
+		y_test_assert(queue.size() == 3);
+
+		queue.collect(2, [](FakeBuffer& b) { b.destroy(); });
+		y_test_assert(queue.size() == 1);
+		y_test_assert(destroyed[0] == 1 && destroyed[1] == 1 && destroyed[2] == 0);
+
+		queue.collect_all([](FakeBuffer& b) { b.destroy(); });
+		y_test_assert(queue.size() == 0);
+	}
+	y_test_assert(destroyed[0] == 1 && destroyed[1] == 1 && destroyed[2] == 1);
+}
+
+y_test_func("DeferredQueue multi-threaded stress test") {
+	static constexpr usize thread_count = 16;
+	static constexpr usize buffers_per_thread = 20000;
+
+	auto destroyed = std::make_unique<std::atomic<u32>[]>(thread_count * buffers_per_thread);
+	std::atomic<u64> counter = 0;
+	std::atomic<usize> early = 0;
+	std::atomic<bool> running = true;
+
+	struct Buffer {
+		FakeBuffer buffer;
+		u64 fence;
+	};
+
+	DeferredQueue<Buffer> queue;
+
+	// collects concurrently with the producers, like a lifetime manager would when command buffers complete
+	std::thread collector([&] {
+		while(running) {
+			const u64 up_to = counter;
+			queue.collect(up_to, [&](Buffer& b) {
+				if(b.fence > up_to) {
+					++early;
+				}
+				b.buffer.destroy();
+			});
+		}
+	});
+
+	core::Vector<std::thread> threads;
+	for(usize t = 0; t != thread_count; ++t) {
+		threads.emplace_back([&, t] {
+			for(usize i = 0; i != buffers_per_thread; ++i) {
+				const u64 fence = ++counter;
+				queue.push(fence, Buffer{FakeBuffer(&destroyed[t * buffers_per_thread + i]), fence});
+			}
+		});
+	}
+	for(auto& thread : threads) {
+		thread.join();
+	}
+
+	running = false;
+	collector.join();
+	queue.collect_all([](Buffer& b) { b.buffer.destroy(); });
+
+	y_test_assert(queue.size() == 0);
+	y_test_assert(early == 0);
+	for(usize i = 0; i != thread_count * buffers_per_thread; ++i) {
+		y_test_assert(destroyed[i] == 1);
+	}
+}
+
+}
@@ -0,0 +1,245 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <yave/framegraph/FrameGraph.h>
+
+#include <y/math/Transform.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static const ImageFormat format = ImageFormat(vk::Format::eR8G8B8A8Unorm);
+static const math::Vec2ui size = math::Vec2ui(64);
+
+static auto pass_names(const FrameGraph& graph) {
+	core::Vector<core::String> names;
+	for(const FrameGraphPass* pass : graph.passes()) {
+		names << pass->name();
+	}
+	return names;
+}
+
+static bool has_passes(const FrameGraph& graph, std::initializer_list<const char*> names) {
+	const auto passes = pass_names(graph);
+	if(passes.size() != names.size()) {
+		return false;
+	}
+	return std::equal(passes.begin(), passes.end(), names.begin());
+}
+
+y_test_func("FrameGraph culls passes without outputs") {
+	FrameGraph graph(std::make_shared<FrameGraphResourcePool>());
+
+	FrameGraphImageId a;
+	FrameGraphImageId b;
+	FrameGraphImageId unused;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("A");
+		auto img = builder.declare_image(format, size);
+		builder.add_color_output(img);
+		a = img;
+	}
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("B");
+		auto img = builder.declare_image(format, size);
+		builder.add_texture_input(a, PipelineStage::FragmentBit);
+		builder.add_storage_output(img);
+		b = img;
+	}
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Unused");
+		auto img = builder.declare_image(format, size);
+		builder.add_texture_input(a, PipelineStage::FragmentBit);
+		builder.add_color_output(img);
+		unused = img;
+	}
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Present");
+		builder.add_texture_input(b, PipelineStage::FragmentBit);
+		builder.set_has_side_effects();
+	}
+
+	graph.compile();
+
+	y_test_assert(has_passes(graph, {"A", "B", "Present"}));
+	y_test_assert(graph.has_resource(a));
+	y_test_assert(graph.has_resource(b));
+	y_test_assert(!graph.has_resource(unused));
+}
+
+y_test_func("FrameGraph keeps writers of outputs") {
+	FrameGraph graph(std::make_shared<FrameGraphResourcePool>());
+
+	FrameGraphMutableImageId color;
+	FrameGraphMutableTypedBufferId<u32> buffer;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Upload");
+		buffer = builder.declare_typed_buffer<u32>(16);
+		builder.add_storage_input(buffer);
+		builder.map_update(buffer);
+	}
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Draw");
+		color = builder.declare_image(format, size);
+		builder.add_color_output(color);
+		builder.add_uniform_input(buffer);
+	}
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Overlay");
+		builder.add_color_output(color, Framebuffer::LoadOp::Load);
+	}
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Readback");
+		auto readback = builder.declare_typed_buffer<u32>();
+		builder.add_uniform_input(color);
+		builder.add_storage_output(readback);
+	}
+
+	graph.mark_as_output(color);
+	graph.compile();
+
+	y_test_assert(has_passes(graph, {"Upload", "Draw", "Overlay"}));
+	y_test_assert(graph.has_resource(buffer));
+	y_test_assert(graph.has_resource(color));
+}
+
+y_test_func("FrameGraph culls a renderer shaped graph") {
+	FrameGraph graph(std::make_shared<FrameGraphResourcePool>());
+
+	const ImageFormat depth_format = ImageFormat(vk::Format::eD32Sfloat);
+	const ImageFormat hdr_format = ImageFormat(vk::Format::eR16G16B16A16Sfloat);
+
+	FrameGraphMutableImageId depth;
+	FrameGraphMutableImageId color;
+	FrameGraphMutableImageId normal;
+	FrameGraphMutableTypedBufferId<math::Transform<>> transforms;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("G-buffer pass");
+		depth = builder.declare_image(depth_format, size);
+		color = builder.declare_image(format, size);
+		normal = builder.declare_image(format, size);
+		transforms = builder.declare_typed_buffer<math::Transform<>>(128);
+		auto indirect = builder.declare_typed_buffer<vk::DrawIndexedIndirectCommand>(128);
+		builder.add_attrib_input(transforms);
+		builder.add_indirect_input(indirect);
+		builder.map_update(transforms);
+		builder.map_update(indirect);
+		builder.add_depth_output(depth);
+		builder.add_color_output(color);
+		builder.add_color_output(normal);
+	}
+
+	FrameGraphMutableImageId lit;
+	FrameGraphMutableTypedBufferId<u32> lights;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Lighting pass");
+		lit = builder.declare_image(hdr_format, size);
+		lights = builder.declare_typed_buffer<u32>(16);
+		builder.add_uniform_input(depth, 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(color, 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(normal, 0, PipelineStage::ComputeBit);
+		builder.add_storage_input(lights, 0, PipelineStage::ComputeBit);
+		builder.add_storage_output(lit, 0, PipelineStage::ComputeBit);
+		builder.map_update(lights);
+	}
+
+	FrameGraphMutableImageId tone_mapped;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Tone mapping pass");
+		tone_mapped = builder.declare_image(format, size);
+		builder.add_color_output(tone_mapped, Framebuffer::LoadOp::Load);
+		builder.add_uniform_input(lit, 0, PipelineStage::FragmentBit);
+	}
+
+	// only used for picking, which has its own graph
+	FrameGraphImageId ids;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Entity id pass");
+		auto id_depth = builder.declare_copy(depth);
+		auto id = builder.declare_image(ImageFormat(vk::Format::eR32Uint), size);
+		builder.add_depth_output(id_depth, Framebuffer::LoadOp::Load);
+		builder.add_color_output(id);
+		ids = id;
+	}
+
+	FrameGraphImageId debug;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Debug normals pass");
+		auto img = builder.declare_image(format, size);
+		builder.add_uniform_input(normal, 0, PipelineStage::FragmentBit);
+		builder.add_color_output(img);
+		debug = img;
+	}
+
+	FrameGraphMutableImageId out;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Editor entity pass");
+		out = builder.declare_image(format, size);
+		builder.add_depth_output(depth, Framebuffer::LoadOp::Load);
+		builder.add_color_output(out);
+		builder.add_uniform_input(tone_mapped, 0, PipelineStage::FragmentBit);
+	}
+
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("Luminance readback pass");
+		auto luminance = builder.declare_typed_buffer<float>(1);
+		builder.add_uniform_input(lit, 0, PipelineStage::ComputeBit);
+		builder.add_storage_output(luminance, 0, PipelineStage::ComputeBit);
+	}
+
+	graph.mark_as_output(out);
+	graph.compile();
+
+	y_test_assert(has_passes(graph, {"G-buffer pass", "Lighting pass", "Tone mapping pass", "Editor entity pass"}));
+	y_test_assert(graph.has_resource(transforms));
+	y_test_assert(graph.has_resource(lights));
+	y_test_assert(graph.has_resource(tone_mapped));
+	y_test_assert(!graph.has_resource(ids));
+	y_test_assert(!graph.has_resource(debug));
+}
+
+y_test_func("FrameGraph culls everything without outputs") {
+	FrameGraph graph(std::make_shared<FrameGraphResourcePool>());
+
+	FrameGraphImageId img;
+	FrameGraphImageId copy;
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("A");
+		auto color = builder.declare_image(format, size);
+		builder.add_color_output(color);
+		img = color;
+	}
+	{
+		FrameGraphPassBuilder builder = graph.add_pass("B");
+		copy = builder.declare_copy(img);
+	}
+
+	graph.compile();
+
+	y_test_assert(graph.passes().is_empty());
+	y_test_assert(!graph.has_resource(img));
+	y_test_assert(!graph.has_resource(copy));
+}
+
+}
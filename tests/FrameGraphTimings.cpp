@@ -0,0 +1,88 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/test.h>
+#include <yave/framegraph/FrameGraphTimings.h>
+
+#include <cmath>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static core::Duration millis(double ms) {
+	return core::Duration::milliseconds(ms);
+}
+
+static bool about_equal(core::Duration a, double ms) {
+	return std::abs(a.to_millis() - ms) < 0.001;
+}
+
+y_test_func("FrameGraphTimings keeps per pass statistics") {
+	FrameGraphTimings timings;
+
+	const double a_times[] = {1.0, 3.0, 2.0};
+	for(double ms : a_times) {
+		timings.add_sample("A", millis(ms));
+		timings.add_sample("B", millis(ms * 10.0));
+	}
+	timings.add_sample("C", millis(0.5));
+
+	const auto passes = timings.pass_timings();
+	y_test_assert(passes.size() == 3);
+
+	y_test_assert(passes[0].name == "A");
+	y_test_assert(passes[0].samples == 3);
+	y_test_assert(about_equal(passes[0].average, 2.0));
+	y_test_assert(about_equal(passes[0].min, 1.0));
+	y_test_assert(about_equal(passes[0].max, 3.0));
+
+	y_test_assert(passes[1].name == "B");
+	y_test_assert(about_equal(passes[1].average, 20.0));
+
+	y_test_assert(passes[2].name == "C");
+	y_test_assert(passes[2].samples == 1);
+
+	y_test_assert(about_equal(timings.total_average(), 22.5));
+}
+
+y_test_func("FrameGraphTimings only keeps the most recent samples") {
+	FrameGraphTimings timings;
+
+	for(usize i = 0; i != FrameGraphTimings::window_size; ++i) {
+		timings.add_sample("A", millis(100.0));
+	}
+	for(usize i = 0; i != FrameGraphTimings::window_size; ++i) {
+		timings.add_sample("A", millis(1.0 + i % 2));
+	}
+
+	const auto passes = timings.pass_timings();
+	y_test_assert(passes.size() == 1);
+	y_test_assert(passes[0].samples == FrameGraphTimings::window_size);
+	y_test_assert(about_equal(passes[0].average, 1.5));
+	y_test_assert(about_equal(passes[0].min, 1.0));
+	y_test_assert(about_equal(passes[0].max, 2.0));
+
+	timings.clear();
+	y_test_assert(timings.pass_timings().is_empty());
+}
+
+}
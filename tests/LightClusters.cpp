@@ -0,0 +1,270 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <yave/renderer/LightClusters.h>
+
+#include <y/math/math.h>
+
+#include <random>
+#include <algorithm>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static const math::Vec2ui viewport(1280, 720);
+
+static math::Matrix4<> camera_proj() {
+	return math::perspective(math::to_rad(60.0f), float(viewport.x()) / float(viewport.y()), 0.1f);
+}
+
+static uniform::Light point_light(const math::Vec3& position, float radius) {
+	return uniform::Light{position, radius, math::Vec3(1.0f), uniform::Light::Type::Point};
+}
+
+static float slice_begin(u32 slice) {
+	return slice ? LightClusters::min_depth * std::exp2((slice - 1) / LightClusters::depth_scale()) : 0.0f;
+}
+
+// view space position of the point at depth along the camera axis that projects to ndc
+static math::Vec3 unproject(const math::Matrix4<>& proj, const math::Vec2& ndc, float depth) {
+	const math::Vec4 unit = proj * math::Vec4(1.0f, 1.0f, -1.0f, 1.0f);
+	return math::Vec3(ndc.x() * depth / (unit.x() / unit.w()), ndc.y() * depth / (unit.y() / unit.w()), -depth);
+}
+
+static math::Vec2 tile_center_ndc(u32 x, u32 y) {
+	return math::Vec2((x + 0.5f) * LightClusters::tile_size / viewport.x(),
+					  (y + 0.5f) * LightClusters::tile_size / viewport.y()) * 2.0f - 1.0f;
+}
+
+static bool contains(const LightClusters& clusters, u32 x, u32 y, u32 slice, u32 light) {
+	const LightClusters::Cluster& cluster = clusters.clusters()[clusters.cluster_index(x, y, slice)];
+	const u32* begin = clusters.light_indices().data() + cluster.offset;
+	return std::find(begin, begin + cluster.count, light) != begin + cluster.count;
+}
+
+static usize assignment_count(const LightClusters& clusters, u32 light) {
+	usize count = 0;
+	for(const LightClusters::Cluster& cluster : clusters.clusters()) {
+		const u32* begin = clusters.light_indices().data() + cluster.offset;
+		count += std::count(begin, begin + cluster.count, light);
+	}
+	return count;
+}
+
+// Brute force reference: a light touches a cluster if its sphere contains any sample of the cluster volume
+static bool reference_touches(const math::Matrix4<>& proj, const math::Vec3& center, float radius, u32 x, u32 y, u32 slice) {
+	static constexpr usize samples = 5;
+
+	const float pixel_begin[] = {float(x * LightClusters::tile_size), float(y * LightClusters::tile_size)};
+	const float pixel_end[] = {
+		float(std::min((x + 1) * LightClusters::tile_size, viewport.x())),
+		float(std::min((y + 1) * LightClusters::tile_size, viewport.y()))
+	};
+	const float depth_begin = slice_begin(slice);
+	const float depth_end = slice + 1 == LightClusters::slice_count ? 2.0f * LightClusters::max_depth : slice_begin(slice + 1);
+
+	for(usize i = 0; i != samples; ++i) {
+		const float depth = depth_begin + (depth_end - depth_begin) * i / (samples - 1);
+		for(usize j = 0; j != samples; ++j) {
+			for(usize k = 0; k != samples; ++k) {
+				const math::Vec2 pixel(pixel_begin[0] + (pixel_end[0] - pixel_begin[0]) * j / (samples - 1),
+									   pixel_begin[1] + (pixel_end[1] - pixel_begin[1]) * k / (samples - 1));
+				const math::Vec2 ndc(pixel.x() / viewport.x() * 2.0f - 1.0f, pixel.y() / viewport.y() * 2.0f - 1.0f);
+				if((unproject(proj, ndc, depth) - center).length2() <= radius * radius) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+y_test_func("LightClusters exponential slices") {
+	y_test_assert(LightClusters::slice(0.0f) == 0);
+	y_test_assert(LightClusters::slice(LightClusters::min_depth) == 0);
+	y_test_assert(LightClusters::slice(LightClusters::min_depth * 1.001f) == 1);
+	y_test_assert(LightClusters::slice(LightClusters::max_depth * 0.999f) == LightClusters::slice_count - 2);
+	y_test_assert(LightClusters::slice(LightClusters::max_depth * 1.001f) == LightClusters::slice_count - 1);
+	y_test_assert(LightClusters::slice(1.0e6f) == LightClusters::slice_count - 1);
+
+	// slices 1 to slice_count - 2 split [min_depth, max_depth] with a constant ratio
+	const float ratio = slice_begin(2) / slice_begin(1);
+	y_test_assert(ratio > 1.0f);
+	y_test_assert(std::abs(slice_begin(LightClusters::slice_count - 1) - LightClusters::max_depth) < LightClusters::max_depth * 1.0e-4f);
+	for(u32 s = 1; s != LightClusters::slice_count - 1; ++s) {
+		const float begin = slice_begin(s);
+		y_test_assert(std::abs(slice_begin(s + 1) / begin - ratio) < 1.0e-3f);
+		y_test_assert(LightClusters::slice(begin * 1.001f) == s);
+		y_test_assert(LightClusters::slice(begin * 0.999f) == s - 1);
+	}
+}
+
+y_test_func("LightClusters tile bounds") {
+	const math::Matrix4<> view = math::Matrix4<>::identity();
+	const math::Matrix4<> proj = camera_proj();
+
+	{
+		const LightClusters clusters(view, proj, viewport, {});
+		y_test_assert(clusters.grid_size() == math::Vec3ui(20, 12, LightClusters::slice_count));
+		y_test_assert(clusters.clusters().size() == 20 * 12 * LightClusters::slice_count);
+		y_test_assert(clusters.cluster_index(19, 11, LightClusters::slice_count - 1) == clusters.clusters().size() - 1);
+		y_test_assert(clusters.cluster_index(1, 0, 0) == 1);
+		y_test_assert(clusters.cluster_index(0, 1, 0) == 20);
+		y_test_assert(clusters.cluster_index(0, 0, 1) == 20 * 12);
+		y_test_assert(clusters.light_indices().is_empty());
+	}
+
+	y_test_assert(LightClusters(view, proj, math::Vec2ui(64, 64), {}).grid_size() == math::Vec3ui(1, 1, LightClusters::slice_count));
+	y_test_assert(LightClusters(view, proj, math::Vec2ui(65, 1), {}).grid_size() == math::Vec3ui(2, 1, LightClusters::slice_count));
+	y_test_assert(LightClusters(view, proj, math::Vec2ui(0, 0), {}).grid_size() == math::Vec3ui(1, 1, LightClusters::slice_count));
+
+	// a small light in the middle of a cluster only lands in that cluster
+	for(const auto& [x, y, slice] : {std::tuple<u32, u32, u32>{3, 5, 10}, {0, 0, 1}, {19, 10, 20}}) {
+		const float depth = std::sqrt(slice_begin(slice) * slice_begin(slice + 1));
+		const uniform::Light light = point_light(unproject(proj, tile_center_ndc(x, y), depth), depth * 0.001f);
+		const LightClusters clusters(view, proj, viewport, {light});
+		y_test_assert(assignment_count(clusters, 0) == 1);
+		y_test_assert(contains(clusters, x, y, slice, 0));
+	}
+
+	// lights behind the camera or outside of the screen are not assigned
+	{
+		const uniform::Light behind = point_light(math::Vec3(0.0f, 0.0f, 10.0f), 5.0f);
+		const uniform::Light left = point_light(unproject(proj, math::Vec2(-3.0f, 0.0f), 10.0f), 1.0f);
+		const uniform::Light top = point_light(unproject(proj, math::Vec2(0.0f, 3.0f), 10.0f), 1.0f);
+		const LightClusters clusters(view, proj, viewport, {behind, left, top});
+		y_test_assert(clusters.light_indices().is_empty());
+	}
+
+	// lights partially off screen are clamped to the border tiles
+	{
+		const uniform::Light light = point_light(unproject(proj, math::Vec2(-1.0f, 1.0f), 10.0f), 0.01f);
+		const LightClusters clusters(view, proj, viewport, {light});
+		const u32 slice = LightClusters::slice(10.0f);
+		y_test_assert(assignment_count(clusters, 0) == 1);
+		y_test_assert(contains(clusters, 0, 11, slice, 0));
+	}
+}
+
+y_test_func("LightClusters lights straddling clusters") {
+	const math::Matrix4<> view = math::Matrix4<>::identity();
+	const math::Matrix4<> proj = camera_proj();
+
+	// on a slice boundary
+	{
+		const u32 slice = 12;
+		const float depth = slice_begin(slice);
+		const uniform::Light light = point_light(unproject(proj, tile_center_ndc(7, 4), depth), depth * 0.001f);
+		const LightClusters clusters(view, proj, viewport, {light});
+		y_test_assert(assignment_count(clusters, 0) == 2);
+		y_test_assert(contains(clusters, 7, 4, slice - 1, 0));
+		y_test_assert(contains(clusters, 7, 4, slice, 0));
+	}
+
+	// on the corner of four tiles
+	{
+		const u32 slice = 8;
+		const float depth = std::sqrt(slice_begin(slice) * slice_begin(slice + 1));
+		const math::Vec2 ndc = math::Vec2(math::Vec2ui(5, 2) * LightClusters::tile_size) / math::Vec2(viewport) * 2.0f - 1.0f;
+		const uniform::Light light = point_light(unproject(proj, ndc, depth), depth * 0.001f);
+		const LightClusters clusters(view, proj, viewport, {light});
+		y_test_assert(assignment_count(clusters, 0) == 4);
+		for(u32 x : {4, 5}) {
+			for(u32 y : {1, 2}) {
+				y_test_assert(contains(clusters, x, y, slice, 0));
+			}
+		}
+	}
+
+	// around the camera: every tile of the slices it reaches
+	{
+		const uniform::Light light = point_light(math::Vec3(0.0f, 0.0f, -1.0f), 3.0f);
+		const LightClusters clusters(view, proj, viewport, {light});
+		const u32 last_slice = LightClusters::slice(4.0f);
+		y_test_assert(assignment_count(clusters, 0) == 20 * 12 * (last_slice + 1));
+		y_test_assert(contains(clusters, 0, 0, 0, 0));
+		y_test_assert(contains(clusters, 19, 11, last_slice, 0));
+	}
+
+	// across the camera plane but to the side of the view
+	{
+		const uniform::Light light = point_light(math::Vec3(50.0f, 0.0f, -0.5f), 5.0f);
+		const LightClusters clusters(view, proj, viewport, {light});
+		y_test_assert(clusters.light_indices().is_empty());
+	}
+}
+
+y_test_func("LightClusters matches brute force reference") {
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<float> pos(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> radius(0.1f, 15.0f);
+
+	const math::Vec3 eye(4.0f, -3.0f, 2.0f);
+	const math::Matrix4<> view = math::look_at(eye, eye + math::Vec3(1.0f, 0.5f, -0.2f), math::Vec3(0.0f, 0.0f, 1.0f));
+	const math::Matrix4<> proj = camera_proj();
+
+	core::Vector<uniform::Light> lights;
+	for(usize i = 0; i != 200; ++i) {
+		lights << point_light(eye + math::Vec3(pos(rng), pos(rng), pos(rng)), radius(rng));
+	}
+	lights << point_light(eye, 2.0f);
+
+	const LightClusters clusters(view, proj, viewport, lights);
+	const math::Vec3ui grid = clusters.grid_size();
+
+	// clusters are packed in order and list their lights in index order
+	u32 offset = 0;
+	for(const LightClusters::Cluster& cluster : clusters.clusters()) {
+		y_test_assert(cluster.offset == offset);
+		const u32* begin = clusters.light_indices().data() + cluster.offset;
+		for(u32 i = 0; i != cluster.count; ++i) {
+			y_test_assert(begin[i] < lights.size());
+			y_test_assert(!i || begin[i - 1] < begin[i]);
+		}
+		offset += cluster.count;
+	}
+	y_test_assert(offset == clusters.light_indices().size());
+
+	usize touched = 0;
+	for(u32 l = 0; l != lights.size(); ++l) {
+		const math::Vec3 center = (view * math::Vec4(lights[l].position, 1.0f)).to<3>();
+		for(u32 z = 0; z != grid.z(); ++z) {
+			for(u32 y = 0; y != grid.y(); ++y) {
+				for(u32 x = 0; x != grid.x(); ++x) {
+					if(reference_touches(proj, center, lights[l].radius, x, y, z)) {
+						y_test_assert(contains(clusters, x, y, z, l));
+						++touched;
+					}
+				}
+			}
+		}
+	}
+
+	// binning is conservative but should stay close to the reference
+	y_test_assert(touched);
+	y_test_assert(clusters.light_indices().size() >= touched);
+	y_test_assert(clusters.light_indices().size() < touched * 4);
+}
+
+}
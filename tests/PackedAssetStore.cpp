@@ -0,0 +1,118 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/test.h>
+#include <yave/assets/PackedAssetStore.h>
+#include <yave/assets/FolderAssetStore.h>
+
+#include <y/io2/Buffer.h>
+
+#include <filesystem>
+
+#ifndef YAVE_NO_STDFS
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static core::String temp_path(std::string_view name) {
+	return core::String((std::filesystem::temp_directory_path() / std::string(name)).string());
+}
+
+y_test_func("PackedAssetStore pack") {
+	const core::String folder = temp_path("yave_packed_store_test");
+	const core::String archive = temp_path("yave_packed_store_test.pack");
+	std::filesystem::remove_all(folder.data());
+	std::filesystem::create_directories(folder.data());
+
+	core::Vector<AssetId> ids;
+	{
+		FolderAssetStore store(folder);
+		for(usize i = 0; i != 17; ++i) {
+			io2::Buffer buffer;
+			for(usize j = 0; j != i * 7 + 1; ++j) {
+				buffer.write_one(u8(i + j)).unwrap();
+			}
+			ids << store.import(buffer, fmt("folder/asset_%", i)).unwrap();
+		}
+
+		const AssetDependency dep{ids[0], "Texture"};
+		store.set_dependencies(ids[3], core::Span<AssetDependency>(dep)).unwrap();
+
+		PackedAssetStore::pack(store, archive).unwrap();
+	}
+
+	PackedAssetStore packed(archive);
+	y_test_assert(packed.size() == ids.size());
+	y_test_assert(!packed.id("folder/asset_17"));
+	y_test_assert(!packed.import(*std::make_unique<io2::Buffer>(), "new"));
+
+	for(usize i = 0; i != ids.size(); ++i) {
+		const core::String name = fmt("folder/asset_%", i);
+		y_test_assert(packed.id(name).unwrap() == ids[i]);
+		y_test_assert(packed.name(ids[i]).unwrap() == name);
+
+		auto reader = std::move(packed.data(ids[i]).unwrap());
+		auto view = reader->read_view(i * 7 + 1, PackedAssetStore::data_alignment).unwrap();
+		y_test_assert(reader->at_end());
+		for(usize j = 0; j != view.size(); ++j) {
+			y_test_assert(view[j] == u8(i + j));
+		}
+	}
+
+	const auto deps = packed.dependencies(ids[3]).unwrap();
+	y_test_assert(deps.size() == 1 && deps[0].id == ids[0] && deps[0].type == "Texture");
+	y_test_assert(packed.dependencies(ids[4]).unwrap().is_empty());
+}
+
+y_test_func("PackedAssetStore pack compressed") {
+	const core::String folder = temp_path("yave_packed_store_lz_test");
+	const core::String archive = temp_path("yave_packed_store_lz_test.pack");
+	std::filesystem::remove_all(folder.data());
+	std::filesystem::create_directories(folder.data());
+
+	core::Vector<u8> repeated(100000, u8(7));
+	core::Vector<u8> tiny = {1, 2, 3};
+
+	AssetId repeated_id;
+	AssetId tiny_id;
+	{
+		FolderAssetStore store(folder);
+		io2::Buffer repeated_buffer{core::Vector<u8>(repeated)};
+		io2::Buffer tiny_buffer{core::Vector<u8>(tiny)};
+		repeated_id = store.import(repeated_buffer, "repeated").unwrap();
+		tiny_id = store.import(tiny_buffer, "tiny").unwrap();
+		PackedAssetStore::pack(store, archive, true).unwrap();
+	}
+
+	y_test_assert(std::filesystem::file_size(archive.data()) < repeated.size());
+
+	PackedAssetStore packed(archive);
+	for(const auto& [id, bytes] : {std::pair(repeated_id, &repeated), std::pair(tiny_id, &tiny)}) {
+		core::Vector<u8> data;
+		packed.data(id).unwrap()->read_all(data).unwrap();
+		y_test_assert(std::equal(data.begin(), data.end(), bytes->begin(), bytes->end()));
+	}
+}
+
+}
+
+#endif // YAVE_NO_STDFS
@@ -0,0 +1,224 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <yave/scene/AABBTree.h>
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/concurrent/concurrent.h>
+
+#include <random>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+struct CullingBounds {
+	AABB aabb;
+};
+
+static constexpr float world_size = 1000.0f;
+
+static AABB random_aabb(std::mt19937& rng) {
+	std::uniform_real_distribution<float> pos(0.0f, world_size);
+	std::uniform_real_distribution<float> size(0.5f, 5.0f);
+	const math::Vec3 min(pos(rng), pos(rng), pos(rng));
+	return AABB(min, min + math::Vec3(size(rng), size(rng), size(rng)));
+}
+
+// axis aligned box covering [begin, end] on every axis
+static Frustum box_frustum(float begin, float end) {
+	return Frustum(std::array<Plane, 6>{{
+			Plane(1.0f, 0.0f, 0.0f, -begin),
+			Plane(-1.0f, 0.0f, 0.0f, end),
+			Plane(0.0f, 1.0f, 0.0f, -begin),
+			Plane(0.0f, -1.0f, 0.0f, end),
+			Plane(0.0f, 0.0f, 1.0f, -begin),
+			Plane(0.0f, 0.0f, -1.0f, end)
+		}});
+}
+
+static usize count_visible(const AABBTree& tree, const Frustum& frustum) {
+	usize visible = 0;
+	tree.for_each_in_frustum(frustum, [&](u32) { ++visible; });
+	return visible;
+}
+
+static usize count_fat_visible(const AABBTree& tree, core::Span<AABBTree::NodeId> leaves, const Frustum& frustum) {
+	usize visible = 0;
+	for(AABBTree::NodeId leaf : leaves) {
+		visible += AABBTree::intersects(frustum, tree.fat_aabb(leaf));
+	}
+	return visible;
+}
+
+y_test_func("EntityWorld flushes component mutations") {
+	ecs::EntityWorld world;
+	const ecs::EntityId a = world.create_entity();
+	const ecs::EntityId b = world.create_entity();
+	world.create_component<CullingBounds>(a);
+	world.create_component<CullingBounds>(b);
+
+	world.flush();
+	y_test_assert(world.flushed_mutations<CullingBounds>().all);
+
+	world.flush();
+	y_test_assert(!world.flushed_mutations<CullingBounds>().all);
+	y_test_assert(world.flushed_mutations<CullingBounds>().indexes.is_empty());
+
+	{
+		const ecs::EntityWorld& const_world = world;
+		y_test_assert(const_world.component<CullingBounds>(a));
+		usize count = 0;
+		for(auto e : const_world.view<CullingBounds>()) {
+			unused(e);
+			++count;
+		}
+		y_test_assert(count == 2);
+	}
+
+	world.flush();
+	y_test_assert(!world.flushed_mutations<CullingBounds>().all);
+	y_test_assert(world.flushed_mutations<CullingBounds>().indexes.is_empty());
+
+	world.component<CullingBounds>(b)->aabb = AABB(math::Vec3(1.0f), math::Vec3(2.0f));
+	world.remove_entity(a);
+
+	world.flush();
+	{
+		const ecs::ComponentMutations& mutations = world.flushed_mutations<CullingBounds>();
+		y_test_assert(!mutations.all);
+		y_test_assert(mutations.indexes.size() == 1);
+		y_test_assert(mutations.indexes[0] == b.index());
+		y_test_assert(world.flushed_deletions().size() == 1);
+		y_test_assert(world.flushed_deletions()[0] == a);
+		y_test_assert(world.flush_count() == 4);
+	}
+
+	// iterating indexes doesn't hand out any component
+	for(ecs::EntityIndex index : world.view<CullingBounds>().indexes()) {
+		unused(index);
+	}
+	world.flush();
+	y_test_assert(world.flushed_mutations<CullingBounds>().indexes.is_empty());
+	y_test_assert(world.flushed_deletions().is_empty());
+
+	const ecs::EntityId c = world.create_entity();
+	world.create_component<CullingBounds>(c);
+	world.flush();
+
+	// mutable views only record the components they hand out
+	for(auto e : world.view<CullingBounds>()) {
+		if(e.index() == c.index()) {
+			e.component<CullingBounds>().aabb = AABB(math::Vec3(3.0f), math::Vec3(4.0f));
+		}
+	}
+	world.flush();
+	{
+		const ecs::ComponentMutations& mutations = world.flushed_mutations<CullingBounds>();
+		y_test_assert(!mutations.all);
+		y_test_assert(mutations.indexes.size() == 1);
+		y_test_assert(mutations.indexes[0] == c.index());
+	}
+
+	world.components<CullingBounds>();
+	world.flush();
+	y_test_assert(world.flushed_mutations<CullingBounds>().all);
+}
+
+y_test_func("EntityWorld records mutations from several threads") {
+	const usize count = 10000;
+
+	ecs::EntityWorld world;
+	core::Vector<ecs::EntityId> ids;
+	for(usize i = 0; i != count; ++i) {
+		ids << world.create_entity();
+		world.create_component<CullingBounds>(ids.last());
+	}
+	world.flush();
+	world.flush();
+
+	concurrent::parallel_for(ids.begin(), ids.end(), [&](auto it) {
+		if(it->index() % 3 == 0) {
+			world.component<CullingBounds>(*it)->aabb = AABB(math::Vec3(0.0f), math::Vec3(1.0f));
+		}
+	});
+	world.flush();
+
+	const ecs::ComponentMutations& mutations = world.flushed_mutations<CullingBounds>();
+	y_test_assert(!mutations.all);
+	y_test_assert(mutations.indexes.size() == (count + 2) / 3);
+	for(ecs::EntityIndex index : mutations.indexes) {
+		y_test_assert(index % 3 == 0);
+	}
+}
+
+y_test_func("AABBTree culling matches a linear scan") {
+	std::mt19937 rng(7);
+	const Frustum frustum = box_frustum(world_size * 0.25f, world_size * 0.75f);
+
+	const usize count = 5000;
+	ecs::EntityWorld world;
+	auto items = core::vector_with_capacity<AABBTree::Item>(count);
+	for(usize i = 0; i != count; ++i) {
+		const ecs::EntityId id = world.create_entity();
+		y_test_assert(id.index() == i);
+		const AABB aabb = random_aabb(rng);
+		world.create_component<CullingBounds>(id, CullingBounds{aabb});
+		items << AABBTree::Item{aabb, u32(id.index())};
+	}
+	world.flush();
+
+	AABBTree tree;
+	const core::Vector<AABBTree::NodeId> leaves = tree.build(items);
+
+	usize linear_visible = 0;
+	for(const AABBTree::Item& item : items) {
+		linear_visible += AABBTree::intersects(frustum, item.aabb);
+	}
+
+	// fat AABBs can only add false positives
+	const usize visible = count_visible(tree, frustum);
+	y_test_assert(visible >= linear_visible);
+	y_test_assert(visible == count_fat_visible(tree, leaves, frustum));
+
+	// move some instances and only refit those, like SceneBVH::update does after a flush
+	for(usize i = 0; i != count / 100; ++i) {
+		const ecs::EntityId id = world.id_from_index(ecs::EntityIndex(rng() % count));
+		world.component<CullingBounds>(id)->aabb = random_aabb(rng);
+	}
+	world.flush();
+
+	const ecs::EntityWorld& const_world = world;
+	const ecs::ComponentMutations& mutations = const_world.flushed_mutations<CullingBounds>();
+	y_test_assert(!mutations.all);
+	y_test_assert(!mutations.indexes.is_empty() && mutations.indexes.size() <= count / 100);
+
+	for(ecs::EntityIndex index : mutations.indexes) {
+		tree.update(leaves[index], const_world.component<CullingBounds>(const_world.id_from_index(index))->aabb);
+	}
+
+	y_test_assert(tree.size() == count);
+	y_test_assert(count_visible(tree, frustum) == count_fat_visible(tree, leaves, frustum));
+}
+
+}
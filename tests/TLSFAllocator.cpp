@@ -0,0 +1,172 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <yave/graphics/memory/TLSFAllocator.h>
+
+#include <y/core/Chrono.h>
+
+#include <random>
+#include <algorithm>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+struct Allocation {
+	usize offset;
+	usize size;
+	usize alignment;
+};
+
+static bool is_valid(core::Vector<Allocation> allocations, usize total_size) {
+	std::sort(allocations.begin(), allocations.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+	for(usize i = 0; i != allocations.size(); ++i) {
+		const Allocation& a = allocations[i];
+		if(a.offset % a.alignment || a.offset + a.size > total_size) {
+			return false;
+		}
+		if(i && allocations[i - 1].offset + allocations[i - 1].size > a.offset) {
+			return false;
+		}
+	}
+	return true;
+}
+
+y_test_func("TLSF allocator basic") {
+	TLSFAllocator allocator(1024 * 1024, 256);
+	y_test_assert(allocator.available() == 1024 * 1024);
+	y_test_assert(allocator.free_blocks() == 1);
+
+	const usize a = allocator.alloc(1000).unwrap();
+	const usize b = allocator.alloc(256).unwrap();
+	const usize c = allocator.alloc(4096, 4096).unwrap();
+
+	y_test_assert(c % 4096 == 0);
+	y_test_assert(allocator.allocations() == 3);
+	y_test_assert(allocator.available() == 1024 * 1024 - 1024 - 256 - 4096);
+
+	allocator.free(b);
+	allocator.free(a);
+	allocator.free(c);
+
+	y_test_assert(allocator.available() == 1024 * 1024);
+	y_test_assert(allocator.free_blocks() == 1);
+	y_test_assert(allocator.largest_free_block() == 1024 * 1024);
+	y_test_assert(allocator.fragmentation() == 0.0f);
+}
+
+y_test_func("TLSF allocator exhaustion") {
+	TLSFAllocator allocator(64 * 1024, 256);
+
+	core::Vector<usize> offsets;
+	while(auto r = allocator.alloc(1024)) {
+		offsets << r.unwrap();
+	}
+	y_test_assert(offsets.size() == 64);
+	y_test_assert(!allocator.available());
+	y_test_assert(!allocator.alloc(1));
+
+	// freeing every other block fragments memory: nothing bigger than a block can be allocated
+	for(usize i = 0; i < offsets.size(); i += 2) {
+		allocator.free(offsets[i]);
+	}
+	y_test_assert(allocator.free_blocks() == 32);
+	y_test_assert(allocator.largest_free_block() == 1024);
+	y_test_assert(allocator.fragmentation() > 0.9f);
+	y_test_assert(!allocator.alloc(2048));
+	y_test_assert(allocator.alloc(1024));
+}
+
+y_test_func("TLSF allocator fuzz") {
+	const usize total_size = 16 * 1024 * 1024;
+	TLSFAllocator allocator(total_size, 256);
+
+	std::mt19937 rng(13);
+	core::Vector<Allocation> allocations;
+	usize allocated = 0;
+
+	for(usize i = 0; i != 20000; ++i) {
+		if(allocations.is_empty() || rng() % 3) {
+			const usize size = (rng() % 4 ? 1 + rng() % 4096 : 1 + rng() % (512 * 1024));
+			const usize alignment = usize(1) << (rng() % 14);
+			if(auto r = allocator.alloc(size, alignment)) {
+				const usize aligned_size = (size + 255) / 256 * 256;
+				allocations << Allocation{r.unwrap(), aligned_size, alignment};
+				allocated += aligned_size;
+			}
+		} else {
+			auto it = allocations.begin() + rng() % allocations.size();
+			allocator.free(it->offset);
+			allocated -= it->size;
+			allocations.erase_unordered(it);
+		}
+
+		y_test_assert(allocator.available() == total_size - allocated);
+		y_test_assert(allocator.allocations() == allocations.size());
+		if(i % 1000 == 0) {
+			y_test_assert(is_valid(allocations, total_size));
+		}
+	}
+	y_test_assert(is_valid(allocations, total_size));
+
+	for(const Allocation& a : allocations) {
+		allocator.free(a.offset);
+	}
+	y_test_assert(allocator.available() == total_size);
+	y_test_assert(allocator.free_blocks() == 1);
+}
+
+y_test_func("TLSF allocator benchmark") {
+	const usize op_count = 1000000;
+	TLSFAllocator allocator(usize(128) * 1024 * 1024, 256);
+
+	std::mt19937 rng(17);
+	core::Vector<usize> offsets;
+
+	core::Chrono chrono;
+	usize failures = 0;
+	for(usize i = 0; i != op_count; ++i) {
+		if(offsets.is_empty() || rng() % 2) {
+			if(auto r = allocator.alloc(1 + rng() % (64 * 1024))) {
+				offsets << r.unwrap();
+			} else {
+				++failures;
+			}
+		} else {
+			auto it = offsets.begin() + rng() % offsets.size();
+			allocator.free(*it);
+			offsets.erase_unordered(it);
+		}
+	}
+	const double ms = chrono.elapsed().to_millis();
+
+	log_msg(fmt("TLSF: % operations in %ms (% failed), % live allocations, % free blocks, %% fragmentation",
+		op_count, ms, failures, offsets.size(), allocator.free_blocks(), usize(allocator.fragmentation() * 100.0f), "%"));
+
+	for(usize offset : offsets) {
+		allocator.free(offset);
+	}
+	y_test_assert(allocator.free_blocks() == 1);
+}
+
+}
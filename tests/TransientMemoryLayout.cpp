@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <yave/framegraph/TransientMemoryLayout.h>
+
+#include <random>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static bool is_valid_layout(core::Span<TransientAllocation> allocations, usize total_size) {
+	for(usize i = 0; i != allocations.size(); ++i) {
+		const auto& a = allocations[i];
+		if(a.offset % a.alignment || a.offset + a.byte_size > total_size) {
+			return false;
+		}
+		for(usize j = i + 1; j != allocations.size(); ++j) {
+			const auto& b = allocations[j];
+			const bool memory_overlaps = a.offset < b.offset + b.byte_size && b.offset < a.offset + a.byte_size;
+			if(memory_overlaps && a.overlaps(b)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+y_test_func("Transient memory layout aliases disjoint lifetimes") {
+	TransientAllocation allocations[] = {
+		{1024, 256, 1, 2},
+		{1024, 256, 3, 4},
+		{512, 256, 2, 3},
+		{512, 256, 5, 5},
+	};
+
+	const usize total_size = compute_transient_memory_layout(allocations);
+
+	y_test_assert(total_size == 1536);
+	y_test_assert(allocations[0].offset == allocations[1].offset);
+	y_test_assert(is_valid_layout(allocations, total_size));
+}
+
+y_test_func("Transient memory layout random") {
+	std::mt19937 rng(7);
+	for(usize k = 0; k != 100; ++k) {
+		core::Vector<TransientAllocation> allocations;
+		usize sum = 0;
+		for(usize i = 0, count = 1 + rng() % 32; i != count; ++i) {
+			const usize first = 1 + rng() % 16;
+			allocations << TransientAllocation{1 + rng() % 4096, usize(1) << (rng() % 8), first, first + rng() % 8};
+			sum += allocations.last().byte_size + allocations.last().alignment;
+		}
+
+		const usize total_size = compute_transient_memory_layout(allocations);
+		y_test_assert(total_size <= sum);
+		y_test_assert(is_valid_layout(allocations, total_size));
+	}
+}
+
+}
@@ -0,0 +1,98 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/io2/Buffer.h>
+#include <y/serde2/serde.h>
+
+#include <y/test/test.h>
+
+#include <filesystem>
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::serde2;
+
+struct Arrays {
+	core::Span<u32> view;
+	core::Vector<u32> storage;
+
+	y_deserialize2(check(u32(0xCAFE)), array_view(view, storage))
+};
+
+static core::String write_test_file(const core::Vector<u32>& values) {
+	const auto path = (std::filesystem::temp_directory_path() / "y_mapped_file_test").string();
+	io2::File file = std::move(io2::File::create(path.c_str()).unwrap());
+	WritableArchive ar(file);
+	ar(u32(0xCAFE), values).unwrap();
+	file.flush().unwrap();
+	return path.c_str();
+}
+
+y_test_func("MappedFile read") {
+	const core::Vector<u32> values = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	const core::String path = write_test_file(values);
+
+	io2::MappedFile file = std::move(io2::MappedFile::open(path).unwrap());
+	y_test_assert(file.size() == sizeof(u32) + sizeof(u64) + values.size() * sizeof(u32));
+	y_test_assert(file.remaining() == file.size());
+
+	y_test_assert(file.read_one<u32>().unwrap() == 0xCAFE);
+	y_test_assert(file.read_one<u64>().unwrap() == values.size());
+
+	auto view = file.read_view(values.size() * sizeof(u32), alignof(u32)).unwrap();
+	y_test_assert(view.data() == file.data().data() + sizeof(u32) + sizeof(u64));
+	y_test_assert(std::equal(values.begin(), values.end(), reinterpret_cast<const u32*>(view.data())));
+	y_test_assert(file.at_end());
+	y_test_assert(!file.read_view(1, 1));
+
+	file.seek(1);
+	y_test_assert(!file.read_view(sizeof(u32), alignof(u32)));
+	y_test_assert(file.remaining() == file.size() - 1);
+}
+
+y_test_func("serde array_view") {
+	const core::Vector<u32> values = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	const core::String path = write_test_file(values);
+
+	{
+		io2::MappedFile file = std::move(io2::MappedFile::open(path).unwrap());
+		Arrays arrays;
+		ReadableArchive ar(file);
+		ar(arrays).unwrap();
+		y_test_assert(arrays.storage.is_empty());
+		y_test_assert(arrays.view.data() == reinterpret_cast<const u32*>(file.data().data() + sizeof(u32) + sizeof(u64)));
+		y_test_assert(std::equal(values.begin(), values.end(), arrays.view.begin(), arrays.view.end()));
+	}
+
+	{
+		io2::File file = std::move(io2::File::open(path).unwrap());
+		Arrays arrays;
+		ReadableArchive ar(file);
+		ar(arrays).unwrap();
+		y_test_assert(arrays.view.data() == arrays.storage.data());
+		y_test_assert(std::equal(values.begin(), values.end(), arrays.view.begin(), arrays.view.end()));
+	}
+}
+
+}
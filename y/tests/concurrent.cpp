@@ -0,0 +1,85 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+#include <y/concurrent/concurrent.h>
+
+#include <numeric>
+#include <random>
+
+namespace {
+
+using namespace y;
+
+y_test_func("parallel_for_each") {
+	core::Vector<u32> values(usize(10000), 0u);
+	concurrent::parallel_for_each(values.begin(), values.end(), [](u32& v) { v = 1; });
+	y_test_assert(std::accumulate(values.begin(), values.end(), usize(0)) == values.size());
+}
+
+y_test_func("parallel_block_collect") {
+	core::Vector<u32> values;
+	for(u32 i = 0; i != 10000; ++i) {
+		values << i;
+	}
+
+	auto evens = concurrent::parallel_collect(values.begin(), values.end(), [](auto&& range) {
+		core::Vector<u32> e;
+		for(u32 v : range) {
+			if(v % 2 == 0) {
+				e << v;
+			}
+		}
+		return e;
+	});
+
+	y_test_assert(evens.size() == values.size() / 2);
+	std::sort(evens.begin(), evens.end());
+	for(usize i = 0; i != evens.size(); ++i) {
+		y_test_assert(evens[i] == i * 2);
+	}
+}
+
+y_test_func("parallel_for_each small") {
+	core::Vector<u32> values(usize(1), 0u);
+	concurrent::parallel_for_each(values.begin(), values.end(), [](u32& v) { v = 7; });
+	y_test_assert(values[0] == 7);
+	core::Vector<u32> empty;
+	concurrent::parallel_for_each(empty.begin(), empty.end(), [](u32&) {});
+}
+
+y_test_func("parallel_radix_sort") {
+	std::mt19937_64 rng(7);
+	core::Vector<std::pair<u64, u32>> values;
+	for(u32 i = 0; i != 100000; ++i) {
+		// few distinct keys to check stability
+		values << std::pair<u64, u32>(rng() % 1024 + (u64(rng() % 3) << 56), i);
+	}
+
+	core::Vector<std::pair<u64, u32>> sorted = values;
+	concurrent::parallel_radix_sort(sorted.begin(), sorted.end(), [](const auto& p) { return p.first; });
+
+	std::stable_sort(values.begin(), values.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	y_test_assert(std::equal(values.begin(), values.end(), sorted.begin(), sorted.end()));
+}
+
+}
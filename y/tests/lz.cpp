@@ -0,0 +1,142 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/io2/lz.h>
+#include <y/io2/CompressedWriter.h>
+#include <y/io2/DecompressedReader.h>
+#include <y/io2/Buffer.h>
+#include <y/core/Vector.h>
+
+#include <y/test/test.h>
+
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::io2;
+
+static core::Vector<u8> test_data(usize size, u32 seed) {
+	std::mt19937 gen(seed);
+	core::Vector<u8> data;
+	while(data.size() < size) {
+		// mix of repeated runs, short periodic patterns and noise
+		const usize len = std::min(size - data.size(), usize(gen() % 300 + 1));
+		switch(gen() % 3) {
+			case 0:
+				std::fill_n(std::back_inserter(data), len, u8(gen()));
+			break;
+
+			case 1: {
+				const usize period = gen() % 7 + 1;
+				const usize start = data.size();
+				for(usize i = 0; i != len; ++i) {
+					data << u8(i < period || start < period ? gen() : data[data.size() - period]);
+				}
+			} break;
+
+			default:
+				for(usize i = 0; i != len; ++i) {
+					data << u8(gen());
+				}
+		}
+	}
+	return data;
+}
+
+static bool round_trip(const core::Vector<u8>& data) {
+	core::Vector<u8> compressed(lz::max_compressed_size(data.size()), u8(0));
+	const usize size = lz::compress(data.data(), data.size(), compressed.data());
+	if(size > compressed.size()) {
+		return false;
+	}
+
+	core::Vector<u8> decompressed(data.size(), u8(0));
+	return lz::decompress(compressed.data(), size, decompressed.data(), decompressed.size()) &&
+		   std::equal(data.begin(), data.end(), decompressed.begin(), decompressed.end());
+}
+
+y_test_func("lz round trip") {
+	y_test_assert(round_trip({}));
+	y_test_assert(round_trip({7}));
+	y_test_assert(round_trip({1, 2, 3, 4}));
+	y_test_assert(round_trip(core::Vector<u8>(100000, u8(9))));
+	for(u32 i = 0; i != 16; ++i) {
+		y_test_assert(round_trip(test_data(i * 1000 + 17, i)));
+	}
+	y_test_assert(round_trip(test_data(3 * 1024 * 1024, 99)));
+}
+
+y_test_func("lz corrupted data") {
+	const core::Vector<u8> data = test_data(64 * 1024, 7);
+	core::Vector<u8> compressed(lz::max_compressed_size(data.size()), u8(0));
+	const usize size = lz::compress(data.data(), data.size(), compressed.data());
+	y_test_assert(size < data.size());
+
+	core::Vector<u8> decompressed(data.size(), u8(0));
+	y_test_assert(!lz::decompress(compressed.data(), size - 1, decompressed.data(), decompressed.size()));
+	y_test_assert(!lz::decompress(compressed.data(), size, decompressed.data(), decompressed.size() - 1));
+
+	std::mt19937 gen(3);
+	for(usize i = 0; i != 1000; ++i) {
+		core::Vector<u8> corrupted = compressed;
+		corrupted[gen() % size] ^= u8(gen() | 1);
+		// must not crash, may or may not detect it
+		lz::decompress(corrupted.data(), size, decompressed.data(), decompressed.size());
+	}
+}
+
+y_test_func("lz compressed stream") {
+	const core::Vector<u8> data = test_data(1024 * 1024 + 321, 12);
+
+	Buffer buffer;
+	{
+		CompressedWriter writer(buffer, 64 * 1024);
+		// uneven writes to go through partial and whole blocks
+		usize offset = 0;
+		for(usize len : {usize(17), usize(64 * 1024), usize(300 * 1024), usize(5)}) {
+			writer.write(data.data() + offset, len).unwrap();
+			offset += len;
+		}
+		writer.flush().unwrap();
+		writer.write(data.data() + offset, data.size() - offset).unwrap();
+		writer.finish().unwrap();
+	}
+	buffer.write_one(u32(0xBEEF)).unwrap();
+	y_test_assert(buffer.remaining() < data.size());
+
+	DecompressedReader reader(buffer);
+	y_test_assert(reader.is_valid());
+	y_test_assert(reader.size() == data.size());
+	y_test_assert(buffer.read_one<u32>().unwrap() == 0xBEEF);
+
+	core::Vector<u8> decompressed(data.size(), u8(0));
+	usize offset = 0;
+	for(usize len : {usize(1), usize(100), usize(64 * 1024), usize(500 * 1024)}) {
+		reader.read(decompressed.data() + offset, len).unwrap();
+		offset += len;
+	}
+	reader.read(decompressed.data() + offset, data.size() - offset).unwrap();
+	y_test_assert(reader.at_end());
+	y_test_assert(!reader.read(decompressed.data(), 1));
+	y_test_assert(std::equal(data.begin(), data.end(), decompressed.begin(), decompressed.end()));
+}
+
+}
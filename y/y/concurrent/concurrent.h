@@ -25,6 +25,8 @@ SOFTWARE.
 #include "StaticThreadPool.h"
 
 #include <future>
+#include <memory>
+#include <array>
 
 namespace y {
 namespace concurrent {
@@ -36,13 +38,40 @@ namespace detail {
 usize probable_block_count();
 usize probable_block_count(usize size);
 
+// The calling thread only ever runs chunks of this call: helping with unrelated tasks from the pool
+// could make it pick up work that waits on something this thread is in the middle of (and deadlock).
+// Chunks are claimed from a shared counter so helpers that start late find nothing left and return.
 template<typename F>
 void schedule_n(F&& f, usize n) {
+	struct State {
+		std::atomic<usize> next = 0;
+		std::atomic<usize> done = 0;
+	};
+
+	if(!n) {
+		return;
+	}
+
 	StaticThreadPool& pool = default_thread_pool();
-	for(usize i = 0; i != n; ++i) {
-		pool.schedule([=] { f(i); });
+	const auto state = std::make_shared<State>();
+	const auto run_chunks = [n, func = &f](State& st) {
+		for(usize i = st.next++; i < n; i = st.next++) {
+			(*func)(i);
+			++st.done;
+		}
+	};
+
+	const usize helpers = std::min(n, std::max(usize(1), pool.concurency())) - 1;
+	for(usize i = 0; i != helpers; ++i) {
+		pool.schedule([=] { run_chunks(*state); });
+	}
+
+	run_chunks(*state);
+
+	// chunks picked up by workers might still be running
+	while(state->done != n) {
+		std::this_thread::yield();
 	}
-	pool.process_until_empty();
 }
 
 }
@@ -50,14 +79,15 @@ void schedule_n(F&& f, usize n) {
 template<typename F>
 auto async(F&& func) {
 	using ret_t = decltype(func());
-	std::promise<ret_t> promise;
-	std::future<ret_t> future = promise.get_future();
-	default_thread_pool().schedule([p = std::move(promise), f = y_fwd(func)]() mutable {
+	// tasks have to be const callable, so their state is shared instead of captured by a mutable lambda
+	auto promise = std::make_shared<std::promise<ret_t>>();
+	std::future<ret_t> future = promise->get_future();
+	default_thread_pool().schedule([promise, f = std::make_shared<std::decay_t<F>>(y_fwd(func))] {
 			if constexpr(std::is_void_v<ret_t>) {
-				f();
-				p.set_value();
+				(*f)();
+				promise->set_value();
 			} else {
-				p.set_value(f());
+				promise->set_value((*f)());
 			}
 		});
 	return future;
@@ -67,12 +97,12 @@ auto async(F&& func) {
 template<typename It, typename Func>
 void parallel_indexed_block_for(It begin, It end, Func&& func) {
 	usize size = end - begin;
-	usize chunk = std::max(usize(1), size / (detail::probable_block_count(size) - 1));
-
 	if(!size) {
 		return;
 	}
 
+	usize chunk = std::max(usize(1), size / std::max(usize(1), detail::probable_block_count(size) - 1));
+
 	usize chunk_count = size / chunk;
 	chunk_count += chunk_count * chunk != size;
 
@@ -118,7 +148,7 @@ auto parallel_block_collect(It begin, It end, Func&& func) {
 	std::mutex mutex;
 
 	C<T> col;
-	try_reserve(col, probable_block_count(std::distance(begin, end)));
+	try_reserve(col, detail::probable_block_count(std::distance(begin, end)));
 
 	parallel_indexed_block_for(begin, end, [&](usize, auto&& range) {
 		auto e = func(range);
@@ -149,6 +179,95 @@ auto parallel_collect(It begin, It end, Func&& func) {
 	return sum;
 }
 
+
+// Stable LSD radix sort on the u64 returned by key, 8 bits per pass.
+// Passes on bytes that are identical for every key are skipped.
+template<typename It, typename Key>
+void parallel_radix_sort(It begin, It end, Key&& key) {
+	using value_type = std::remove_reference_t<decltype(*begin)>;
+
+	static constexpr usize radix_bits = 8;
+	static constexpr usize bucket_count = usize(1) << radix_bits;
+	static constexpr u64 radix_mask = bucket_count - 1;
+
+	struct Item {
+		u64 key;
+		value_type value;
+	};
+
+	const usize size = end - begin;
+	if(size < 2) {
+		return;
+	}
+
+	const usize block_size = std::max(usize(1), size / detail::probable_block_count(size));
+	const usize block_count = (size + block_size - 1) / block_size;
+	auto block_range = [=](usize b) {
+		return std::pair<usize, usize>(b * block_size, std::min(size, (b + 1) * block_size));
+	};
+
+	core::Vector<Item> items(size, Item{});
+	core::Vector<Item> buffer(size, Item{});
+
+	const u64 first_key = key(*begin);
+	std::atomic<u64> diff_bits = 0;
+	detail::schedule_n([&](usize b) {
+		u64 diff = 0;
+		const auto [first, last] = block_range(b);
+		for(usize i = first; i != last; ++i) {
+			items[i].key = key(begin[i]);
+			items[i].value = std::move(begin[i]);
+			diff |= items[i].key ^ first_key;
+		}
+		diff_bits.fetch_or(diff);
+	}, block_count);
+
+	core::Vector<std::array<usize, bucket_count>> histograms(block_count, std::array<usize, bucket_count>{});
+
+	Item* src = items.data();
+	Item* dst = buffer.data();
+	for(usize shift = 0; shift < 64; shift += radix_bits) {
+		if(!((diff_bits >> shift) & radix_mask)) {
+			continue;
+		}
+
+		detail::schedule_n([&](usize b) {
+			auto& histogram = histograms[b];
+			histogram.fill(0);
+			const auto [first, last] = block_range(b);
+			for(usize i = first; i != last; ++i) {
+				++histogram[(src[i].key >> shift) & radix_mask];
+			}
+		}, block_count);
+
+		usize offset = 0;
+		for(usize digit = 0; digit != bucket_count; ++digit) {
+			for(auto& histogram : histograms) {
+				const usize count = histogram[digit];
+				histogram[digit] = offset;
+				offset += count;
+			}
+		}
+
+		detail::schedule_n([&](usize b) {
+			auto& histogram = histograms[b];
+			const auto [first, last] = block_range(b);
+			for(usize i = first; i != last; ++i) {
+				dst[histogram[(src[i].key >> shift) & radix_mask]++] = std::move(src[i]);
+			}
+		}, block_count);
+
+		std::swap(src, dst);
+	}
+
+	detail::schedule_n([&](usize b) {
+		const auto [first, last] = block_range(b);
+		for(usize i = first; i != last; ++i) {
+			begin[i] = std::move(src[i].value);
+		}
+	}, block_count);
+}
+
 }
 }
 
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "ArrayView.h"
 #include <cstring>
+#include <memory>
 
 namespace y {
 namespace core {
@@ -76,7 +77,8 @@ class Vector : ResizePolicy, Allocator {
 
 		Vector(usize size, const value_type& elem) {
 			set_min_capacity(size);
-			std::fill_n(std::back_inserter(*this), size, elem);
+			std::uninitialized_fill_n(_data_end, size, elem);
+			_data_end += size;
 		}
 
 		template<typename It>
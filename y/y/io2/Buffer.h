@@ -33,6 +33,9 @@ class Buffer final : public Reader, public Writer {
 			_buffer.set_min_capacity(size);
 		}
 
+		Buffer(core::Vector<u8>&& data) : _buffer(std::move(data)) {
+		}
+
 		bool at_end() const override {
 			return _read_cursor >= _buffer.size();
 		}
@@ -65,6 +68,11 @@ class Buffer final : public Reader, public Writer {
 			return core::Ok(r);
 		}
 
+		// Reads from the start of the buffer again
+		void rewind() {
+			_read_cursor = 0;
+		}
+
 		WriteResult write(const u8* data, usize bytes) override {
 			_buffer.push_back(data, data + bytes);
 			return core::Ok();
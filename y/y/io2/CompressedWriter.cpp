@@ -0,0 +1,137 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "CompressedWriter.h"
+#include "lz.h"
+
+#include <y/concurrent/concurrent.h>
+
+namespace y {
+namespace io2 {
+
+struct CompressedBlock {
+	std::unique_ptr<u8[]> buffer;
+	usize size = 0;
+	usize stored = 0;
+};
+
+static void compress_block(const u8* data, usize size, CompressedBlock& block) {
+	// not value initialized: zeroing the buffer is a noticeable part of the cost of compression
+	block.buffer = std::unique_ptr<u8[]>(new u8[lz::max_compressed_size(size)]);
+	block.size = size;
+	block.stored = lz::compress(data, size, block.buffer.get());
+	if(block.stored >= size) {
+		// stored as is
+		block.buffer = nullptr;
+		block.stored = size;
+	}
+}
+
+
+CompressedWriter::CompressedWriter(Writer& dst, usize block_size) : _dst(dst), _block_size(block_size) {
+	y_debug_assert(block_size && block_size <= u32(-1));
+}
+
+CompressedWriter::~CompressedWriter() {
+	if(!_finished) {
+		finish().ignore();
+	}
+}
+
+WriteResult CompressedWriter::write(const u8* data, usize bytes) {
+	y_debug_assert(!_finished);
+
+	if(!_pending.is_empty() || bytes < _block_size) {
+		const usize len = std::min(bytes, _block_size - _pending.size());
+		_pending.push_back(data, data + len);
+		data += len;
+		bytes -= len;
+
+		if(_pending.size() == _block_size) {
+			if(!write_blocks(_pending.data(), _pending.size())) {
+				return core::Err<usize>(0);
+			}
+			_pending.make_empty();
+		}
+	}
+
+	const usize full = bytes - bytes % _block_size;
+	if(full && !write_blocks(data, full)) {
+		return core::Err<usize>(0);
+	}
+
+	_pending.push_back(data + full, data + bytes);
+	return core::Ok();
+}
+
+WriteResult CompressedWriter::write_blocks(const u8* data, usize bytes) {
+	const usize block_count = (bytes + _block_size - 1) / _block_size;
+
+	auto blocks = std::make_unique<CompressedBlock[]>(block_count);
+	auto compress = [&](usize i) {
+		const usize offset = i * _block_size;
+		compress_block(data + offset, std::min(_block_size, bytes - offset), blocks[i]);
+	};
+
+	if(block_count > 1) {
+		concurrent::parallel_for(usize(0), block_count, compress);
+	} else if(block_count) {
+		compress(0);
+	}
+
+	for(usize i = 0; i != block_count; ++i) {
+		const CompressedBlock& block = blocks[i];
+		const u32 header[] = {u32(block.stored), u32(block.size)};
+		const u8* stored = block.buffer ? block.buffer.get() : data + i * _block_size;
+		if(!_dst.write_array(header, 2) || !_dst.write(stored, block.stored)) {
+			return core::Err<usize>(0);
+		}
+	}
+	return core::Ok();
+}
+
+FlushResult CompressedWriter::flush() {
+	y_debug_assert(!_finished);
+
+	if(!_pending.is_empty()) {
+		if(!write_blocks(_pending.data(), _pending.size())) {
+			return core::Err();
+		}
+		_pending.make_empty();
+	}
+	return _dst.flush();
+}
+
+FlushResult CompressedWriter::finish() {
+	if(!flush()) {
+		return core::Err();
+	}
+	_finished = true;
+
+	const u32 end[] = {0, 0};
+	if(!_dst.write_array(end, 2)) {
+		return core::Err();
+	}
+	return _dst.flush();
+}
+
+}
+}
@@ -0,0 +1,63 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_COMPRESSEDWRITER_H
+#define Y_IO2_COMPRESSEDWRITER_H
+
+#include "io.h"
+
+namespace y {
+namespace io2 {
+
+// Writes data as a sequence of independently compressed blocks (see lz.h), ended by an empty block.
+// Each block is prefixed by its stored and uncompressed sizes, blocks that do not compress are stored as is.
+// Large writes are compressed in parallel on the default thread pool.
+class CompressedWriter final : public Writer {
+	public:
+		static constexpr usize default_block_size = 256 * 1024;
+
+		CompressedWriter(Writer& dst, usize block_size = default_block_size);
+
+		// Finishes the stream if finish() has not been called
+		~CompressedWriter() override;
+
+		WriteResult write(const u8* data, usize bytes) override;
+
+		// Compresses the pending data as a (possibly smaller) block
+		FlushResult flush() override;
+
+		// Flushes and writes the end of the stream, nothing can be written afterward
+		FlushResult finish();
+
+	private:
+		WriteResult write_blocks(const u8* data, usize bytes);
+
+		Writer& _dst;
+		usize _block_size;
+
+		core::Vector<u8> _pending;
+		bool _finished = false;
+};
+
+}
+}
+
+#endif // Y_IO2_COMPRESSEDWRITER_H
@@ -0,0 +1,178 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "DecompressedReader.h"
+#include "lz.h"
+
+#include <y/concurrent/concurrent.h>
+
+#include <atomic>
+
+namespace y {
+namespace io2 {
+
+DecompressedReader::DecompressedReader(Reader& src) {
+	_valid = read_blocks(src);
+}
+
+DecompressedReader::DecompressedReader(ReaderPtr src) : _src(std::move(src)) {
+	_valid = _src && read_blocks(*_src);
+}
+
+bool DecompressedReader::read_blocks(Reader& src) {
+	for(;;) {
+		u32 header[2] = {};
+		if(!src.read_array(header, 2)) {
+			return false;
+		}
+
+		Block block;
+		block.offset = _size;
+		block.stored = header[0];
+		block.size = header[1];
+
+		if(!block.size) {
+			return !block.stored;
+		}
+		if(block.stored > block.size) {
+			return false;
+		}
+
+		if(auto view = src.read_view(block.stored, 1)) {
+			block.data = view.unwrap().data();
+		} else {
+			core::Vector<u8>& owned = _owned.emplace_back(block.stored, u8(0));
+			if(!src.read(owned.data(), block.stored)) {
+				return false;
+			}
+			block.data = owned.data();
+		}
+
+		_size += block.size;
+		_blocks << block;
+	}
+}
+
+bool DecompressedReader::is_valid() const {
+	return _valid;
+}
+
+usize DecompressedReader::size() const {
+	return _size;
+}
+
+usize DecompressedReader::remaining() const {
+	return _size - _cursor;
+}
+
+bool DecompressedReader::at_end() const {
+	return !remaining();
+}
+
+usize DecompressedReader::block_index(usize offset) const {
+	auto it = std::upper_bound(_blocks.begin(), _blocks.end(), offset, [](usize o, const Block& b) { return o < b.offset; });
+	return usize(it - _blocks.begin()) - 1;
+}
+
+bool DecompressedReader::decode(const Block& block, u8* dst) const {
+	if(block.stored == block.size) {
+		std::copy_n(block.data, block.size, dst);
+		return true;
+	}
+	return lz::decompress(block.data, block.stored, dst, block.size);
+}
+
+ReadResult DecompressedReader::read(u8* data, usize bytes) {
+	if(!_valid || remaining() < bytes) {
+		return core::Err<usize>(0);
+	}
+
+	const usize end = _cursor + bytes;
+	while(_cursor != end) {
+		const usize first = block_index(_cursor);
+
+		// whole blocks are decoded straight into data
+		usize last = first;
+		while(last != _blocks.size() && _blocks[last].offset >= _cursor && _blocks[last].offset + _blocks[last].size <= end) {
+			++last;
+		}
+
+		if(last != first) {
+			u8* dst = data + (_blocks[first].offset - (end - bytes));
+			std::atomic<bool> ok = true;
+			auto decode_block = [&](usize i) {
+				if(!decode(_blocks[i], dst + (_blocks[i].offset - _blocks[first].offset))) {
+					ok = false;
+				}
+			};
+
+			if(last - first > 1) {
+				concurrent::parallel_for(first, last, decode_block);
+			} else {
+				decode_block(first);
+			}
+
+			if(!ok) {
+				return core::Err(_cursor - (end - bytes));
+			}
+			_cursor = _blocks[last - 1].offset + _blocks[last - 1].size;
+			continue;
+		}
+
+		// partial block, goes through the cache
+		const Block& block = _blocks[first];
+		if(_cached_block != first) {
+			_cache.make_empty();
+			std::fill_n(std::back_inserter(_cache), block.size, 0);
+			if(!decode(block, _cache.data())) {
+				_cached_block = usize(-1);
+				return core::Err(_cursor - (end - bytes));
+			}
+			_cached_block = first;
+		}
+
+		const usize offset = _cursor - block.offset;
+		const usize len = std::min(block.size - offset, end - _cursor);
+		std::copy_n(_cache.data() + offset, len, data + (_cursor - (end - bytes)));
+		_cursor += len;
+	}
+
+	return core::Ok();
+}
+
+ReadUpToResult DecompressedReader::read_up_to(u8* data, usize max_bytes) {
+	const usize len = std::min(max_bytes, remaining());
+	if(!read(data, len)) {
+		return core::Err<usize>(0);
+	}
+	return core::Ok(len);
+}
+
+ReadUpToResult DecompressedReader::read_all(core::Vector<u8>& data) {
+	const usize len = remaining();
+	const usize size = data.size();
+	data.set_min_capacity(size + len);
+	std::fill_n(std::back_inserter(data), len, 0);
+	return read_up_to(data.begin() + size, len);
+}
+
+}
+}
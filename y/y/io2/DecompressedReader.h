@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_DECOMPRESSEDREADER_H
+#define Y_IO2_DECOMPRESSEDREADER_H
+
+#include "io.h"
+
+namespace y {
+namespace io2 {
+
+// Reads a stream written by CompressedWriter.
+// The whole compressed stream is pulled from the source on construction (borrowed when the source supports read_view),
+// blocks are then decoded when read, straight into the destination and in parallel for large reads.
+class DecompressedReader final : public Reader {
+	public:
+		DecompressedReader(Reader& src);
+
+		// Keeps the source alive, for sources that data is borrowed from
+		DecompressedReader(ReaderPtr src);
+
+		// False if the compressed stream could not be read
+		bool is_valid() const;
+
+		usize size() const;
+		usize remaining() const;
+
+		bool at_end() const override;
+
+		ReadResult read(u8* data, usize bytes) override;
+		ReadUpToResult read_up_to(u8* data, usize max_bytes) override;
+		ReadUpToResult read_all(core::Vector<u8>& data) override;
+
+	private:
+		struct Block {
+			usize offset = 0;
+			usize size = 0;
+			usize stored = 0;
+			const u8* data = nullptr;
+		};
+
+		bool read_blocks(Reader& src);
+
+		usize block_index(usize offset) const;
+		bool decode(const Block& block, u8* dst) const;
+
+		ReaderPtr _src;
+
+		core::Vector<Block> _blocks;
+		core::Vector<core::Vector<u8>> _owned;
+
+		core::Vector<u8> _cache;
+		usize _cached_block = usize(-1);
+
+		usize _size = 0;
+		usize _cursor = 0;
+		bool _valid = false;
+};
+
+}
+}
+
+#endif // Y_IO2_DECOMPRESSEDREADER_H
@@ -0,0 +1,189 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "MappedFile.h"
+
+#ifdef Y_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace y {
+namespace io2 {
+
+#ifdef Y_OS_WIN
+static const u8* map_file(const core::String& name, usize& size) {
+	HANDLE file = CreateFileA(name.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(file == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+
+	const u8* data = nullptr;
+	LARGE_INTEGER file_size = {};
+	if(GetFileSizeEx(file, &file_size)) {
+		size = usize(file_size.QuadPart);
+		if(!size) {
+			// empty files can not be mapped
+			static const u8 empty = 0;
+			data = &empty;
+		} else if(HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+			// the view keeps the mapping alive
+			data = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+	return data;
+}
+
+static void unmap_file(const u8* data, usize size) {
+	if(size) {
+		UnmapViewOfFile(data);
+	}
+}
+#else
+static const u8* map_file(const core::String& name, usize& size) {
+	int fd = ::open(name.data(), O_RDONLY);
+	if(fd < 0) {
+		return nullptr;
+	}
+
+	const u8* data = nullptr;
+	struct stat st = {};
+	if(!::fstat(fd, &st)) {
+		size = usize(st.st_size);
+		if(!size) {
+			// empty files can not be mapped
+			static const u8 empty = 0;
+			data = &empty;
+		} else if(void* ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); ptr != MAP_FAILED) {
+			// start paging the file in now, we are going to read all of it anyway
+			::madvise(ptr, size, MADV_WILLNEED);
+			data = static_cast<const u8*>(ptr);
+		}
+	}
+	// the mapping keeps the file alive
+	::close(fd);
+	return data;
+}
+
+static void unmap_file(const u8* data, usize size) {
+	if(size) {
+		::munmap(const_cast<u8*>(data), size);
+	}
+}
+#endif
+
+
+MappedFile::MappedFile(const u8* data, usize size) : _data(data), _size(size) {
+}
+
+MappedFile::~MappedFile() {
+	if(_data) {
+		unmap_file(_data, _size);
+	}
+}
+
+MappedFile::MappedFile(MappedFile&& other) {
+	swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+	swap(other);
+	return *this;
+}
+
+void MappedFile::swap(MappedFile& other) {
+	std::swap(_data, other._data);
+	std::swap(_size, other._size);
+	std::swap(_cursor, other._cursor);
+}
+
+core::Result<MappedFile> MappedFile::open(const core::String& name) {
+	usize size = 0;
+	if(const u8* data = map_file(name, size)) {
+		return core::Ok(MappedFile(data, size));
+	}
+	return core::Err();
+}
+
+usize MappedFile::size() const {
+	return _size;
+}
+
+usize MappedFile::remaining() const {
+	return _size - _cursor;
+}
+
+bool MappedFile::is_open() const {
+	return _data;
+}
+
+bool MappedFile::at_end() const {
+	return !remaining();
+}
+
+void MappedFile::seek(usize byte) {
+	_cursor = std::min(byte, _size);
+}
+
+core::Span<u8> MappedFile::data() const {
+	return core::Span<u8>(_data, _size);
+}
+
+ReadResult MappedFile::read(u8* data, usize bytes) {
+	if(remaining() < bytes) {
+		return core::Err<usize>(0);
+	}
+	std::copy_n(_data + _cursor, bytes, data);
+	_cursor += bytes;
+	return core::Ok();
+}
+
+ReadUpToResult MappedFile::read_up_to(u8* data, usize max_bytes) {
+	usize max = std::min(max_bytes, remaining());
+	std::copy_n(_data + _cursor, max, data);
+	_cursor += max;
+	return core::Ok(max);
+}
+
+ReadUpToResult MappedFile::read_all(core::Vector<u8>& data) {
+	usize r = remaining();
+	data.push_back(_data + _cursor, _data + _size);
+	_cursor = _size;
+	return core::Ok(r);
+}
+
+ReadViewResult MappedFile::read_view(usize bytes, usize alignment) {
+	const u8* start = _data + _cursor;
+	if(remaining() < bytes || reinterpret_cast<uintptr_t>(start) % alignment) {
+		return core::Err<usize>(0);
+	}
+	_cursor += bytes;
+	return core::Ok(core::Span<u8>(start, bytes));
+}
+
+}
+}
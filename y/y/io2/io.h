@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <memory>
 #include <y/core/Vector.h>
+#include <y/core/Span.h>
 #include <y/core/Result.h>
 
 namespace y {
@@ -36,6 +37,7 @@ namespace io2 {
 
 using ReadUpToResult = core::Result<usize, usize>;
 using ReadResult = core::Result<void, usize>;
+using ReadViewResult = core::Result<core::Span<u8>, usize>;
 using WriteResult = core::Result<void, usize>;
 using FlushResult = core::Result<void>;
 
@@ -49,6 +51,13 @@ class Reader : NonCopyable {
 		virtual ReadUpToResult read_up_to(u8* data, usize max_bytes) = 0;
 		virtual ReadUpToResult read_all(core::Vector<u8>& data) = 0;
 
+		// Returns a view of the next bytes instead of copying them, for readers backed by memory (like MappedFile). The view is valid as long as the reader.
+		// Fails without consuming anything if the view would not be aligned on alignment.
+		virtual ReadViewResult read_view(usize bytes, usize alignment) {
+			unused(bytes, alignment);
+			return core::Err<usize>(0);
+		}
+
 
 		template<typename T>
 		ReadResult read_one(T& t) {
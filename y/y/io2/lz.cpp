@@ -0,0 +1,190 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "lz.h"
+
+#include <cstring>
+
+namespace y {
+namespace io2 {
+namespace lz {
+
+static constexpr usize min_match = 4;
+static constexpr usize max_offset = 0xFFFF;
+
+static constexpr usize hash_bits = 14;
+static constexpr usize hash_size = usize(1) << hash_bits;
+
+static constexpr u32 invalid_pos = u32(-1);
+
+
+static u32 load_u32(const u8* p) {
+	u32 v = 0;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static u32 hash(u32 seq) {
+	return (seq * 2654435761u) >> (32 - hash_bits);
+}
+
+static u8* write_length(u8* op, usize len) {
+	for(; len >= 255; len -= 255) {
+		*op++ = 255;
+	}
+	*op++ = u8(len);
+	return op;
+}
+
+static bool read_length(const u8*& ip, const u8* end, usize& len) {
+	u8 b = 255;
+	while(b == 255) {
+		if(ip == end) {
+			return false;
+		}
+		b = *ip++;
+		len += b;
+	}
+	return true;
+}
+
+static u8* write_sequence(u8* op, const u8* literals, usize literal_len, usize offset, usize match_len) {
+	const usize ml = match_len ? match_len - min_match : 0;
+	u8* token = op++;
+	*token = u8((std::min(literal_len, usize(15)) << 4) | std::min(ml, usize(15)));
+
+	if(literal_len >= 15) {
+		op = write_length(op, literal_len - 15);
+	}
+	std::copy_n(literals, literal_len, op);
+	op += literal_len;
+
+	if(match_len) {
+		*op++ = u8(offset);
+		*op++ = u8(offset >> 8);
+		if(ml >= 15) {
+			op = write_length(op, ml - 15);
+		}
+	}
+	return op;
+}
+
+
+
+usize max_compressed_size(usize size) {
+	// worst case: a single literal run
+	return size + size / 255 + 16;
+}
+
+usize compress(const u8* src, usize size, u8* dst) {
+	u32 table[hash_size];
+	std::fill_n(table, hash_size, invalid_pos);
+
+	u8* op = dst;
+	usize anchor = 0;
+	usize pos = 0;
+
+	while(pos + min_match <= size) {
+		const u32 seq = load_u32(src + pos);
+		u32& slot = table[hash(seq)];
+		const usize candidate = slot;
+		slot = u32(pos);
+
+		if(candidate == invalid_pos || pos - candidate > max_offset || load_u32(src + candidate) != seq) {
+			// skip faster through data that does not compress
+			pos += 1 + ((pos - anchor) >> 6);
+			continue;
+		}
+
+		usize len = min_match;
+		while(pos + len < size && src[candidate + len] == src[pos + len]) {
+			++len;
+		}
+
+		op = write_sequence(op, src + anchor, pos - anchor, pos - candidate, len);
+		pos += len;
+		anchor = pos;
+	}
+
+	return usize(write_sequence(op, src + anchor, size - anchor, 0, 0) - dst);
+}
+
+bool decompress(const u8* src, usize src_size, u8* dst, usize dst_size) {
+	const u8* ip = src;
+	const u8* ip_end = src + src_size;
+	u8* op = dst;
+	u8* op_end = dst + dst_size;
+
+	for(;;) {
+		if(ip == ip_end) {
+			// the last sequence is missing
+			return false;
+		}
+
+		const u8 token = *ip++;
+
+		usize literal_len = token >> 4;
+		if(literal_len == 15 && !read_length(ip, ip_end, literal_len)) {
+			return false;
+		}
+		if(usize(ip_end - ip) < literal_len || usize(op_end - op) < literal_len) {
+			return false;
+		}
+		std::copy_n(ip, literal_len, op);
+		ip += literal_len;
+		op += literal_len;
+
+		// last sequence
+		if(ip == ip_end) {
+			return op == op_end;
+		}
+
+		if(ip_end - ip < 2) {
+			return false;
+		}
+		const usize offset = usize(ip[0]) | (usize(ip[1]) << 8);
+		ip += 2;
+
+		usize match_len = token & 0x0F;
+		if(match_len == 15 && !read_length(ip, ip_end, match_len)) {
+			return false;
+		}
+		match_len += min_match;
+
+		if(!offset || usize(op - dst) < offset || usize(op_end - op) < match_len) {
+			return false;
+		}
+
+		// overlapping matches repeat the last offset bytes, copy them one period at a time
+		const u8* match = op - offset;
+		while(match_len) {
+			const usize len = std::min(match_len, offset);
+			std::copy_n(match, len, op);
+			op += len;
+			match += len;
+			match_len -= len;
+		}
+	}
+}
+
+}
+}
+}
@@ -0,0 +1,47 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_LZ_H
+#define Y_IO2_LZ_H
+
+#include <y/utils.h>
+
+namespace y {
+namespace io2 {
+namespace lz {
+
+// Byte oriented LZ77 codec (in the spirit of LZ4) used to compress independent blocks.
+// A block is a sequence of [token, literals, offset, match] where the token holds the literal and match lengths.
+// Matches are searched within the previous 64KB of the block, the last sequence only holds literals.
+
+usize max_compressed_size(usize size);
+
+// dst must hold at least max_compressed_size(size) bytes, returns the compressed size
+usize compress(const u8* src, usize size, u8* dst);
+
+// Fails if the data is corrupted or does not decompress to exactly dst_size bytes
+bool decompress(const u8* src, usize src_size, u8* dst, usize dst_size);
+
+}
+}
+}
+
+#endif // Y_IO2_LZ_H
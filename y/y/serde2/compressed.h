@@ -0,0 +1,111 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_SERDE2_COMPRESSED_H
+#define Y_SERDE2_COMPRESSED_H
+
+#include "serde.h"
+
+#include <y/io2/CompressedWriter.h>
+#include <y/io2/DecompressedReader.h>
+
+namespace y {
+namespace serde2 {
+
+namespace detail {
+
+template<typename T>
+class CompressedArray {
+	public:
+		CompressedArray(bool compress, usize s, const T* t) : _compress(compress), _s(s), _t(t) {
+		}
+
+		template<typename Arc>
+		Result serialize(Arc& ar) const {
+			if(!ar(u32(_compress ? 1 : 0))) {
+				return core::Err();
+			}
+			if(!_compress) {
+				return ar.array(_t, _s);
+			}
+
+			io2::CompressedWriter writer(ar.writer());
+			if(!writer.write_array(_t, _s) || !writer.finish()) {
+				return core::Err();
+			}
+			return core::Ok();
+		}
+
+	private:
+		bool _compress;
+		usize _s;
+		const T* _t;
+};
+
+template<typename T>
+class CompressedArrayView : public ArrayView<T> {
+	public:
+		using ArrayView<T>::ArrayView;
+
+		template<typename Arc>
+		Result deserialize(Arc& ar) {
+			usize size = 0;
+			u32 compressed = 0;
+			if(!this->deserialize_size(ar, size) || !ar(compressed)) {
+				return core::Err();
+			}
+
+			if(!compressed) {
+				return this->deserialize_array(ar, size);
+			}
+
+			io2::DecompressedReader reader(ar.reader());
+			if(!reader.is_valid() || reader.size() != size * sizeof(T)) {
+				return core::Err();
+			}
+			return reader.read_array(this->resize_storage(size), size);
+		}
+};
+
+}
+
+// Writes the array as a compressed stream (see io2::CompressedWriter) if compress is set, as is otherwise
+template<typename T>
+detail::CompressedArray<T> compressed_array(bool compress, usize s, const T* t) {
+	return detail::CompressedArray<T>(compress, s, t);
+}
+
+// Reads arrays written by compressed_array: compressed arrays are decompressed into storage, others are read as array_view
+template<typename T>
+detail::CompressedArrayView<T> compressed_array_view(usize s, core::Span<T>& view, core::Vector<T>& storage) {
+	return detail::CompressedArrayView<T>(s, false, view, storage);
+}
+
+// Same as above, for arrays prefixed by their u64 size
+template<typename T>
+detail::CompressedArrayView<T> compressed_array_view(core::Span<T>& view, core::Vector<T>& storage) {
+	return detail::CompressedArrayView<T>(0, true, view, storage);
+}
+
+}
+}
+
+#endif // Y_SERDE2_COMPRESSED_H
@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include <y/core/Result.h>
 #include <y/core/Functor.h>
+#include <y/core/Vector.h>
+#include <y/core/Span.h>
 #include <y/utils/recmacros.h>
 
 #include "archives.h"
@@ -207,6 +209,63 @@ class Array {
 		T* _t;
 };
 
+template<typename T>
+class ArrayView {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	public:
+		ArrayView(usize s, bool sized, core::Span<T>& view, core::Vector<T>& storage) :
+				_s(s), _sized(sized), _view(view), _storage(storage) {
+		}
+
+		template<typename Arc>
+		Result deserialize(Arc& ar) {
+			usize size = 0;
+			if(!deserialize_size(ar, size)) {
+				return core::Err();
+			}
+			return deserialize_array(ar, size);
+		}
+
+	protected:
+		template<typename Arc>
+		Result deserialize_size(Arc& ar, usize& size) {
+			size = _s;
+			if(_sized) {
+				u64 s = 0;
+				if(!ar(s)) {
+					return core::Err();
+				}
+				size = s;
+			}
+			return core::Ok();
+		}
+
+		template<typename Arc>
+		Result deserialize_array(Arc& ar, usize size) {
+			if(auto v = ar.reader().read_view(size * sizeof(T), alignof(T))) {
+				_storage.make_empty();
+				_view = core::Span<T>(reinterpret_cast<const T*>(v.unwrap().data()), size);
+				return core::Ok();
+			}
+
+			resize_storage(size);
+			return ar.array(_storage.data(), size);
+		}
+
+		T* resize_storage(usize size) {
+			_storage = core::Vector<T>(size, T{});
+			_view = _storage;
+			return _storage.data();
+		}
+
+	private:
+		usize _s = 0;
+		bool _sized;
+		core::Span<T>& _view;
+		core::Vector<T>& _storage;
+};
+
 }
 
 template<typename... Args>
@@ -229,8 +288,18 @@ detail::Array<T> array(usize s, T* t) {
 	return detail::Array<T>(s, t);
 }
 
+// Borrows the array straight from the reader if it supports views (see io2::Reader::read_view), and copies it into storage otherwise.
+// Borrowed data is only valid as long as the reader.
+template<typename T>
+detail::ArrayView<T> array_view(usize s, core::Span<T>& view, core::Vector<T>& storage) {
+	return detail::ArrayView<T>(s, false, view, storage);
+}
 
-
+// Same as above, for arrays serialized as core::Vector
+template<typename T>
+detail::ArrayView<T> array_view(core::Span<T>& view, core::Vector<T>& storage) {
+	return detail::ArrayView<T>(0, true, view, storage);
+}
 
 // -------------------------------------- tests --------------------------------------
 namespace {
@@ -88,7 +88,7 @@ static thread_local struct ThreadData : NonMovable {
 		write(b, len);
 		write_buffer();
 		std::unique_lock lock(mutex);
-		if(thread_output->is_open()) {
+		if(thread_output && thread_output->is_open()) {
 			thread_output->flush().ignore();
 		}
 	}
@@ -105,7 +105,8 @@ static thread_local struct ThreadData : NonMovable {
 	void write_buffer() {
 		std::unique_lock lock(mutex);
 		try {
-			if(thread_output->is_open() && buffer) {
+			// threads started during static initialization might not have an output
+			if(thread_output && thread_output->is_open() && buffer) {
 				if(!initialized) {
 					initialized = true;
 					const char beg[] = R"({"traceEvents":[)";
@@ -114,6 +115,9 @@ static thread_local struct ThreadData : NonMovable {
 				thread_output->write(reinterpret_cast<const u8*>(buffer.get()), buffer_offset).ignore();
 				buffer_offset = 0;
 				event("perf", "done writing buffer");
+			} else {
+				// without an output events are dropped, the buffer would overflow otherwise
+				buffer_offset = 0;
 			}
 		} catch(...) {
 		}
@@ -29,6 +29,23 @@ namespace yave {
 AssetLoader::AssetLoader(DevicePtr dptr, const std::shared_ptr<AssetStore>& store) : DeviceLinked(dptr), _store(store) {
 }
 
+AssetLoader::AssetLoader(const std::shared_ptr<AssetStore>& store) : _store(store) {
+}
+
+AssetLoader::~AssetLoader() {
+	// pending loads might need to load their dependencies, so we can't hold the lock while waiting
+	core::Vector<LoaderBase*> loaders;
+	{
+		std::unique_lock lock(_lock);
+		for(auto& loader : _loaders) {
+			loaders << loader.second.get();
+		}
+	}
+	for(LoaderBase* loader : loaders) {
+		loader->wait_pending();
+	}
+}
+
 AssetStore& AssetLoader::store() {
 	return *_store;
 }
@@ -47,6 +64,25 @@ bool AssetLoader::forget(AssetId id) {
 	return false;
 }
 
+bool AssetLoader::prefetch_recorded(core::Span<AssetDependency> dependencies, AssetPrefetch& prefetch) {
+	bool complete = true;
+	for(const AssetDependency& dep : dependencies) {
+		prefetch_f prefetcher = nullptr;
+		{
+			std::unique_lock lock(_lock);
+			if(auto it = _prefetchers.find(dep.type); it != _prefetchers.end()) {
+				prefetcher = it->second;
+			}
+		}
+		if(prefetcher) {
+			prefetcher(*this, dep.id, prefetch);
+		} else {
+			complete = false;
+		}
+	}
+	return complete;
+}
+
 core::Result<AssetId> AssetLoader::load_or_import(std::string_view name, std::string_view import_from) {
 	if(auto id = _store->id(name)) {
 		return id;
@@ -25,12 +25,17 @@ SOFTWARE.
 #include <yave/device/DeviceLinked.h>
 #include <yave/utils/serde.h>
 
+#include <y/concurrent/concurrent.h>
+#include <y/io2/Buffer.h>
+
 #include "AssetPtr.h"
 #include "AssetStore.h"
+#include "AssetPrefetch.h"
 
 #include <unordered_map>
 #include <typeindex>
 #include <mutex>
+#include <future>
 
 namespace yave {
 
@@ -46,6 +51,46 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 		template<typename T>
 		using Result = core::Result<AssetPtr<T>, ErrorType>;
 
+	private:
+		template<typename T>
+		struct LoadState {
+			AssetPtr<T> asset;
+			ErrorType error = ErrorType::Unknown;
+
+			Result<T> result() const {
+				if(asset) {
+					return core::Ok(asset);
+				}
+				return core::Err(error);
+			}
+		};
+
+	public:
+		template<typename T>
+		class AsyncResult {
+			public:
+				AsyncResult() = default;
+
+				AsyncResult(std::shared_future<LoadState<T>> state) : _state(std::move(state)) {
+				}
+
+				bool is_ready() const {
+					return _state.valid() && _state.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+				}
+
+				void wait() const {
+					_state.wait();
+				}
+
+				// Blocks until the asset is loaded
+				Result<T> get() const {
+					return _state.get().result();
+				}
+
+			private:
+				std::shared_future<LoadState<T>> _state;
+		};
+
 
 	private:
 		class LoaderBase : NonCopyable {
@@ -54,6 +99,7 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 				}
 
 				virtual bool forget(AssetId id) = 0;
+				virtual void wait_pending() = 0;
 		};
 
 		template<typename T>
@@ -76,6 +122,8 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 					return core::Ok(asset_ptr);
 				}
 
+				// The lock is never held while loading: loads of different assets run concurrently,
+				// loads of an asset already being loaded wait for it.
 				Result<T> load(AssetLoader& loader, AssetId id) noexcept {
 					y_profile();
 					if(id == AssetId::invalid_id()) {
@@ -83,22 +131,68 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 					}
 
 					std::unique_lock lock(_lock);
-					auto& weak_ptr = _loaded[id];
-					AssetPtr asset_ptr = weak_ptr.lock();
-					if(asset_ptr) {
+					if(AssetPtr<T> asset_ptr = _loaded[id].lock()) {
 						return core::Ok(asset_ptr);
 					}
 
-					if(auto reader = loader.store().data(id)) {
-						y_profile_zone("loading");
-						ReadableAssetArchive arc(*reader.unwrap(), loader);
-						if(auto asset = traits::load_asset(arc)) {
-							weak_ptr = asset_ptr = make_asset_with_id<T>(id, std::move(asset.unwrap()));
-							return core::Ok(asset_ptr);
+					if(auto it = _loading.find(id); it != _loading.end()) {
+						std::shared_future<LoadState<T>> loading = it->second;
+						lock.unlock();
+						return loading.get().result();
+					}
+
+					std::promise<LoadState<T>> promise;
+					_loading[id] = promise.get_future().share();
+					lock.unlock();
+
+					LoadState<T> state = load_uncached(loader, id);
+
+					lock.lock();
+					if(state.asset) {
+						auto& weak_ptr = _loaded[id];
+						if(AssetPtr<T> asset_ptr = weak_ptr.lock()) {
+							// set while we were loading
+							state.asset = asset_ptr;
+						} else {
+							weak_ptr = state.asset;
 						}
 					}
+					_loading.erase(id);
+					lock.unlock();
+
+					promise.set_value(state);
+					return state.result();
+				}
+
+				AsyncResult<T> load_async(AssetLoader& loader, AssetId id) {
+					y_profile();
+					std::unique_lock lock(_lock);
+					if(id == AssetId::invalid_id()) {
+						return ready(LoadState<T>{AssetPtr<T>(), ErrorType::InvalidID});
+					}
 
-					return core::Err(ErrorType::Unknown);
+					if(AssetPtr<T> asset_ptr = _loaded[id].lock()) {
+						return ready(LoadState<T>{asset_ptr, ErrorType::Unknown});
+					}
+
+					if(auto it = _requests.find(id); it != _requests.end()) {
+						return it->second;
+					}
+
+					std::shared_future<LoadState<T>> future = concurrent::async([this, &loader, id] {
+						LoadState<T> state;
+						if(auto res = load(loader, id)) {
+							state.asset = res.unwrap();
+						} else {
+							state.error = res.error();
+						}
+
+						std::unique_lock lock(_lock);
+						_requests.erase(id);
+						return state;
+					}).share();
+
+					return _requests[id] = AsyncResult<T>(future);
 				}
 
 				bool forget(AssetId id) override {
@@ -110,8 +204,82 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 					return false;
 				}
 
+				void wait_pending() override {
+					core::Vector<AsyncResult<T>> pending;
+					{
+						std::unique_lock lock(_lock);
+						for(const auto& req : _requests) {
+							pending << req.second;
+						}
+					}
+					for(const auto& p : pending) {
+						p.wait();
+					}
+				}
+
 			private:
+				static AsyncResult<T> ready(LoadState<T>&& state) {
+					std::promise<LoadState<T>> promise;
+					promise.set_value(std::move(state));
+					return AsyncResult<T>(promise.get_future().share());
+				}
+
+				// Reading, deserializing and creating the asset are separate stages
+				// so that loads of different assets can be in different stages at the same time.
+				static LoadState<T> load_uncached(AssetLoader& loader, AssetId id) noexcept {
+					LoadState<T> state;
+
+					// with a mapped file, this only maps it and starts paging it in
+					io2::ReaderPtr reader;
+					{
+						y_profile_zone("read");
+						auto data = loader.store().data(id);
+						if(!data) {
+							state.error = ErrorType::Unknown;
+							return state;
+						}
+						reader = std::move(data.unwrap());
+					}
+
+					// loads everything the asset references in parallel, before deserialization loads them one by one
+					AssetPrefetch dependencies;
+					if constexpr(traits::has_dependencies) {
+						y_profile_zone("prefetch");
+						// assets with dependencies are small: read them once, scan them and deserialize from the same buffer
+						core::Vector<u8> bytes;
+						if(!reader->read_all(bytes)) {
+							state.error = ErrorType::Unknown;
+							return state;
+						}
+						auto buffer = std::make_unique<io2::Buffer>(std::move(bytes));
+						dependencies = loader.prefetch_asset_dependencies<T>(id, *buffer);
+						reader = std::move(buffer);
+					}
+
+					// data can borrow its arrays from the reader (see serde2::array_view) so the reader has to outlive create.
+					// data is declared after reader so that it is destroyed first, assets never keep borrowed arrays.
+					core::Result<typename traits::load_from> data = core::Err();
+					{
+						y_profile_zone("deserialize");
+						ReadableAssetArchive arc(*reader, loader);
+						data = traits::load_data(arc);
+						if(!data) {
+							state.error = ErrorType::InvalidData;
+							return state;
+						}
+					}
+
+					{
+						y_profile_zone("create");
+						state.asset = make_asset_with_id<T>(id, traits::create_asset(loader.device(), std::move(data.unwrap())));
+					}
+
+					return state;
+				}
+
 				std::unordered_map<AssetId, WeakAssetPtr<T>> _loaded;
+				std::unordered_map<AssetId, std::shared_future<LoadState<T>>> _loading;
+				std::unordered_map<AssetId, AsyncResult<T>> _requests;
 
 				std::mutex _lock;
 		};
@@ -119,6 +287,11 @@ class AssetLoader : NonCopyable, public DeviceLinked {
    public:
 		AssetLoader(DevicePtr dptr, const std::shared_ptr<AssetStore>& store);
 
+		// Without a device, only assets that don't need one can be loaded
+		AssetLoader(const std::shared_ptr<AssetStore>& store);
+
+		~AssetLoader();
+
 		AssetStore& store();
 		const AssetStore& store() const;
 
@@ -134,6 +307,30 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 			return load<T>(store().id(name));
 		}
 
+		// Loads the asset on the thread pool. Requesting an asset that is already being loaded returns the same result.
+		// Waiting on the result from a thread pool task may deadlock if the load hasn't started yet.
+		template<typename T>
+		AsyncResult<T> load_async(AssetId id) {
+			return loader_for_type<T>().load_async(*this, id);
+		}
+
+		// Schedules the load of an asset referenced by the asset being deserialized
+		template<typename T>
+		void prefetch(AssetId id, AssetPrefetch& prefetch) {
+			if(id != AssetId::invalid_id() && !prefetch.contains(id)) {
+				prefetch.add(AssetDependency{id, AssetTraits<T>::name}, load_async<T>(id));
+			}
+		}
+
+		// Deserializes a T without loading the assets it references: they are loaded in parallel instead.
+		// Deserializing the T again while the prefetch is alive finds them already loaded.
+		template<typename T>
+		AssetPrefetch prefetch_dependencies(io2::Reader& reader) {
+			AssetPrefetch prefetch;
+			scan_dependencies<T>(reader, prefetch);
+			return prefetch;
+		}
+
 		template<typename T>
 		Result<T> import(std::string_view name, std::string_view import_from) {
 			return load<T>(load_or_import(name, import_from));
@@ -160,15 +357,47 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 			auto& loader = _loaders[typeid(Type)];
 			if(!loader) {
 				loader = std::make_unique<Loader<Type>>();
+				_prefetchers[AssetTraits<Type>::name] = [](AssetLoader& l, AssetId id, AssetPrefetch& prefetch) { l.prefetch<Type>(id, prefetch); };
 			}
 			return *dynamic_cast<Loader<Type>*>(loader.get());
 		}
 
+		template<typename T>
+		void scan_dependencies(io2::Reader& reader, AssetPrefetch& prefetch) {
+			T t;
+			ReadableAssetArchive arc(reader, *this, prefetch);
+			// a failed scan only means that less gets prefetched
+			arc(t).ignore();
+		}
+
+		// Uses the dependencies recorded in the store if possible, scans the asset otherwise.
+		// The buffer is rewound after the scan.
+		template<typename T>
+		AssetPrefetch prefetch_asset_dependencies(AssetId id, io2::Buffer& buffer) {
+			AssetPrefetch prefetch;
+			if(auto deps = store().dependencies(id)) {
+				if(prefetch_recorded(deps.unwrap(), prefetch)) {
+					return prefetch;
+				}
+			}
+
+			scan_dependencies<typename AssetTraits<T>::load_from>(buffer, prefetch);
+			buffer.rewind();
+			store().set_dependencies(id, prefetch.dependencies()).ignore();
+			return prefetch;
+		}
+
+		bool prefetch_recorded(core::Span<AssetDependency> dependencies, AssetPrefetch& prefetch);
+
 
 
 		core::Result<AssetId> load_or_import(std::string_view name, std::string_view import_from);
 
 		std::unordered_map<std::type_index, std::unique_ptr<LoaderBase>> _loaders;
+
+		// Types are only known once something has tried to load them
+		using prefetch_f = void(*)(AssetLoader&, AssetId, AssetPrefetch&);
+		std::unordered_map<core::String, prefetch_f> _prefetchers;
 		std::shared_ptr<AssetStore> _store;
 
 		std::mutex _lock;
@@ -187,6 +416,10 @@ serde2::Result AssetPtr<T>::deserialize(ReadableAssetArchive& arc)  noexcept {
 	if(!arc(id)) {
 		return core::Err();
 	}
+	if(AssetPrefetch* prefetch = arc.prefetch()) {
+		arc.loader().prefetch<T>(id, *prefetch);
+		return core::Ok();
+	}
 	auto asset = arc.loader().load<T>(id);
 	if(!asset) {
 		return core::Err();
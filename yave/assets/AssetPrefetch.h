@@ -0,0 +1,64 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ASSETS_ASSETPREFETCH_H
+#define YAVE_ASSETS_ASSETPREFETCH_H
+
+#include "AssetStore.h"
+
+#include <y/core/Functor.h>
+
+#include <unordered_set>
+
+namespace yave {
+
+// Assets being loaded ahead of the asset referencing them.
+// They stay loaded for as long as the prefetch is alive.
+class AssetPrefetch : NonCopyable {
+
+	public:
+		AssetPrefetch() = default;
+
+		bool contains(AssetId id) const;
+
+		template<typename R>
+		void add(AssetDependency dependency, R&& result) {
+			_ids.insert(dependency.id);
+			_dependencies << std::move(dependency);
+			_pending << [r = y_fwd(result)] { r.wait(); };
+		}
+
+		// Blocks until all dependencies are loaded
+		void wait() const;
+
+		core::Span<AssetDependency> dependencies() const;
+
+	private:
+		core::Vector<AssetDependency> _dependencies;
+		std::unordered_set<AssetId> _ids;
+
+		// holds the async results, and with them the loaded assets
+		core::Vector<core::Functor<void()>> _pending;
+};
+
+}
+
+#endif // YAVE_ASSETS_ASSETPREFETCH_H
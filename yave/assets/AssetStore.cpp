@@ -65,6 +65,16 @@ AssetStore::Result<> AssetStore::write(AssetId id, io2::Reader& data) {
 	return core::Err(ErrorType::UnsupportedOperation);
 }
 
+AssetStore::Result<core::Vector<AssetDependency>> AssetStore::dependencies(AssetId id) const {
+	unused(id);
+	return core::Err(ErrorType::UnsupportedOperation);
+}
+
+AssetStore::Result<> AssetStore::set_dependencies(AssetId id, core::Span<AssetDependency> dependencies) {
+	unused(id, dependencies);
+	return core::Err(ErrorType::UnsupportedOperation);
+}
+
 AssetStore::Result<AssetType> AssetStore::asset_type(AssetId id) const {
 	auto dat = data(id);
 	if(dat) {
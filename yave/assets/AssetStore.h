@@ -25,10 +25,22 @@ SOFTWARE.
 #include "AssetPtr.h"
 #include "AssetType.h"
 
+#include <y/core/Span.h>
+#include <y/serde2/serde.h>
+
 namespace yave {
 
 class FileSystemModel;
 
+struct AssetDependency {
+	AssetId id;
+
+	// name of the asset type, as declared in its AssetTraits
+	core::String type;
+
+	y_serde2(id, type)
+};
+
 class AssetStore : NonCopyable {
 
 	public:
@@ -69,6 +81,10 @@ class AssetStore : NonCopyable {
 		virtual Result<> rename(std::string_view from, std::string_view to);
 
 		virtual Result<AssetType> asset_type(AssetId id) const;
+
+		// Assets referenced by an asset, as recorded by the loader the first time the asset was loaded
+		virtual Result<core::Vector<AssetDependency>> dependencies(AssetId id) const;
+		virtual Result<> set_dependencies(AssetId id, core::Span<AssetDependency> dependencies);
 };
 
 }
@@ -24,12 +24,27 @@ SOFTWARE.
 
 #include <yave/utils/serde.h>
 
+#include <y/utils/detect.h>
+
 namespace yave {
 
 class AssetLoader;
 
 namespace detail {
 DevicePtr device_from_loader(AssetLoader& loader);
+
+template<typename T>
+using has_asset_dependencies_t = decltype(T::has_asset_dependencies);
+
+// Data referencing other assets should declare has_asset_dependencies so they get prefetched
+template<typename T>
+constexpr bool has_asset_dependencies() {
+	if constexpr(is_detected_v<has_asset_dependencies_t, T>) {
+		return T::has_asset_dependencies;
+	} else {
+		return false;
+	}
+}
 }
 
 template<typename T>
@@ -40,14 +55,25 @@ struct AssetTraits {
 #define YAVE_FILL_ASSET_TRAITS(Type, LoadFrom, TypeEnum)									\
 	static constexpr bool is_asset = true;													\
 	static constexpr AssetType type = TypeEnum;												\
+	static constexpr const char* name = #Type;												\
 	using load_from = LoadFrom;																\
+	static constexpr bool has_dependencies = detail::has_asset_dependencies<LoadFrom>();	\
 	using Result = core::Result<Type>;														\
-	static Result load_asset(ReadableAssetArchive& arc) noexcept {							\
+	static core::Result<load_from> load_data(ReadableAssetArchive& arc) noexcept {			\
 		load_from data;																		\
 		if(!arc(data)) {																	\
 			return core::Err();																\
 		}																					\
-		return core::Ok(Type(detail::device_from_loader(arc.loader()), std::move(data)));	\
+		return core::Ok(std::move(data));													\
+	}																						\
+	static Type create_asset(DevicePtr dptr, load_from&& data) {							\
+		return Type(dptr, std::move(data));													\
+	}																						\
+	static Result load_asset(ReadableAssetArchive& arc) noexcept {							\
+		if(auto data = load_data(arc)) {													\
+			return core::Ok(create_asset(detail::device_from_loader(arc.loader()), std::move(data.unwrap())));	\
+		}																					\
+		return core::Err();																	\
 	}
 
 
@@ -24,6 +24,7 @@ SOFTWARE.
 #include "FolderAssetStore.h"
 
 #include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
 
 #include <atomic>
 
@@ -90,7 +91,8 @@ FileSystemModel::Result<> FolderAssetStore::FolderFileSystemModel::rename(std::s
 
 FolderAssetStore::FolderAssetStore(std::string_view path) :
 		_filesystem(path),
-		_index_file_path(_filesystem.join(_filesystem.root_path(), ".index")) {
+		_index_file_path(_filesystem.join(_filesystem.root_path(), ".index")),
+		_dependencies_file_path(_filesystem.join(_filesystem.root_path(), ".dependencies")) {
 
 	log_msg("Store index file: " + _index_file_path);
 	if(!_filesystem.create_directory(".")) {
@@ -99,12 +101,18 @@ FolderAssetStore::FolderAssetStore(std::string_view path) :
 	if(!read_index()) {
 		log_msg("Unable to read index.", Log::Error);
 	}
+	if(!read_dependencies()) {
+		log_msg("Unable to read dependencies, they will be rebuilt.", Log::Debug);
+	}
 }
 
 FolderAssetStore::~FolderAssetStore() {
 	if(!write_index()) {
 		log_msg("Unable to write index.", Log::Error);
 	}
+	if(_dependencies_changed && !write_dependencies()) {
+		log_msg("Unable to write dependencies.", Log::Error);
+	}
 }
 
 const FileSystemModel* FolderAssetStore::filesystem() const {
@@ -179,6 +187,67 @@ AssetStore::Result<> FolderAssetStore::write_index() const {
 	return core::Ok();
 }
 
+AssetStore::Result<> FolderAssetStore::read_dependencies() {
+	y_profile();
+	std::unique_lock lock(_lock);
+
+	auto file = io2::File::open(_dependencies_file_path);
+	if(!file) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	serde2::ReadableArchive arc(file.unwrap());
+	_dependencies.clear();
+	while(!file.unwrap().at_end()) {
+		DependencyEntry entry;
+		if(!arc(entry)) {
+			_dependencies.clear();
+			return core::Err(ErrorType::FilesytemError);
+		}
+		// dependencies of removed assets are stale
+		if(_from_id.find(entry.id) != _from_id.end()) {
+			_dependencies[entry.id] = std::move(entry.dependencies);
+		}
+	}
+	return core::Ok();
+}
+
+AssetStore::Result<> FolderAssetStore::write_dependencies() const {
+	y_profile();
+	std::unique_lock lock(_lock);
+
+	auto file = io2::File::create(_dependencies_file_path);
+	if(!file) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	WritableAssetArchive arc(file.unwrap());
+	for(const auto& [id, deps] : _dependencies) {
+		if(!arc(DependencyEntry{id, deps})) {
+			return core::Err(ErrorType::FilesytemError);
+		}
+	}
+	return core::Ok();
+}
+
+AssetStore::Result<> FolderAssetStore::replace_file(std::string_view name, io2::Reader& data) const {
+	y_profile();
+
+	// '~' is not valid in asset names so this can't clash with another asset
+	const core::String tmp_name = fmt("%~", name);
+	if(!io2::File::copy(data, _filesystem.join(_filesystem.root_path(), tmp_name))) {
+		_filesystem.remove(tmp_name).ignore();
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	// the file is never modified in place: mappings of the old file stay valid until they are closed
+	if(!_filesystem.rename(tmp_name, name)) {
+		_filesystem.remove(tmp_name).ignore();
+		return core::Err(ErrorType::FilesytemError);
+	}
+	return core::Ok();
+}
+
 AssetStore::Result<AssetId> FolderAssetStore::import(io2::Reader& data, std::string_view dst_name) {
 	y_profile();
 	if(!is_valid_path(dst_name)) {
@@ -204,8 +273,7 @@ AssetStore::Result<AssetId> FolderAssetStore::import(io2::Reader& data, std::str
 	y_defer(write_index().ignore());
 	y_defer(y_debug_assert(_from_id.size() == _from_name.size()));
 
-	auto dst_file = _filesystem.join(_filesystem.root_path(), dst_name);
-	if(!io2::File::copy(data, dst_file)) {
+	if(!replace_file(dst_name, data)) {
 		_from_name.erase(_from_name.find(dst_name));
 		return core::Err(ErrorType::FilesytemError);
 	}
@@ -238,6 +306,15 @@ AssetStore::Result<core::String> FolderAssetStore::name(AssetId id) const {
 	return core::Err(ErrorType::UnknownID);
 }
 
+core::Vector<AssetId> FolderAssetStore::asset_ids() const {
+	std::unique_lock lock(_lock);
+	auto ids = core::vector_with_capacity<AssetId>(_from_id.size());
+	for(const auto& row : _from_id) {
+		ids << row.first;
+	}
+	return ids;
+}
+
 AssetStore::Result<io2::ReaderPtr> FolderAssetStore::data(AssetId id) const {
 	y_profile();
 	std::unique_lock lock(_lock);
@@ -248,16 +325,35 @@ AssetStore::Result<io2::ReaderPtr> FolderAssetStore::data(AssetId id) const {
 		return core::Err(ErrorType::UnknownID);
 	}
 
-	auto file = io2::File::open(_filesystem.join(_filesystem.root_path(), it->second->name));
+	// mapped so that large arrays can be uploaded straight from the page cache
+	auto file = io2::MappedFile::open(_filesystem.join(_filesystem.root_path(), it->second->name));
 	if(!file) {
 		return core::Err(ErrorType::FilesytemError);
 	}
 
-	io2::ReaderPtr ptr = std::make_unique<io2::File>(std::move(file.unwrap()));
+	io2::ReaderPtr ptr = std::make_unique<io2::MappedFile>(std::move(file.unwrap()));
 	return core::Ok(std::move(ptr));
 }
 
 
+AssetStore::Result<core::Vector<AssetDependency>> FolderAssetStore::dependencies(AssetId id) const {
+	std::unique_lock lock(_lock);
+	if(auto it = _dependencies.find(id); it != _dependencies.end()) {
+		return core::Ok(it->second);
+	}
+	return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<> FolderAssetStore::set_dependencies(AssetId id, core::Span<AssetDependency> dependencies) {
+	std::unique_lock lock(_lock);
+	if(_from_id.find(id) == _from_id.end()) {
+		return core::Err(ErrorType::UnknownID);
+	}
+	_dependencies[id] = core::Vector<AssetDependency>(dependencies.begin(), dependencies.end());
+	_dependencies_changed = true;
+	return core::Ok();
+}
+
 AssetStore::Result<> FolderAssetStore::remove(AssetId id) {
 	y_profile();
 	std::unique_lock lock(_lock);
@@ -274,6 +370,7 @@ AssetStore::Result<> FolderAssetStore::remove(AssetId id) {
 
 	_from_name.erase(_from_name.find(name));
 	_from_id.erase(it);
+	_dependencies.erase(id);
 
 	y_debug_assert(_from_id.size() == _from_name.size());
 	return write_index();
@@ -328,6 +425,7 @@ AssetStore::Result<> FolderAssetStore::remove(std::string_view name) {
 			}
 
 			for(const auto& it : to_remove) {
+				_dependencies.erase(it->second->id);
 				_from_id.erase(it->second->id);
 				_from_name.erase(it);
 			}
@@ -383,8 +481,11 @@ AssetStore::Result<> FolderAssetStore::write(AssetId id, io2::Reader& data) {
 
 	y_debug_assert(_from_id.size() == _from_name.size());
 	if(auto it = _from_id.find(id); it != _from_id.end()) {
-		auto filename = _filesystem.join(_filesystem.root_path(), it->second->name);
-		if(io2::File::copy(data, filename)) {
+		if(replace_file(it->second->name, data)) {
+			// the new data might not have the same dependencies, they will be rebuilt by the next load
+			if(_dependencies.erase(id)) {
+				_dependencies_changed = true;
+			}
 			return core::Ok();
 		}
 		return core::Err(ErrorType::FilesytemError);
@@ -44,6 +44,13 @@ class FolderAssetStore final : public AssetStore {
 		y_serde2(id, name)
 	};
 
+	struct DependencyEntry {
+		AssetId id;
+		core::Vector<AssetDependency> dependencies;
+
+		y_serde2(id, dependencies)
+	};
+
 	// same as LocalFileSystemModel but rooted in a folder
 	class FolderFileSystemModel final : public LocalFileSystemModel {
 		public:
@@ -78,12 +85,17 @@ class FolderAssetStore final : public AssetStore {
 
 		Result<io2::ReaderPtr> data(AssetId id) const override;
 
+		Result<core::Vector<AssetDependency>> dependencies(AssetId id) const override;
+		Result<> set_dependencies(AssetId id, core::Span<AssetDependency> dependencies) override;
+
 		Result<> remove(AssetId id) override;
 		Result<> rename(AssetId id, std::string_view new_name) override;
 		Result<> remove(std::string_view name) override;
 		Result<> rename(std::string_view from, std::string_view to) override;
 
 
+		core::Vector<AssetId> asset_ids() const;
+
 		bool is_valid_path(std::string_view path) const;
 		bool is_valid_name(std::string_view name) const;
 
@@ -93,8 +105,15 @@ class FolderAssetStore final : public AssetStore {
 		Result<> write_index() const;
 		Result<> read_index();
 
+		Result<> write_dependencies() const;
+		Result<> read_dependencies();
+
+		// Writes to a temporary file that then replaces the asset file, readers that mapped it keep the previous data
+		Result<> replace_file(std::string_view name, io2::Reader& data) const;
+
 		FolderFileSystemModel _filesystem;
 		core::String _index_file_path;
+		core::String _dependencies_file_path;
 
 		mutable std::recursive_mutex _lock;
 
@@ -102,6 +121,9 @@ class FolderAssetStore final : public AssetStore {
 		std::unordered_map<AssetId, Entry*> _from_id;
 		std::unordered_map<core::String, std::unique_ptr<Entry>> _from_name;
 
+		std::unordered_map<AssetId, core::Vector<AssetDependency>> _dependencies;
+		bool _dependencies_changed = false;
+
 		AssetIdFactory _id_factory;
 };
 
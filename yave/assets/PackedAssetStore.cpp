@@ -0,0 +1,302 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "PackedAssetStore.h"
+#include "FolderAssetStore.h"
+
+#include <y/io2/File.h>
+#include <y/io2/Buffer.h>
+#include <y/io2/CompressedWriter.h>
+#include <y/io2/DecompressedReader.h>
+
+#include <numeric>
+
+namespace yave {
+
+// Reader over the slice of the archive that holds one asset, keeps the mapping alive
+class SliceReader final : public io2::Reader {
+	public:
+		SliceReader(std::shared_ptr<const io2::MappedFile> archive, core::Span<u8> data) : _archive(std::move(archive)), _data(data) {
+		}
+
+		usize remaining() const {
+			return _data.size() - _cursor;
+		}
+
+		bool at_end() const override {
+			return !remaining();
+		}
+
+		io2::ReadResult read(u8* data, usize bytes) override {
+			if(remaining() < bytes) {
+				return core::Err<usize>(0);
+			}
+			std::copy_n(_data.data() + _cursor, bytes, data);
+			_cursor += bytes;
+			return core::Ok();
+		}
+
+		io2::ReadUpToResult read_up_to(u8* data, usize max_bytes) override {
+			usize max = std::min(max_bytes, remaining());
+			std::copy_n(_data.data() + _cursor, max, data);
+			_cursor += max;
+			return core::Ok(max);
+		}
+
+		io2::ReadUpToResult read_all(core::Vector<u8>& data) override {
+			usize r = remaining();
+			data.push_back(_data.data() + _cursor, _data.end());
+			_cursor = _data.size();
+			return core::Ok(r);
+		}
+
+		io2::ReadViewResult read_view(usize bytes, usize alignment) override {
+			const u8* start = _data.data() + _cursor;
+			if(remaining() < bytes || reinterpret_cast<uintptr_t>(start) % alignment) {
+				return core::Err<usize>(0);
+			}
+			_cursor += bytes;
+			return core::Ok(core::Span<u8>(start, bytes));
+		}
+
+	private:
+		std::shared_ptr<const io2::MappedFile> _archive;
+		core::Span<u8> _data;
+		usize _cursor = 0;
+};
+
+static io2::WriteResult write_padding(io2::File& file, usize alignment) {
+	static constexpr u8 zeroes[PackedAssetStore::data_alignment] = {};
+	if(usize offset = file.size() % alignment) {
+		return file.write(zeroes, alignment - offset);
+	}
+	return core::Ok();
+}
+
+
+PackedAssetStore::PackedAssetStore(const core::String& filename) {
+	log_msg("Store archive file: " + filename);
+	auto file = io2::MappedFile::open(filename);
+	if(!file) {
+		log_msg("Unable to open archive file.", Log::Error);
+		return;
+	}
+	_archive = std::make_shared<io2::MappedFile>(std::move(file.unwrap()));
+	if(!read_table()) {
+		log_msg("Unable to read archive table.", Log::Error);
+		_entries.clear();
+		_by_name.clear();
+	}
+}
+
+static core::Vector<u8> compress_bytes(const core::Vector<u8>& bytes) {
+	io2::Buffer buffer;
+	{
+		io2::CompressedWriter writer(buffer);
+		if(!writer.write(bytes.data(), bytes.size()) || !writer.finish()) {
+			return {};
+		}
+	}
+	core::Vector<u8> compressed;
+	buffer.read_all(compressed).ignore();
+	return compressed;
+}
+
+AssetStore::Result<> PackedAssetStore::pack(const FolderAssetStore& store, const core::String& filename, bool compress) {
+	y_profile();
+
+	auto file = io2::File::create(filename);
+	if(!file) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	io2::File& out = file.unwrap();
+	WritableAssetArchive arc(out);
+
+	// written again once the table offset is known
+	Header header;
+	if(!arc(header)) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	core::Vector<Entry> entries;
+	for(AssetId id : store.asset_ids()) {
+		auto name = store.name(id);
+		auto data = store.data(id);
+		if(!name || !data) {
+			log_msg("Unable to read asset for packing.", Log::Error);
+			continue;
+		}
+
+		core::Vector<u8> bytes;
+		if(!data.unwrap()->read_all(bytes)) {
+			log_msg("Unable to read asset for packing.", Log::Error);
+			continue;
+		}
+
+		if(!write_padding(out, data_alignment)) {
+			return core::Err(ErrorType::FilesytemError);
+		}
+
+		Entry entry;
+		entry.id = id;
+		entry.name = std::move(name.unwrap());
+		entry.offset = out.size();
+		entry.size = entry.uncompressed_size = bytes.size();
+		entry.dependencies = store.dependencies(id).unwrap_or(core::Vector<AssetDependency>());
+
+		if(compress) {
+			core::Vector<u8> compressed = compress_bytes(bytes);
+			if(!compressed.is_empty() && compressed.size() < bytes.size()) {
+				entry.size = compressed.size();
+				entry.compression = Compression::LZ;
+				bytes = std::move(compressed);
+			}
+		}
+
+		if(!out.write(bytes.data(), bytes.size())) {
+			return core::Err(ErrorType::FilesytemError);
+		}
+		entries << std::move(entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; });
+
+	header.table_offset = out.size();
+	if(!arc(entries)) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	out.seek(0);
+	if(!arc(header) || !out.flush()) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+	return core::Ok();
+}
+
+AssetStore::Result<> PackedAssetStore::read_table() {
+	y_profile();
+
+	const core::Span<u8> archive = _archive->data();
+	SliceReader reader(_archive, archive);
+	serde2::ReadableArchive arc(reader);
+
+	Header header;
+	if(!arc(header) || header.magic != Header().magic || header.version != Header().version) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	if(header.table_offset > archive.size()) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	SliceReader table_reader(_archive, core::Span<u8>(archive.data() + header.table_offset, archive.size() - header.table_offset));
+	serde2::ReadableArchive table_arc(table_reader);
+	if(!table_arc(_entries)) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	for(const Entry& entry : _entries) {
+		if(entry.offset > archive.size() || entry.size > archive.size() - entry.offset) {
+			return core::Err(ErrorType::FilesytemError);
+		}
+	}
+
+	if(!std::is_sorted(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; })) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	_by_name = core::Vector<u32>(_entries.size(), 0);
+	std::iota(_by_name.begin(), _by_name.end(), 0);
+	std::sort(_by_name.begin(), _by_name.end(), [this](u32 a, u32 b) { return _entries[a].name < _entries[b].name; });
+
+	return core::Ok();
+}
+
+const PackedAssetStore::Entry* PackedAssetStore::find(AssetId id) const {
+	auto it = std::lower_bound(_entries.begin(), _entries.end(), id, [](const Entry& e, AssetId i) { return e.id < i; });
+	if(it != _entries.end() && it->id == id) {
+		return it;
+	}
+	return nullptr;
+}
+
+usize PackedAssetStore::size() const {
+	return _entries.size();
+}
+
+AssetStore::Result<AssetId> PackedAssetStore::import(io2::Reader& data, std::string_view dst_name) {
+	unused(data, dst_name);
+	return core::Err(ErrorType::UnsupportedOperation);
+}
+
+AssetStore::Result<AssetId> PackedAssetStore::id(std::string_view name) const {
+	auto it = std::lower_bound(_by_name.begin(), _by_name.end(), name, [this](u32 i, std::string_view n) { return _entries[i].name.view() < n; });
+	if(it != _by_name.end() && _entries[*it].name.view() == name) {
+		return core::Ok(_entries[*it].id);
+	}
+	return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<core::String> PackedAssetStore::name(AssetId id) const {
+	if(const Entry* entry = find(id)) {
+		return core::Ok(entry->name);
+	}
+	return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<io2::ReaderPtr> PackedAssetStore::data(AssetId id) const {
+	const Entry* entry = find(id);
+	if(!entry) {
+		return core::Err(ErrorType::UnknownID);
+	}
+
+	const core::Span<u8> slice(_archive->data().data() + entry->offset, entry->size);
+	io2::ReaderPtr ptr = std::make_unique<SliceReader>(_archive, slice);
+
+	switch(entry->compression) {
+		case Compression::None:
+			return core::Ok(std::move(ptr));
+
+		case Compression::LZ: {
+			// the compressed blocks are borrowed from the slice
+			auto decompressed = std::make_unique<io2::DecompressedReader>(std::move(ptr));
+			if(!decompressed->is_valid() || decompressed->size() != entry->uncompressed_size) {
+				return core::Err(ErrorType::FilesytemError);
+			}
+			ptr = std::move(decompressed);
+			return core::Ok(std::move(ptr));
+		}
+
+		default:
+		break;
+	}
+	return core::Err(ErrorType::UnsupportedOperation);
+}
+
+AssetStore::Result<core::Vector<AssetDependency>> PackedAssetStore::dependencies(AssetId id) const {
+	if(const Entry* entry = find(id)) {
+		return core::Ok(entry->dependencies);
+	}
+	return core::Err(ErrorType::UnknownID);
+}
+
+}
@@ -0,0 +1,104 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ASSETS_PACKEDASSETSTORE_H
+#define YAVE_ASSETS_PACKEDASSETSTORE_H
+
+#include "AssetStore.h"
+
+#include <yave/utils/serde.h>
+
+#include <y/io2/MappedFile.h>
+
+namespace yave {
+
+class FolderAssetStore;
+
+// Read only store over a single archive file, built from a FolderAssetStore with PackedAssetStore::pack.
+// The archive is mapped once and data() returns readers over slices of the mapping.
+class PackedAssetStore final : public AssetStore {
+
+	public:
+		// assets start on cache line boundaries so arrays can be borrowed from the mapping (see serde2::array_view)
+		static constexpr usize data_alignment = 64;
+
+		enum class Compression : u32 {
+			None = 0,
+			LZ = 1, // see io2::CompressedWriter
+		};
+
+	private:
+		struct Entry {
+			AssetId id;
+			core::String name;
+
+			u64 offset = 0;
+			u64 size = 0;
+			u64 uncompressed_size = 0;
+			Compression compression = Compression::None;
+
+			core::Vector<AssetDependency> dependencies;
+
+			y_serde2(id, name, offset, size, uncompressed_size, compression, dependencies)
+		};
+
+		struct Header {
+			u32 magic = fs::magic_number;
+			u32 version = 1;
+			u64 table_offset = 0;
+
+			y_serde2(magic, version, table_offset)
+		};
+
+	public:
+		PackedAssetStore(const core::String& filename);
+
+		// With compress set, assets that shrink when compressed are stored compressed
+		static Result<> pack(const FolderAssetStore& store, const core::String& filename, bool compress = false);
+
+		Result<AssetId> import(io2::Reader& data, std::string_view dst_name) override;
+
+		Result<AssetId> id(std::string_view name) const override;
+		Result<core::String> name(AssetId id) const override;
+
+		Result<io2::ReaderPtr> data(AssetId id) const override;
+
+		Result<core::Vector<AssetDependency>> dependencies(AssetId id) const override;
+
+		usize size() const;
+
+	private:
+		Result<> read_table();
+
+		const Entry* find(AssetId id) const;
+
+		std::shared_ptr<const io2::MappedFile> _archive;
+
+		// sorted by id
+		core::Vector<Entry> _entries;
+
+		// indices in _entries, sorted by name
+		core::Vector<u32> _by_name;
+};
+
+}
+
+#endif // YAVE_ASSETS_PACKEDASSETSTORE_H
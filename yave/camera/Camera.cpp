@@ -46,18 +46,27 @@ static math::Vec3 extract_up(const math::Matrix4<>& view) {
 }
 
 
+// planes need to be normalized using their normal's length so that distances are in world units
+static Plane normalize_plane(Plane plane) {
+	float len = plane.to<3>().length();
+	if(len > 0.0f) {
+		plane /= len;
+	}
+	return plane;
+}
+
 static std::array<Plane, 6> extract_frustum(const math::Matrix4<>& viewproj) {
 	auto x = viewproj.row(0);
 	auto y = viewproj.row(1);
 	auto z = viewproj.row(2);
 	auto w = viewproj.row(3);
 	return {{
-			(w + x).normalized(),
-			(w - x).normalized(),
-			(w + y).normalized(),
-			(w - y).normalized(),
-			(w + z).normalized(),
-			(w - z).normalized()
+			normalize_plane(w + x),
+			normalize_plane(w - x),
+			normalize_plane(w + y),
+			normalize_plane(w - y),
+			normalize_plane(w + z),
+			normalize_plane(w - z)
 		}};
 }
 
@@ -40,22 +40,27 @@ void StaticMeshComponent::render(RenderPassRecorder& recorder, const SceneData&
 		return;
 	}
 
-	if(_material->descriptor_set().device()) {
-		recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set, _material->descriptor_set()});
-	} else {
-		recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set});
-	}
-
+	bind_material(recorder, scene_data.descriptor_set);
 	render_mesh(recorder, scene_data.instance_index);
 }
 
-void StaticMeshComponent::render_mesh(RenderPassRecorder& recorder, u32 instance_index) const {
+void StaticMeshComponent::render_mesh(RenderPassRecorder& recorder, u32 instance_index, u32 instance_count) const {
+	recorder.wait_for_upload(_mesh->upload_fence());
 	recorder.bind_buffers(TriangleSubBuffer(_mesh->triangle_buffer()), {VertexSubBuffer(_mesh->vertex_buffer())});
 	auto indirect = _mesh->indirect_data();
 	indirect.setFirstInstance(instance_index);
+	indirect.setInstanceCount(instance_count);
 	recorder.draw(indirect);
 }
 
+void StaticMeshComponent::bind_material(RenderPassRecorder& recorder, const DescriptorSetBase& scene_descriptor_set) const {
+	if(_material->descriptor_set().device()) {
+		recorder.bind_material(_material->mat_template(), {scene_descriptor_set, _material->descriptor_set()});
+	} else {
+		recorder.bind_material(_material->mat_template(), {scene_descriptor_set});
+	}
+}
+
 const AssetPtr<StaticMesh>& StaticMeshComponent::mesh() const {
 	return _mesh;
 }
@@ -42,7 +42,8 @@ class StaticMeshComponent final : public Renderable {
 		void flush_reload();
 
 		void render(RenderPassRecorder& recorder, const SceneData& scene_data) const;
-		void render_mesh(RenderPassRecorder& recorder, u32 instance_index) const;
+		void render_mesh(RenderPassRecorder& recorder, u32 instance_index, u32 instance_count = 1) const;
+		void bind_material(RenderPassRecorder& recorder, const DescriptorSetBase& scene_descriptor_set) const;
 
 		const AssetPtr<StaticMesh>& mesh() const;
 		const AssetPtr<Material>& material() const;
@@ -0,0 +1,135 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_DEVICE_DEFERREDQUEUE_H
+#define YAVE_DEVICE_DEFERREDQUEUE_H
+
+#include <yave/yave.h>
+
+#include <y/concurrent/SpinLock.h>
+#include <y/core/Vector.h>
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <deque>
+
+namespace yave {
+
+// Objects tagged with a fence value, waiting for that fence to be reached.
+// Every thread pushes in a queue of its own, so pushing only contends with collection.
+template<typename T>
+class DeferredQueue : NonMovable {
+
+	struct ThreadQueue {
+		ThreadQueue(std::thread::id id) : owner(id) {
+		}
+
+		const std::thread::id owner;
+		concurrent::SpinLock lock;
+		// sorted by fence as a thread only sees increasing fence values
+		std::deque<std::pair<u64, T>> objects;
+	};
+
+	public:
+		DeferredQueue() : _id(++next_id()) {
+		}
+
+		template<typename U>
+		void push(u64 fence, U&& obj) {
+			ThreadQueue& queue = thread_queue();
+			std::unique_lock lock(queue.lock);
+			y_debug_assert(queue.objects.empty() || queue.objects.back().first <= fence);
+			queue.objects.emplace_back(fence, T(y_fwd(obj)));
+		}
+
+		// Calls f on every object whose fence is at most up_to, each object is collected exactly once.
+		// f is called without holding any lock.
+		template<typename F>
+		void collect(u64 up_to, F&& f) {
+			core::Vector<T> collected;
+			{
+				std::unique_lock lock(_queues_lock);
+				for(const auto& queue : _queues) {
+					std::unique_lock queue_lock(queue->lock);
+					while(!queue->objects.empty() && queue->objects.front().first <= up_to) {
+						collected.emplace_back(std::move(queue->objects.front().second));
+						queue->objects.pop_front();
+					}
+				}
+			}
+			for(T& obj : collected) {
+				f(obj);
+			}
+		}
+
+		// Calls f on every remaining object
+		template<typename F>
+		void collect_all(F&& f) {
+			collect(u64(-1), y_fwd(f));
+		}
+
+		usize size() const {
+			usize total = 0;
+			std::unique_lock lock(_queues_lock);
+			for(const auto& queue : _queues) {
+				std::unique_lock queue_lock(queue->lock);
+				total += queue->objects.size();
+			}
+			return total;
+		}
+
+	private:
+		static std::atomic<u64>& next_id() {
+			static std::atomic<u64> id = 0;
+			return id;
+		}
+
+		ThreadQueue& thread_queue() {
+			// queues are identified by id rather than address, as a new queue might reuse the address of a destroyed one
+			static thread_local std::pair<u64, ThreadQueue*> cache;
+			if(cache.first == _id) {
+				return *cache.second;
+			}
+
+			const std::thread::id thread = std::this_thread::get_id();
+			std::unique_lock lock(_queues_lock);
+			for(const auto& queue : _queues) {
+				if(queue->owner == thread) {
+					cache = {_id, queue.get()};
+					return *queue;
+				}
+			}
+
+			_queues.emplace_back(std::make_unique<ThreadQueue>(thread));
+			cache = {_id, _queues.last().get()};
+			return *cache.second;
+		}
+
+		const u64 _id;
+
+		mutable std::mutex _queues_lock;
+		core::Vector<std::unique_ptr<ThreadQueue>> _queues;
+};
+
+}
+
+#endif // YAVE_DEVICE_DEFERREDQUEUE_H
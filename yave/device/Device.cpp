@@ -24,6 +24,7 @@ SOFTWARE.
 #include "PhysicalDevice.h"
 
 #include <yave/graphics/commands/CmdBufferBase.h>
+#include <yave/meshes/MeshAllocator.h>
 
 #include <mutex>
 
@@ -100,6 +101,43 @@ static vk::Device create_device(
 }
 
 
+static core::Vector<Queue> create_queues(DevicePtr dptr, core::ArrayView<QueueFamily> queue_families) {
+	core::Vector<Queue> queues;
+	for(const auto& family : queue_families) {
+		for(auto& queue : family.queues(dptr)) {
+			queues.push_back(std::move(queue));
+		}
+	}
+	return queues;
+}
+
+static usize transfer_queue_index(core::ArrayView<Queue> queues, core::ArrayView<QueueFamily> queue_families) {
+	auto flags = [&](const Queue& queue) {
+		for(const auto& family : queue_families) {
+			if(family.index() == queue.family_index()) {
+				return family.flags();
+			}
+		}
+		return vk::QueueFlags();
+	};
+
+	const auto graphic_and_compute = vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute;
+	for(usize i = 0; i != queues.size(); ++i) {
+		const vk::QueueFlags queue_flags = flags(queues[i]);
+		if((queue_flags & vk::QueueFlagBits::eTransfer) && !(queue_flags & graphic_and_compute)) {
+			return i;
+		}
+	}
+
+	// graphic queues support transfers even if they don't report it
+	for(usize i = 1; i < queues.size(); ++i) {
+		if(queues[i].family_index() == queues[0].family_index()) {
+			return i;
+		}
+	}
+	return 0;
+}
+
 Device::ScopedDevice::~ScopedDevice() {
 	device.destroy();
 }
@@ -111,18 +149,18 @@ Device::Device(Instance& instance) :
 		_device{create_device(_physical.vk_physical_device(), _queue_families, _instance.debug_params())},
 		_allocator(this),
 		_lifetime_manager(this),
-		_sampler(this) {
+		_descriptor_set_allocator(this),
+		_pipeline_cache(this),
+		_queues(create_queues(this, _queue_families)),
+		_transfer_queue_index(transfer_queue_index(_queues, _queue_families)),
+		_sampler(this),
+		_staging_ring(this),
+		_mesh_allocator(std::make_unique<MeshAllocator>(this)) {
 
 	if(_instance.debug_params().debug_features_enabled()) {
 		_extensions.debug_marker = std::make_unique<DebugMarker>(_device.device);
 	}
 
-	for(const auto& family : _queue_families) {
-		for(auto& queue : family.queues(this)) {
-			_queues.push_back(std::move(queue));
-		}
-	}
-
 	_resources = DeviceResources(this);
 }
 
@@ -158,6 +196,10 @@ Queue& Device::graphic_queue() {
 	return _queues.first();
 }
 
+const Queue& Device::transfer_queue() const {
+	return _queues[_transfer_queue_index];
+}
+
 void Device::wait_all_queues() const {
 	y_profile();
 	for(const Queue& q : _queues) {
@@ -203,6 +245,22 @@ LifetimeManager& Device::lifetime_manager() const {
 	return _lifetime_manager;
 }
 
+DescriptorSetAllocator& Device::descriptor_set_allocator() const {
+	return _descriptor_set_allocator;
+}
+
+PipelineCache& Device::pipeline_cache() const {
+	return _pipeline_cache;
+}
+
+StagingRing& Device::staging_ring() const {
+	return _staging_ring;
+}
+
+MeshAllocator& Device::mesh_allocator() const {
+	return *_mesh_allocator;
+}
+
 const vk::PhysicalDeviceLimits& Device::vk_limits() const {
 	return _physical.vk_properties().limits;
 }
@@ -219,6 +277,10 @@ CmdBuffer<CmdBufferUsage::Disposable> Device::create_disposable_cmd_buffer() con
 	return thread_device()->create_disposable_cmd_buffer();
 }
 
+CmdBuffer<CmdBufferUsage::Secondary> Device::create_secondary_cmd_buffer() const {
+	return thread_device()->create_secondary_cmd_buffer();
+}
+
 const DebugMarker* Device::debug_marker() const {
 	return _extensions.debug_marker.get();
 }
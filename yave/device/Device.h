@@ -28,9 +28,13 @@ SOFTWARE.
 #include "DeviceResources.h"
 #include "LifetimeManager.h"
 
+#include <yave/graphics/bindings/DescriptorSetAllocator.h>
+#include <yave/graphics/shaders/PipelineCache.h>
+
 #include "extentions/DebugMarker.h"
 
 #include <yave/graphics/images/Sampler.h>
+#include <yave/graphics/buffers/StagingRing.h>
 #include <yave/graphics/queues/QueueFamily.h>
 #include <yave/graphics/memory/DeviceMemoryAllocator.h>
 
@@ -38,6 +42,8 @@ SOFTWARE.
 
 namespace yave {
 
+class MeshAllocator;
+
 class Device : NonMovable {
 
 	struct ScopedDevice {
@@ -56,16 +62,26 @@ class Device : NonMovable {
 
 		CmdBuffer<CmdBufferUsage::Disposable> create_disposable_cmd_buffer() const;
 
+		// Secondary command buffers come from a pool owned by the calling thread, they can be recorded concurrently
+		CmdBuffer<CmdBufferUsage::Secondary> create_secondary_cmd_buffer() const;
+
 		const QueueFamily& queue_family(vk::QueueFlags flags) const;
 		const Queue& graphic_queue() const;
 		Queue& graphic_queue();
 
+		// Queue used for uploads: a queue from a transfer only family if there is one, or another queue than the graphic one if possible
+		const Queue& transfer_queue() const;
+
 		void wait_all_queues() const;
 
 		ThreadDevicePtr thread_device() const;
 		const DeviceResources& device_resources() const;
 
 		LifetimeManager& lifetime_manager() const;
+		DescriptorSetAllocator& descriptor_set_allocator() const;
+		PipelineCache& pipeline_cache() const;
+		StagingRing& staging_ring() const;
+		MeshAllocator& mesh_allocator() const;
 
 		const vk::PhysicalDeviceLimits& vk_limits() const;
 
@@ -104,14 +120,23 @@ class Device : NonMovable {
 
 		mutable DeviceMemoryAllocator _allocator;
 		mutable LifetimeManager _lifetime_manager;
+		mutable DescriptorSetAllocator _descriptor_set_allocator;
+		mutable PipelineCache _pipeline_cache;
 
 		core::Vector<Queue> _queues;
+		usize _transfer_queue_index = 0;
 
 		Sampler _sampler;
 
+		// declared after _queues as it submits its pending uploads on destruction
+		mutable StagingRing _staging_ring;
+
 		mutable concurrent::SpinLock _lock;
 		mutable core::Vector<std::unique_ptr<ThreadLocalDevice>> _thread_devices;
 
+		// declared before _resources as it holds meshes
+		std::unique_ptr<MeshAllocator> _mesh_allocator;
+
 		DeviceResources _resources;
 
 		struct {
@@ -31,62 +31,121 @@ SOFTWARE.
 namespace yave {
 
 LifetimeManager::LifetimeManager(DevicePtr dptr) : DeviceLinked(dptr) {
+	for(usize i = 0; i != initial_in_flight_ring_size; ++i) {
+		_in_flight.emplace_back();
+	}
 }
 
 LifetimeManager::~LifetimeManager() {
-	std::unique_lock lock(_lock);
-	for(auto& r : _to_destroy) {
-		destroy_resource(r.second);
-	}
+	_to_destroy.collect_all([this](ManagedResource& resource) { destroy_resource(resource); });
 }
 
 ResourceFence LifetimeManager::create_fence() {
 	return ++_counter;
 }
 
+ResourceFence LifetimeManager::last_fence() const {
+	return ResourceFence(_counter);
+}
+
+bool LifetimeManager::is_complete(ResourceFence fence) const {
+	return fence._value <= _done_counter;
+}
+
 void LifetimeManager::recycle(CmdBufferData&& cmd) {
 	y_profile();
-	std::unique_lock lock(_lock);
-	auto it = std::lower_bound(_in_flight.begin(), _in_flight.end(), cmd,
-								[](const auto& a, const auto& b) { return a.resource_fence() < b.resource_fence(); });
-	_in_flight.insert(it, std::move(cmd));
+	bool next = false;
+	{
+		std::unique_lock lock(_lock);
+		const u64 fence = cmd.resource_fence()._value;
+		if(fence - _done_counter > _in_flight.size()) {
+			grow_in_flight(fence);
+		}
 
-	if(_in_flight.front().resource_fence()._value == _done_counter + 1) {
-		collect();
+		CmdBufferData& slot = _in_flight[fence % _in_flight.size()];
+		y_debug_assert(!slot.pool());
+		slot = std::move(cmd);
+		++_in_flight_count;
+
+		next = fence == _done_counter + 1;
 	}
 
-	y_debug_assert(_in_flight.size() < 256);
+	if(next) {
+		collect();
+	}
 }
 
 void LifetimeManager::collect() {
-	u64 next = _done_counter;
-	while(!_in_flight.empty()) {
-		CmdBufferData& cmd = _in_flight.front();
-		u64 fence = cmd.resource_fence()._value;
-		if(fence == next + 1 && device()->vk_device().getFenceStatus(cmd.vk_fence()) == vk::Result::eSuccess) {
-			if(cmd.pool()) {
-				cmd.pool()->release(std::move(cmd));
+	u64 done = 0;
+	{
+		std::unique_lock lock(_lock);
+		u64 next = _done_counter;
+		for(;;) {
+			CmdBufferData& cmd = _in_flight[(next + 1) % _in_flight.size()];
+			if(!cmd.pool() || !is_signaled(cmd, next)) {
+				break;
 			}
+			y_debug_assert(cmd.resource_fence()._value == next + 1);
 
-			next = fence;
-			_in_flight.pop_front();
-		} else {
-			break;
+			// leaves the slot empty
+			cmd.pool()->release(std::move(cmd));
+			--_in_flight_count;
+			++next;
 		}
+
+		if(next == _done_counter) {
+			return;
+		}
+		_done_counter = done = next;
 	}
-	if(next != _done_counter) {
-		clear_resources(_done_counter = next);
+
+	clear_resources(done);
+}
+
+// every buffer in flight has a fence in ]_done_counter, fence], so they can't collide in a ring of at least fence - _done_counter slots
+void LifetimeManager::grow_in_flight(u64 fence) {
+	y_profile();
+
+	usize size = _in_flight.size();
+	while(size < fence - _done_counter) {
+		size *= 2;
+	}
+
+	core::Vector<CmdBufferData> in_flight;
+	in_flight.set_min_capacity(size);
+	for(usize i = 0; i != size; ++i) {
+		in_flight.emplace_back();
+	}
+
+	for(CmdBufferData& cmd : _in_flight) {
+		if(cmd.pool()) {
+			in_flight[cmd.resource_fence()._value % size] = std::move(cmd);
+		}
 	}
+
+	_in_flight = std::move(in_flight);
+}
+
+bool LifetimeManager::is_signaled(const CmdBufferData& cmd, u64 done) const {
+	if(!cmd.is_batched()) {
+		return device()->vk_device().getFenceStatus(cmd.vk_fence()) == vk::Result::eSuccess;
+	}
+
+	// The last buffer of the batch is retired once its fence has been signaled, after which its fence might be reset and reused.
+	// As the whole batch completes at once, cmd is done if that buffer has already been retired.
+	if(cmd.batch_resource_fence()._value <= done) {
+		return true;
+	}
+	return device()->vk_device().getFenceStatus(cmd.vk_batch_fence()) == vk::Result::eSuccess;
 }
 
 usize LifetimeManager::pending_deletions() const {
-	std::unique_lock lock(_lock);
 	return _to_destroy.size();
 }
 
 usize LifetimeManager::active_cmd_buffers() const {
 	std::unique_lock lock(_lock);
-	return _in_flight.size();
+	return _in_flight_count;
 }
 
 void LifetimeManager::destroy_resource(ManagedResource& resource) const {
@@ -102,10 +161,7 @@ void LifetimeManager::destroy_resource(ManagedResource& resource) const {
 }
 
 void LifetimeManager::clear_resources(u64 up_to) {
-	while(!_to_destroy.empty() && _to_destroy.front().first <= up_to) {
-		destroy_resource(_to_destroy.front().second);
-		_to_destroy.pop_front();
-	}
+	_to_destroy.collect(up_to, [this](ManagedResource& resource) { destroy_resource(resource); });
 }
 
 
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_DEVICE_LIFETIMEMANAGER_H
 
 #include "DeviceLinked.h"
+#include "DeferredQueue.h"
 
 #include <yave/graphics/memory/DeviceMemory.h>
 
@@ -32,7 +33,6 @@ SOFTWARE.
 
 #include <variant>
 #include <mutex>
-#include <deque>
 
 namespace yave {
 
@@ -106,12 +106,20 @@ using ManagedResource = std::variant<
 
 class LifetimeManager : NonCopyable, public DeviceLinked {
 
+	// command buffers are stored at the index of their fence, modulo the size of the ring
+	// the ring grows when more command buffers than it can hold are in flight
+	static constexpr usize initial_in_flight_ring_size = 1024;
+
 	public:
 		LifetimeManager(DevicePtr dptr);
 		~LifetimeManager();
 
 		ResourceFence create_fence();
 
+		// fence that will be reached once every command buffer created so far has completed
+		ResourceFence last_fence() const;
+		bool is_complete(ResourceFence fence) const;
+
 		void recycle(CmdBufferData&& cmd);
 
 		usize pending_deletions() const;
@@ -124,22 +132,24 @@ class LifetimeManager : NonCopyable, public DeviceLinked {
 
 		template<typename T>
 		void destroy_later(T&& t) {
-			std::unique_lock lock(_lock);
-			_to_destroy.emplace_back(_counter, ManagedResource(y_fwd(t)));
+			_to_destroy.push(_counter, ManagedResource(y_fwd(t)));
 		}
 
 	private:
 		void collect();
+		void grow_in_flight(u64 fence);
+		bool is_signaled(const CmdBufferData& cmd, u64 done) const;
 		void destroy_resource(ManagedResource& resource) const;
 		void clear_resources(u64 up_to);
 
-		std::deque<std::pair<u64, ManagedResource>> _to_destroy;
-		std::deque<CmdBufferData> _in_flight;
+		DeferredQueue<ManagedResource> _to_destroy;
 
 		mutable concurrent::SpinLock _lock;
+		core::Vector<CmdBufferData> _in_flight;
+		usize _in_flight_count = 0;
 
 		std::atomic<u64> _counter = 0;
-		u64 _done_counter = 0;
+		std::atomic<u64> _done_counter = 0;
 };
 
 }
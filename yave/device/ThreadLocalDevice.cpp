@@ -28,6 +28,7 @@ namespace yave {
 ThreadLocalDevice::ThreadLocalDevice(DevicePtr dptr) :
 		DeviceLinked(dptr),
 		_disposable_cmd_pool(dptr),
+		_secondary_cmd_pool(dptr),
 		_descriptor_layout_pool(std::make_unique<DescriptorSetLayoutPool>(dptr)) {
 }
 
@@ -35,4 +36,8 @@ CmdBuffer<CmdBufferUsage::Disposable> ThreadLocalDevice::create_disposable_cmd_b
 	return _disposable_cmd_pool.create_buffer();
 }
 
+CmdBuffer<CmdBufferUsage::Secondary> ThreadLocalDevice::create_secondary_cmd_buffer() const {
+	return _secondary_cmd_pool.create_buffer();
+}
+
 }
@@ -35,6 +35,7 @@ class ThreadLocalDevice : NonMovable, public DeviceLinked {
 		ThreadLocalDevice(DevicePtr dptr);
 
 		CmdBuffer<CmdBufferUsage::Disposable> create_disposable_cmd_buffer() const;
+		CmdBuffer<CmdBufferUsage::Secondary> create_secondary_cmd_buffer() const;
 
 		template<typename T>
 		auto create_descriptor_set_layout(T&& t) const {
@@ -43,6 +44,7 @@ class ThreadLocalDevice : NonMovable, public DeviceLinked {
 
 	private:
 		mutable CmdBufferPool<CmdBufferUsage::Disposable> _disposable_cmd_pool;
+		mutable CmdBufferPool<CmdBufferUsage::Secondary> _secondary_cmd_pool;
 
 		std::unique_ptr<DescriptorSetLayoutPool> _descriptor_layout_pool;
 };
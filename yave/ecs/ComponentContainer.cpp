@@ -23,9 +23,53 @@ SOFTWARE.
 #include "ComponentContainer.h"
 #include "EntityWorld.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace yave {
 namespace ecs {
 
+static usize lowest_bit(u64 bits) {
+	y_debug_assert(bits);
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward64(&index, bits);
+	return index;
+#else
+	return usize(__builtin_ctzll(bits));
+#endif
+}
+
+void ComponentContainerBase::flush_mutations() {
+	_flushed_mutations.indexes.make_empty();
+	_flushed_mutations.all = _all_mutated.exchange(false, std::memory_order_relaxed);
+	for(usize i = 0; i != _mutated_words; ++i) {
+		u64 bits = _mutated[i].exchange(0, std::memory_order_relaxed);
+		if(_flushed_mutations.all) {
+			continue;
+		}
+		for(; bits; bits &= bits - 1) {
+			_flushed_mutations.indexes << EntityIndex(i * 64 + lowest_bit(bits));
+		}
+	}
+}
+
+void ComponentContainerBase::reserve_mutations(EntityIndex index) {
+	const usize words = usize(index) / 64 + 1;
+	if(words <= _mutated_words) {
+		return;
+	}
+
+	const usize new_words = std::max(words, _mutated_words * 2);
+	auto mutated = std::make_unique<std::atomic<u64>[]>(new_words);
+	for(usize i = 0; i != _mutated_words; ++i) {
+		mutated[i].store(_mutated[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	_mutated = std::move(mutated);
+	_mutated_words = new_words;
+}
+
 namespace detail {
 static RegisteredContainerType* registered_types_head = nullptr;
 struct MagicNumber{};
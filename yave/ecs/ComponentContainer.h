@@ -30,6 +30,8 @@ SOFTWARE.
 #include <y/core/SparseVector.h>
 
 #include <unordered_map>
+#include <atomic>
+#include <memory>
 
 
 namespace yave {
@@ -38,6 +40,15 @@ namespace ecs {
 template<typename T>
 using ComponentVector = core::SparseVector<T, EntityIndex>;
 
+// Components that might have been modified between two EntityWorld::flush.
+// Components are considered modified as soon as they are created or accessed through a non const path.
+// Mutations are recorded in an atomic bitset, so components can be accessed mutably from several threads,
+// but flush must not run concurrently with any other access to the world.
+struct ComponentMutations {
+	core::Vector<EntityIndex> indexes;
+	bool all = false;
+};
+
 
 class ComponentContainerBase;
 
@@ -80,11 +91,33 @@ class ComponentContainerBase : NonMovable {
 			return _type;
 		}
 
+		const ComponentMutations& flushed_mutations() const {
+			return _flushed_mutations;
+		}
+
+		void flush_mutations();
+
+		void set_all_mutated() {
+			_all_mutated.store(true, std::memory_order_relaxed);
+		}
+
+		void set_mutated(EntityIndex index) {
+			const usize word = usize(index) / 64;
+			if(word < _mutated_words) {
+				_mutated[word].fetch_or(u64(1) << (usize(index) % 64), std::memory_order_relaxed);
+			} else {
+				// components inserted without going through create
+				set_all_mutated();
+			}
+		}
+
 
 
 		template<typename T, typename... Args>
 		T& create(EntityId id, Args&&... args) {
 			auto i = id.index();
+			reserve_mutations(i);
+			set_mutated(i);
 			return component_vector_fast<T>().insert(i, y_fwd(args)...);
 		}
 
@@ -92,6 +125,8 @@ class ComponentContainerBase : NonMovable {
 		T& create_or_find(EntityId id, Args&&... args) {
 			auto i = id.index();
 			auto& vec = component_vector_fast<T>();
+			reserve_mutations(i);
+			set_mutated(i);
 			if(!vec.has(i)) {
 				return vec.insert(i, y_fwd(args)...);
 			}
@@ -100,6 +135,7 @@ class ComponentContainerBase : NonMovable {
 
 		template<typename T>
 		T& component(EntityId id) {
+			set_mutated(id.index());
 			return component_vector_fast<T>()[id.index()];
 		}
 
@@ -110,7 +146,11 @@ class ComponentContainerBase : NonMovable {
 
 		template<typename T>
 		T* component_ptr(EntityId id) {
-			return component_vector_fast<T>().try_get(id.index());
+			T* comp = component_vector_fast<T>().try_get(id.index());
+			if(comp) {
+				set_mutated(id.index());
+			}
+			return comp;
 		}
 
 		template<typename T>
@@ -127,6 +167,7 @@ class ComponentContainerBase : NonMovable {
 
 		template<typename T>
 		core::MutableSpan<T> components() {
+			set_all_mutated();
 			return component_vector_fast<T>().values();
 		}
 
@@ -136,6 +177,7 @@ class ComponentContainerBase : NonMovable {
 		}
 
 
+		// Doesn't track mutations: callers that hand out mutable components should call set_mutated() or set_all_mutated()
 		template<typename T>
 		ComponentVector<T>& component_vector() {
 			return component_vector_fast<T>();
@@ -151,8 +193,12 @@ class ComponentContainerBase : NonMovable {
 		ComponentContainerBase(ComponentVector<T>& sparse) :
 				_sparse_ptr(&sparse),
 				_type(index_for_type<T>()) {
+			// new containers (deserialized or not) are filled without going through create
+			set_all_mutated();
 		}
 
+		// Creating components isn't thread safe anyway, so growing the bitset doesn't need to be
+		void reserve_mutations(EntityIndex index);
 
 
 		template<typename T>
@@ -174,6 +220,12 @@ class ComponentContainerBase : NonMovable {
 		void* _sparse_ptr = nullptr;
 		const ComponentTypeIndex _type;
 
+		std::unique_ptr<std::atomic<u64>[]> _mutated;
+		usize _mutated_words = 0;
+		std::atomic<bool> _all_mutated = false;
+
+		ComponentMutations _flushed_mutations;
+
 
 	private:
 		friend serde2::Result detail::serialize_container(WritableAssetArchive&, ComponentContainerBase*);
@@ -198,6 +250,7 @@ class ComponentContainer final : public ComponentContainerBase {
 
 		void add(const ComponentContainerBase* other, const std::unordered_map<EntityIndex, EntityId>& id_map) override {
 			y_profile();
+			set_all_mutated();
 			if(const ComponentContainer<T>* container = dynamic_cast<const ComponentContainer<T>*>(other)) {
 				for(const auto& [index, comp] : container->_components.as_pairs()) {
 					if(auto it = id_map.find(index); it != id_map.end()) {
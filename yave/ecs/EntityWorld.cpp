@@ -59,7 +59,20 @@ void EntityWorld::flush() {
 	for(EntityId id : _deletions) {
 		_entities.recycle(id);
 	}
-	_deletions.clear();
+	for(const auto& c : _component_containers) {
+		c.second->flush_mutations();
+	}
+	std::swap(_deletions, _flushed_deletions);
+	_deletions.make_empty();
+	++_flush_count;
+}
+
+u64 EntityWorld::flush_count() const {
+	return _flush_count;
+}
+
+core::Span<EntityId> EntityWorld::flushed_deletions() const {
+	return _flushed_deletions;
 }
 
 void EntityWorld::add(const EntityWorld& other) {
@@ -96,6 +96,20 @@ class EntityWorld : NonCopyable {
 
 		void flush();
 
+		// Number of times flush() has been called
+		u64 flush_count() const;
+
+		// Entities removed by the last flush
+		core::Span<EntityId> flushed_deletions() const;
+
+		// Components of type T created or accessed mutably between the last two flushes
+		template<typename T>
+		const ComponentMutations& flushed_mutations() const {
+			static const ComponentMutations none;
+			const ComponentContainerBase* cont = container<T>();
+			return cont ? cont->flushed_mutations() : none;
+		}
+
 
 		void add(const EntityWorld& other);
 
@@ -186,7 +200,7 @@ class EntityWorld : NonCopyable {
 		template<typename... Args>
 		EntityView<Args...> view() {
 			static_assert(sizeof...(Args));
-			return EntityView<Args...>(typed_component_vectors<Args...>());
+			return EntityView<Args...>(typed_component_vectors<Args...>(), {container<Args>()...});
 		}
 
 		template<typename... Args>
@@ -245,6 +259,11 @@ class EntityWorld : NonCopyable {
 	private:
 		template<typename T>
 		ComponentContainerBase* container() {
+			// components can be accessed mutably from several threads as long as their container exists
+			if(const auto it = _component_containers.find(index_for_type<T>()); it != _component_containers.end() && it->second) {
+				return it->second.get();
+			}
+
 			auto& container = _component_containers[index_for_type<T>()];
 			if(!container) {
 				container = std::make_unique<ComponentContainer<T>>();
@@ -277,6 +296,8 @@ class EntityWorld : NonCopyable {
 
 		EntityIdPool _entities;
 		core::Vector<EntityId> _deletions;
+		core::Vector<EntityId> _flushed_deletions;
+		u64 _flush_count = 0;
 
 		std::unordered_map<ComponentTypeIndex, std::unique_ptr<ComponentContainerBase>> _component_containers;
 };
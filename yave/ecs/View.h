@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "ComponentContainer.h"
 
+#include <array>
+
 namespace yave {
 namespace ecs {
 
@@ -55,6 +57,11 @@ class View {
 				std::tuple<const Args&...>,
 				std::tuple<Args&...>>;
 
+	// mutable views record the components they hand out in their container
+	using container_array = std::conditional_t<Const,
+				std::tuple<>,
+				std::array<ComponentContainerBase*, sizeof...(Args)>>;
+
 	using index_type = ComponentVector<void>::index_type;
 	using index_range = decltype(std::declval<ComponentVector<void>>().indexes());
 
@@ -95,10 +102,8 @@ class View {
 
 			template<typename T>
 			auto&& component() const {
-				using type = std::conditional_t<Const, const std::decay_t<T>&, std::decay_t<T>>;
-				constexpr usize index = detail::tuple_index<type, decltype(components())>::value;
-				static_assert(std::is_same_v<type, std::tuple_element_t<index, decltype(components())>>);
-				return std::get<index>(components());
+				constexpr usize index = detail::tuple_index<std::decay_t<T>, std::tuple<Args...>>::value;
+				return _it->template component<index>();
 			}
 
 			IndexComponents(const It* it) : _it(it) {
@@ -121,14 +126,12 @@ class View {
 	template<template<typename> class ReturnPolicy>
 	class Iterator : public ReturnPolicy<Iterator<ReturnPolicy>> {
 		template<usize I = 0>
-		auto make_refence_tuple(index_type index) const {
-			y_debug_assert(std::get<I>(_vectors));
-			auto& v = *std::get<I>(_vectors);
+		auto make_refence_tuple() const {
 			if constexpr(I + 1 == sizeof...(Args)) {
-				return std::tie(v[index]);
+				return std::tie(component<I>());
 			} else {
-				return std::tuple_cat(std::tie(v[*_it]),
-									  make_refence_tuple<I + 1>(index));
+				return std::tuple_cat(std::tie(component<I>()),
+									  make_refence_tuple<I + 1>());
 			}
 		}
 
@@ -137,7 +140,17 @@ class View {
 			using iterator_category = std::input_iterator_tag;
 
 			reference_tuple components() const {
-				return make_refence_tuple(*_it);
+				return make_refence_tuple();
+			}
+
+			template<usize I>
+			auto& component() const {
+				y_debug_assert(std::get<I>(_vectors));
+				if constexpr(!Const) {
+					y_debug_assert(_containers[I]);
+					_containers[I]->set_mutated(*_it);
+				}
+				return (*std::get<I>(_vectors))[*_it];
 			}
 
 			index_type index() const {
@@ -178,10 +191,11 @@ class View {
 		private:
 			friend class View;
 
-			Iterator(index_range range, const vector_tuple& vecs) :
+			Iterator(index_range range, const vector_tuple& vecs, const container_array& containers) :
 					_it(range.begin()),
 					_end(range.end()),
-					_vectors(vecs) {
+					_vectors(vecs),
+					_containers(containers) {
 
 				skip();
 			}
@@ -209,6 +223,7 @@ class View {
 			typename index_range::const_iterator _it;
 			typename index_range::const_iterator _end;
 			vector_tuple _vectors;
+			container_array _containers;
 	};
 
 
@@ -238,12 +253,12 @@ class View {
 
 		using end_iterator = EndIterator;
 
-		View(const vector_tuple& vecs) : _vectors(vecs), _short(shortest_range()) {
+		View(const vector_tuple& vecs, const container_array& containers = {}) : _vectors(vecs), _containers(containers), _short(shortest_range()) {
 		}
 
 
 		const_iterator begin() const {
-			return const_iterator(_short, _vectors);
+			return const_iterator(_short, _vectors, _containers);
 		}
 
 		end_iterator end() const {
@@ -251,17 +266,18 @@ class View {
 		}
 
 		auto components() const {
-			return core::Range(const_component_iterator(_short, _vectors), end_iterator());
+			return core::Range(const_component_iterator(_short, _vectors, _containers), end_iterator());
 		}
 
 		auto indexes() const {
-			return core::Range(const_index_iterator(_short, _vectors), end_iterator());
+			return core::Range(const_index_iterator(_short, _vectors, _containers), end_iterator());
 		}
 
 
 
 	private:
 		vector_tuple _vectors;
+		container_array _containers;
 		index_range _short;
 };
 
@@ -22,6 +22,10 @@ SOFTWARE.
 
 #include "FrameGraph.h"
 
+#include <y/concurrent/concurrent.h>
+
+#include <unordered_set>
+
 namespace yave {
 
 template<typename U>
@@ -91,30 +95,62 @@ const FrameGraphResourcePool* FrameGraph::resources() const {
 	return _pool.get();
 }
 
+void FrameGraph::set_parallel_recording(bool enabled) {
+	_parallel_recording = enabled;
+}
+
 void FrameGraph::render(CmdBufferRecorder& recorder) && {
 	y_profile();
-	Y_TODO(Pass culling)
 
+	compile();
 	alloc_resources();
 
+	{
+		y_profile_zone("init");
+		for(const auto& pass : _passes) {
+			pass->init_framebuffer(_pool.get());
+			pass->init_descriptor_sets(_pool.get());
+		}
+	}
+
+	// secondary buffers only depend on the framebuffer and descriptor sets of their pass,
+	// so they can be recorded while the rest of the graph is
+	core::Vector<std::future<core::Vector<RecordedSecondaryCmdBuffer>>> secondaries;
+	for(const auto& pass : _passes) {
+		auto& future = secondaries.emplace_back();
+		if(pass->_records_secondaries) {
+			const FrameGraphPass* p = pass.get();
+			future = _parallel_recording
+				? concurrent::async([p] { return p->render_secondaries(); })
+				: std::async(std::launch::deferred, [p] { return p->render_secondaries(); });
+		}
+	}
+
+	FrameGraphTimestamps* timestamps = _pool->timestamps();
+	if(timestamps) {
+		timestamps->begin_frame(recorder, _pool->pass_timings());
+	}
+
 	std::unordered_map<FrameGraphResourceId, PipelineStage> to_barrier;
 	core::Vector<BufferBarrier> buffer_barriers;
 	core::Vector<ImageBarrier> image_barriers;
-	for(const auto& pass : _passes) {
+	for(usize i = 0; i != _passes.size(); ++i) {
+		const auto& pass = _passes[i];
 		y_profile_zone(pass->name());
 		auto region = recorder.region(pass->name());
+		if(timestamps) {
+			timestamps->begin_pass(recorder, pass->name());
+		}
 
 		{
 			y_profile_zone("prepare");
+			buffer_barriers.make_empty();
+			image_barriers.make_empty();
+			build_aliasing_barriers(pass.get(), buffer_barriers, image_barriers);
+			recorder.barriers(buffer_barriers, image_barriers);
 			copy_images(recorder, pass->_image_copies, to_barrier, _pool.get());
 		}
 
-		{
-			y_profile_zone("init");
-			pass->init_framebuffer(_pool.get());
-			pass->init_descriptor_sets(_pool.get());
-		}
-
 		{
 			y_profile_zone("barriers");
 			buffer_barriers.make_empty();
@@ -126,30 +162,197 @@ void FrameGraph::render(CmdBufferRecorder& recorder) && {
 
 		{
 			y_profile_zone("render");
-			pass->render(recorder);
+			if(secondaries[i].valid()) {
+				recorder.execute(pass->framebuffer(), secondaries[i].get());
+			} else {
+				pass->render(recorder);
+			}
 		}
+
+		if(timestamps) {
+			timestamps->end_pass(recorder);
+		}
+	}
+
+	if(timestamps) {
+		timestamps->end_frame();
 	}
 
 
 	Y_TODO(put resource barriers at the end of the graph to prevent clash with whatever comes after)
 
 	release_resources(recorder);
+	_pool->garbage_collect();
+}
+
+void FrameGraph::compile() {
+	y_profile();
+
+	std::unordered_set<FrameGraphResourceId, hash_t> alive_resources;
+	std::unordered_set<const FrameGraphPass*> alive_passes;
+	core::Vector<const FrameGraphPass*> to_visit;
+
+	auto visit_pass = [&](const FrameGraphPass* pass) {
+		if(alive_passes.insert(pass).second) {
+			to_visit << pass;
+		}
+	};
+
+	auto visit_resource = [&](FrameGraphResourceId res, const ResourceCreateInfo& info) {
+		if(alive_resources.insert(res).second) {
+			for(const FrameGraphPass* writer : info.writers) {
+				visit_pass(writer);
+			}
+		}
+	};
+
+	for(auto&& [res, info] : _images) {
+		if(info.is_output) {
+			visit_resource(res, info);
+		}
+	}
+	for(auto&& [res, info] : _buffers) {
+		if(info.is_output) {
+			visit_resource(res, info);
+		}
+	}
+	for(const auto& pass : _passes) {
+		if(pass->_has_side_effects) {
+			visit_pass(pass.get());
+		}
+	}
+
+	// every resource used by a live pass is live, as are all the passes writing to it
+	while(!to_visit.is_empty()) {
+		const FrameGraphPass* pass = to_visit.pop();
+		for(auto&& [res, usage] : pass->_images) {
+			visit_resource(res, check_exists(_images, res));
+		}
+		for(auto&& [res, usage] : pass->_buffers) {
+			visit_resource(res, check_exists(_buffers, res));
+		}
+	}
+
+	core::String culled;
+	{
+		decltype(_passes) passes;
+		for(auto& pass : _passes) {
+			if(alive_passes.find(pass.get()) != alive_passes.end()) {
+				passes << std::move(pass);
+			} else {
+				if(!culled.is_empty()) {
+					culled += ", ";
+				}
+				culled += pass->name();
+			}
+		}
+		_passes = std::move(passes);
+	}
+
+	usize culled_resources = 0;
+	auto cull_resources = [&](auto& resources) {
+		for(auto it = resources.begin(); it != resources.end();) {
+			if(alive_resources.find(it->first) == alive_resources.end()) {
+				it = resources.erase(it);
+				++culled_resources;
+			} else {
+				++it;
+			}
+		}
+	};
+	cull_resources(_images);
+	cull_resources(_buffers);
+
+	if(!culled.is_empty() || culled_resources) {
+		log_msg(fmt("Frame graph culled passes: [%] and % resources.", culled, culled_resources), Log::Debug);
+	}
+
+	compute_lifetimes();
+}
+
+void FrameGraph::compute_lifetimes() {
+	// culled passes no longer extend lifetimes, which lets more resources share memory
+	auto reset = [](auto& resources) {
+		for(auto&& [res, info] : resources) {
+			unused(res);
+			info.first_use = 0;
+			info.last_use = 0;
+		}
+	};
+	reset(_images);
+	reset(_buffers);
+
+	usize last_pass = 0;
+	for(const auto& pass : _passes) {
+		const usize index = pass->_index;
+		for(auto&& [res, usage] : pass->_images) {
+			auto& info = check_exists(_images, res);
+			info.first_use = info.first_use ? info.first_use : index;
+			info.last_use = std::max(info.last_use, index);
+		}
+		for(auto&& [res, usage] : pass->_buffers) {
+			auto& info = check_exists(_buffers, res);
+			info.first_use = info.first_use ? info.first_use : index;
+			info.last_use = std::max(info.last_use, index);
+		}
+		last_pass = std::max(last_pass, index);
+	}
+
+	// outputs must survive until the end of the graph
+	auto extend_outputs = [=](auto& resources) {
+		for(auto&& [res, info] : resources) {
+			unused(res);
+			if(info.is_output) {
+				info.last_use = last_pass;
+			}
+		}
+	};
+	extend_outputs(_images);
+	extend_outputs(_buffers);
+}
+
+void FrameGraph::build_aliasing_barriers(const FrameGraphPass* pass, core::Vector<BufferBarrier>& buffer_barriers, core::Vector<ImageBarrier>& image_barriers) const {
+	// aliased resources don't have meaningful content before their first use
+	for(auto&& [res, usage] : pass->_images) {
+		unused(usage);
+		if(check_exists(_images, res).first_use == pass->_index && _pool->is_aliased(res)) {
+			image_barriers << _pool->aliasing_barrier(res);
+		}
+	}
+	for(auto&& [res, usage] : pass->_buffers) {
+		unused(usage);
+		if(check_exists(_buffers, res).first_use == pass->_index && _pool->is_aliased(res)) {
+			buffer_barriers << _pool->aliasing_barrier(res);
+		}
+	}
 }
 
 void FrameGraph::alloc_resources() {
 	y_profile();
+
+	auto aliased_images = core::vector_with_capacity<FrameGraphResourcePool::AliasedImageCreateInfo>(_images.size());
+	core::Vector<FrameGraphResourcePool::AliasedBufferCreateInfo> aliased_buffers;
+
 	for(auto&& [res, info] : _images) {
 		if(is_none(info.usage)) {
 			y_fatal("Unused frame graph image resource.");
 		}
-		_pool->create_image(res, info.format, info.size, info.usage);
+		aliased_images << FrameGraphResourcePool::AliasedImageCreateInfo{res, info.format, info.size, info.usage, info.first_use, info.last_use};
 	}
 	for(auto&& [res, info] : _buffers) {
 		if(is_none(info.usage)) {
 			y_fatal("Unused frame graph buffer resource.");
 		}
-		_pool->create_buffer(res, info.byte_size, info.usage, info.memory_type);
+		const MemoryType memory = info.memory_type == MemoryType::DontCare ? prefered_memory_type(info.usage) : info.memory_type;
+		if(memory == MemoryType::DeviceLocal) {
+			aliased_buffers << FrameGraphResourcePool::AliasedBufferCreateInfo{res, info.byte_size, info.usage, info.first_use, info.last_use};
+		} else {
+			// mapped buffers are written by the CPU before any pass runs, they can't alias anything
+			_pool->create_buffer(res, info.byte_size, info.usage, memory);
+		}
 	}
+
+	_pool->create_aliased_resources(aliased_images, aliased_buffers);
 }
 
 void FrameGraph::release_resources(CmdBufferRecorder& recorder) {
@@ -207,6 +410,28 @@ FrameGraphPassBuilder FrameGraph::add_pass(std::string_view name) {
 	return FrameGraphPassBuilder(ptr);
 }
 
+void FrameGraph::mark_as_output(FrameGraphImageId res) {
+	check_exists(_images, res).is_output = true;
+}
+
+void FrameGraph::mark_as_output(FrameGraphBufferId res) {
+	check_exists(_buffers, res).is_output = true;
+}
+
+core::Vector<const FrameGraphPass*> FrameGraph::passes() const {
+	auto passes = core::vector_with_capacity<const FrameGraphPass*>(_passes.size());
+	std::transform(_passes.begin(), _passes.end(), std::back_inserter(passes), [](const auto& pass) { return pass.get(); });
+	return passes;
+}
+
+bool FrameGraph::has_resource(FrameGraphImageId res) const {
+	return _images.find(res) != _images.end();
+}
+
+bool FrameGraph::has_resource(FrameGraphBufferId res) const {
+	return _buffers.find(res) != _buffers.end();
+}
+
 const FrameGraph::ImageCreateInfo& FrameGraph::info(FrameGraphImageId res) const {
 	return check_exists(_images, res);
 }
@@ -215,29 +440,33 @@ const FrameGraph::BufferCreateInfo& FrameGraph::info(FrameGraphBufferId res) con
 	return check_exists(_buffers, res);
 }
 
-void FrameGraph::ResourceCreateInfo::register_use(usize index) {
+void FrameGraph::ResourceCreateInfo::register_use(usize index, bool is_written, const FrameGraphPass* pass) {
 	if(!first_use) {
 		first_use = index;
 	}
 	last_use = std::max(last_use,index);
+	if(is_written && std::find(writers.begin(), writers.end(), pass) == writers.end()) {
+		writers << pass;
+	}
 }
 
-void FrameGraph::register_usage(FrameGraphImageId res, ImageUsage usage, const FrameGraphPass* pass) {
+void FrameGraph::register_usage(FrameGraphImageId res, ImageUsage usage, bool is_written, const FrameGraphPass* pass) {
 	auto& info = check_exists(_images, res);
 	info.usage = info.usage | usage;
-	info.register_use(pass->_index);
+	info.register_use(pass->_index, is_written, pass);
 }
 
-void FrameGraph::register_usage(FrameGraphBufferId res, BufferUsage usage, const FrameGraphPass* pass) {
+void FrameGraph::register_usage(FrameGraphBufferId res, BufferUsage usage, bool is_written, const FrameGraphPass* pass) {
 	auto& info = check_exists(_buffers, res);
 	info.usage = info.usage | usage;
-	info.register_use(pass->_index);
+	info.register_use(pass->_index, is_written, pass);
 }
 
 void FrameGraph::set_cpu_visible(FrameGraphMutableBufferId res, const FrameGraphPass*pass) {
 	auto& info = check_exists(_buffers, res);
 	info.memory_type = MemoryType::CpuVisible;
-	info.register_use(pass->_index);
+	// the buffer is written through its mapping
+	info.register_use(pass->_index, true, pass);
 }
 
 bool FrameGraph::is_attachment(FrameGraphImageId res) const {
@@ -35,7 +35,10 @@ class FrameGraph : NonCopyable {
 		usize first_use = 0;
 		usize last_use = 0;
 
-		void register_use(usize index);
+		core::Vector<const FrameGraphPass*> writers;
+		bool is_output = false;
+
+		void register_use(usize index, bool is_written, const FrameGraphPass* pass);
 	};
 
 	struct ImageCreateInfo : ResourceCreateInfo {
@@ -58,8 +61,23 @@ class FrameGraph : NonCopyable {
 
 		void render(CmdBufferRecorder& recorder) &&;
 
+		// When enabled (default), passes recording secondary buffers are recorded on the thread pool
+		void set_parallel_recording(bool enabled);
+
 		FrameGraphPassBuilder add_pass(std::string_view name);
 
+		void mark_as_output(FrameGraphImageId res);
+		void mark_as_output(FrameGraphBufferId res);
+
+		// Removes passes and resources that contribute neither to an output nor to a pass with side effects.
+		// Called by render, does not need a device.
+		void compile();
+
+		core::Vector<const FrameGraphPass*> passes() const;
+
+		bool has_resource(FrameGraphImageId res) const;
+		bool has_resource(FrameGraphBufferId res) const;
+
 		math::Vec2ui image_size(FrameGraphImageId res) const;
 
 	private:
@@ -71,8 +89,8 @@ class FrameGraph : NonCopyable {
 		const ImageCreateInfo& info(FrameGraphImageId res) const;
 		const BufferCreateInfo& info(FrameGraphBufferId res) const;
 
-		void register_usage(FrameGraphImageId res, ImageUsage usage, const FrameGraphPass* pass);
-		void register_usage(FrameGraphBufferId res, BufferUsage usage, const FrameGraphPass* pass);
+		void register_usage(FrameGraphImageId res, ImageUsage usage, bool is_written, const FrameGraphPass* pass);
+		void register_usage(FrameGraphBufferId res, BufferUsage usage, bool is_written, const FrameGraphPass* pass);
 		void set_cpu_visible(FrameGraphMutableBufferId res, const FrameGraphPass* pass);
 
 		bool is_attachment(FrameGraphImageId res) const;
@@ -82,8 +100,13 @@ class FrameGraph : NonCopyable {
 		void alloc_resources();
 		void release_resources(CmdBufferRecorder& recorder);
 
+		void compute_lifetimes();
+		void build_aliasing_barriers(const FrameGraphPass* pass, core::Vector<BufferBarrier>& buffer_barriers, core::Vector<ImageBarrier>& image_barriers) const;
+
 		std::shared_ptr<FrameGraphResourcePool> _pool;
 
+		bool _parallel_recording = true;
+
 		core::Vector<std::unique_ptr<FrameGraphPass>> _passes;
 
 		using hash_t = std::hash<FrameGraphResourceId>;
@@ -51,6 +51,10 @@ void FrameGraphPass::render(CmdBufferRecorder& recorder) const {
 	_render(recorder, this);
 }
 
+core::Vector<RecordedSecondaryCmdBuffer> FrameGraphPass::render_secondaries() const {
+	return _render_secondaries(this);
+}
+
 void FrameGraphPass::init_framebuffer(FrameGraphResourcePool* pool) {
 	y_profile();
 	if(_depth.image.is_valid() || _colors.size()) {
@@ -71,7 +75,7 @@ void FrameGraphPass::init_descriptor_sets(FrameGraphResourcePool* pool) {
 	for(const auto& set : _bindings) {
 		auto bindings = core::vector_with_capacity<Binding>(set.size());
 		std::transform(set.begin(), set.end(), std::back_inserter(bindings), [=](const FrameGraphDescriptorBinding& b) { return b.create_binding(pool); });
-		_descriptor_sets << DescriptorSet(pool->device(), bindings);
+		_descriptor_sets << DescriptorSet(pool->device(), bindings, DescriptorSet::Lifetime::Transient);
 	}
 }
 
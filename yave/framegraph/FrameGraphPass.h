@@ -29,7 +29,7 @@ SOFTWARE.
 #include <yave/graphics/images/Image.h>
 #include <yave/graphics/buffers/buffers.h>
 #include <yave/graphics/framebuffer/Framebuffer.h>
-#include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/commands/RecordedCmdBuffer.h>
 
 #include "FrameGraphResourceId.h"
 #include "FrameGraphDescriptorBinding.h"
@@ -50,6 +50,9 @@ class FrameGraphPass final : NonMovable {
 
 		using render_func = core::Function<void(CmdBufferRecorder&, const FrameGraphPass*)>;
 
+		// Records the content of the pass' framebuffer, might be called from any thread
+		using secondary_render_func = core::Function<core::Vector<RecordedSecondaryCmdBuffer>(const FrameGraphPass*)>;
+
 		FrameGraphPass(std::string_view name, FrameGraph* parent, usize index);
 
 		const core::String& name() const;
@@ -59,6 +62,7 @@ class FrameGraphPass final : NonMovable {
 		core::ArrayView<DescriptorSet> descriptor_sets() const;
 
 		void render(CmdBufferRecorder& recorder) const;
+		core::Vector<RecordedSecondaryCmdBuffer> render_secondaries() const;
 
 	private:
 		friend class FrameGraph;
@@ -68,11 +72,15 @@ class FrameGraphPass final : NonMovable {
 		void init_descriptor_sets(FrameGraphResourcePool* pool);
 
 		render_func _render = [](CmdBufferRecorder&, const FrameGraphPass*) {};
+		secondary_render_func _render_secondaries = [](const FrameGraphPass*) { return core::Vector<RecordedSecondaryCmdBuffer>(); };
+		bool _records_secondaries = false;
 		core::String _name;
 
 		FrameGraph* _parent = nullptr;
 		const usize _index;
 
+		bool _has_side_effects = false;
+
 		using hash_t = std::hash<FrameGraphResourceId>;
 		std::unordered_map<FrameGraphImageId, ResourceUsageInfo, hash_t> _images;
 		std::unordered_map<FrameGraphBufferId, ResourceUsageInfo, hash_t> _buffers;
@@ -30,6 +30,16 @@ FrameGraphPassBuilder::FrameGraphPassBuilder(FrameGraphPass* pass) : _pass(pass)
 
 void FrameGraphPassBuilder::set_render_func(FrameGraphPass::render_func&& func) {
 	_pass->_render = std::move(func);
+	_pass->_records_secondaries = false;
+}
+
+void FrameGraphPassBuilder::set_secondary_render_func(FrameGraphPass::secondary_render_func&& func) {
+	_pass->_render_secondaries = std::move(func);
+	_pass->_records_secondaries = true;
+}
+
+void FrameGraphPassBuilder::set_has_side_effects() {
+	_pass->_has_side_effects = true;
 }
 
 
@@ -48,8 +58,8 @@ FrameGraphMutableImageId FrameGraphPassBuilder::declare_copy(FrameGraphImageId s
 	auto res = declare_image(src_info.format, src_info.size);
 	_pass->_image_copies.emplace_back(src, res);
 	// copies are done before the pass proper so we don't set the stage
-	add_to_pass(src, ImageUsage::TransferSrcBit, PipelineStage::None);
-	add_to_pass(res, ImageUsage::TransferDstBit, PipelineStage::None);
+	add_to_pass(src, ImageUsage::TransferSrcBit, false, PipelineStage::None);
+	add_to_pass(res, ImageUsage::TransferDstBit, true, PipelineStage::None);
 	return res;
 }
 
@@ -57,7 +67,7 @@ FrameGraphMutableImageId FrameGraphPassBuilder::declare_copy(FrameGraphImageId s
 // --------------------------------- Texture ---------------------------------
 
 void FrameGraphPassBuilder::add_texture_input(FrameGraphImageId res, PipelineStage stage) {
-	add_to_pass(res, ImageUsage::TextureBit, stage);
+	add_to_pass(res, ImageUsage::TextureBit, false, stage);
 }
 
 
@@ -65,7 +75,7 @@ void FrameGraphPassBuilder::add_texture_input(FrameGraphImageId res, PipelineSta
 
 void FrameGraphPassBuilder::add_depth_output(FrameGraphMutableImageId res, Framebuffer::LoadOp load_op) {
 	// transition is done by the renderpass
-	add_to_pass(res, ImageUsage::DepthBit, PipelineStage::DepthAttachmentOutBit);
+	add_to_pass(res, ImageUsage::DepthBit, true, PipelineStage::DepthAttachmentOutBit);
 	if(_pass->_depth.image.is_valid()) {
 		y_fatal("Pass already has a depth output.");
 	}
@@ -74,7 +84,7 @@ void FrameGraphPassBuilder::add_depth_output(FrameGraphMutableImageId res, Frame
 
 void FrameGraphPassBuilder::add_color_output(FrameGraphMutableImageId res, Framebuffer::LoadOp load_op) {
 	// transition is done by the renderpass
-	add_to_pass(res, ImageUsage::ColorBit, PipelineStage::ColorAttachmentOutBit);
+	add_to_pass(res, ImageUsage::ColorBit, true, PipelineStage::ColorAttachmentOutBit);
 	_pass->_colors << FrameGraphPass::Attachment{res, load_op};
 }
 
@@ -82,31 +92,31 @@ void FrameGraphPassBuilder::add_color_output(FrameGraphMutableImageId res, Frame
 // --------------------------------- Copies ---------------------------------
 
 void FrameGraphPassBuilder::add_copy_src(FrameGraphImageId res) {
-	add_to_pass(res, ImageUsage::TransferSrcBit, PipelineStage::TransferBit);
+	add_to_pass(res, ImageUsage::TransferSrcBit, false, PipelineStage::TransferBit);
 }
 
 void FrameGraphPassBuilder::add_copy_dst(FrameGraphMutableImageId res) {
-	add_to_pass(res, ImageUsage::TransferDstBit, PipelineStage::TransferBit);
+	add_to_pass(res, ImageUsage::TransferDstBit, true, PipelineStage::TransferBit);
 }
 
 void FrameGraphPassBuilder::add_copy_src(FrameGraphBufferId res) {
-	add_to_pass(res, BufferUsage::TransferSrcBit, PipelineStage::TransferBit);
+	add_to_pass(res, BufferUsage::TransferSrcBit, false, PipelineStage::TransferBit);
 }
 
 void FrameGraphPassBuilder::add_copy_dst(FrameGraphMutableBufferId res) {
-	add_to_pass(res, BufferUsage::TransferDstBit, PipelineStage::TransferBit);
+	add_to_pass(res, BufferUsage::TransferDstBit, true, PipelineStage::TransferBit);
 }
 
 
 // --------------------------------- Storage output ---------------------------------
 
 void FrameGraphPassBuilder::add_storage_output(FrameGraphMutableImageId res, usize ds_index, PipelineStage stage) {
-	add_to_pass(res, ImageUsage::StorageBit, stage);
+	add_to_pass(res, ImageUsage::StorageBit, true, stage);
 	add_uniform(FrameGraphDescriptorBinding::create_storage_binding(res), ds_index);
 }
 
 void FrameGraphPassBuilder::add_storage_output(FrameGraphMutableBufferId res, usize ds_index, PipelineStage stage) {
-	add_to_pass(res, BufferUsage::StorageBit, stage);
+	add_to_pass(res, BufferUsage::StorageBit, true, stage);
 	add_uniform(FrameGraphDescriptorBinding::create_storage_binding(res), ds_index);
 }
 
@@ -114,12 +124,12 @@ void FrameGraphPassBuilder::add_storage_output(FrameGraphMutableBufferId res, us
 // --------------------------------- Storage intput ---------------------------------
 
 void FrameGraphPassBuilder::add_storage_input(FrameGraphBufferId res, usize ds_index, PipelineStage stage) {
-	add_to_pass(res, BufferUsage::StorageBit, stage);
+	add_to_pass(res, BufferUsage::StorageBit, false, stage);
 	add_uniform(FrameGraphDescriptorBinding::create_storage_binding(res), ds_index);
 }
 
 void FrameGraphPassBuilder::add_storage_input(FrameGraphImageId res, usize ds_index, PipelineStage stage) {
-	add_to_pass(res, ImageUsage::StorageBit, stage);
+	add_to_pass(res, ImageUsage::StorageBit, false, stage);
 	add_uniform(FrameGraphDescriptorBinding::create_storage_binding(res), ds_index);
 }
 
@@ -127,12 +137,12 @@ void FrameGraphPassBuilder::add_storage_input(FrameGraphImageId res, usize ds_in
 // --------------------------------- Uniform input ---------------------------------
 
 void FrameGraphPassBuilder::add_uniform_input(FrameGraphBufferId res, usize ds_index, PipelineStage stage) {
-	add_to_pass(res, BufferUsage::UniformBit, stage);
+	add_to_pass(res, BufferUsage::UniformBit, false, stage);
 	add_uniform(FrameGraphDescriptorBinding::create_uniform_binding(res), ds_index);
 }
 
 void FrameGraphPassBuilder::add_uniform_input(FrameGraphImageId res, usize ds_index, PipelineStage stage) {
-	add_to_pass(res, ImageUsage::TextureBit, stage);
+	add_to_pass(res, ImageUsage::TextureBit, false, stage);
 	add_uniform(FrameGraphDescriptorBinding::create_uniform_binding(res), ds_index);
 }
 
@@ -156,11 +166,15 @@ void FrameGraphPassBuilder::add_uniform_input(CubemapView tex, usize ds_index, P
 // --------------------------------- Attribs ---------------------------------
 
 void FrameGraphPassBuilder::add_attrib_input(FrameGraphBufferId res, PipelineStage stage) {
-	add_to_pass(res, BufferUsage::AttributeBit, stage);
+	add_to_pass(res, BufferUsage::AttributeBit, false, stage);
 }
 
 void FrameGraphPassBuilder::add_index_input(FrameGraphBufferId res, PipelineStage stage) {
-	add_to_pass(res, BufferUsage::IndexBit, stage);
+	add_to_pass(res, BufferUsage::IndexBit, false, stage);
+}
+
+void FrameGraphPassBuilder::add_indirect_input(FrameGraphBufferId res, PipelineStage stage) {
+	add_to_pass(res, BufferUsage::IndirectBit, false, stage);
 }
 
 
@@ -179,18 +193,18 @@ void set_stage(T& info, PipelineStage stage) {
 	info.stage = stage;
 }
 
-void FrameGraphPassBuilder::add_to_pass(FrameGraphImageId res, ImageUsage usage, PipelineStage stage) {
+void FrameGraphPassBuilder::add_to_pass(FrameGraphImageId res, ImageUsage usage, bool is_written, PipelineStage stage) {
 	res.check_valid();
 	auto& info = _pass->_images[res];
 	set_stage(info, stage);
-	parent()->register_usage(res, usage, _pass);
+	parent()->register_usage(res, usage, is_written, _pass);
 }
 
-void FrameGraphPassBuilder::add_to_pass(FrameGraphBufferId res, BufferUsage usage, PipelineStage stage) {
+void FrameGraphPassBuilder::add_to_pass(FrameGraphBufferId res, BufferUsage usage, bool is_written, PipelineStage stage) {
 	res.check_valid();
 	auto& info = _pass->_buffers[res];
 	set_stage(info, stage);
-	parent()->register_usage(res, usage, _pass);
+	parent()->register_usage(res, usage, is_written, _pass);
 }
 
 void FrameGraphPassBuilder::add_uniform(FrameGraphDescriptorBinding binding, usize ds_index) {
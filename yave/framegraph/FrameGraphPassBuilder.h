@@ -66,6 +66,7 @@ class FrameGraphPassBuilder {
 
 		void add_attrib_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::VertexInputBit);
 		void add_index_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::VertexInputBit);
+		void add_indirect_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::DrawIndirectBit);
 
 		template<typename T>
 		void map_update(FrameGraphMutableTypedBufferId<T> res) {
@@ -74,6 +75,13 @@ class FrameGraphPassBuilder {
 
 		void set_render_func(FrameGraphPass::render_func&& func);
 
+		// The pass content is recorded in secondary buffers, in parallel with the rest of the graph, and executed in the pass' framebuffer
+		void set_secondary_render_func(FrameGraphPass::secondary_render_func&& func);
+
+		// Passes with side effects (writing to external resources or to the CPU) are never culled.
+		// The graph can not see those writes: passes that don't call this are culled unless they contribute to an output.
+		void set_has_side_effects();
+
 		void add_descriptor_binding(Binding bind, usize ds_index = 0);
 
 	private:
@@ -81,8 +89,8 @@ class FrameGraphPassBuilder {
 
 		FrameGraphPassBuilder(FrameGraphPass* pass);
 
-		void add_to_pass(FrameGraphImageId res, ImageUsage usage, PipelineStage stage);
-		void add_to_pass(FrameGraphBufferId res, BufferUsage usage, PipelineStage stage);
+		void add_to_pass(FrameGraphImageId res, ImageUsage usage, bool is_written, PipelineStage stage);
+		void add_to_pass(FrameGraphBufferId res, BufferUsage usage, bool is_written, PipelineStage stage);
 
 		void add_uniform(FrameGraphDescriptorBinding binding, usize ds_index);
 
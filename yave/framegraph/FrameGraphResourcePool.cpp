@@ -21,6 +21,11 @@ SOFTWARE.
 **********************************/
 
 #include "FrameGraphResourcePool.h"
+#include "TransientMemoryLayout.h"
+
+#include <yave/device/Device.h>
+
+#include <map>
 
 namespace yave {
 
@@ -31,27 +36,48 @@ static void check_usage(U u) {
 	}
 }
 
-FrameGraphResourcePool::FrameGraphResourcePool(DevicePtr dptr) : DeviceLinked(dptr) {
+bool FrameGraphResourcePool::ImageKey::operator==(const ImageKey& other) const {
+	return format == other.format && size == other.size && usage == other.usage;
 }
 
-FrameGraphResourcePool::~FrameGraphResourcePool() {
-	if(!_images.empty() || !_buffers.empty()) {
-		y_fatal("Not all resources have been released.");
-	}
+bool FrameGraphResourcePool::BufferKey::operator==(const BufferKey& other) const {
+	return byte_size == other.byte_size && usage == other.usage && memory == other.memory;
 }
 
-void FrameGraphResourcePool::create_image(FrameGraphImageId res, ImageFormat format, const math::Vec2ui& size, ImageUsage usage) {
-	res.check_valid();
-	check_usage(usage);
+usize FrameGraphResourcePool::KeyHash::operator()(const ImageKey& key) const {
+	return hash(u32(key.format.vk_format()), key.size.x(), key.size.y(), u32(key.usage));
+}
 
-	auto& image = _images[res];
-	if(image) {
-		y_fatal("Image already exists.");
-	}
+bool FrameGraphResourcePool::PlacedImageKey::operator==(const PlacedImageKey& other) const {
+	return image == other.image && memory_type_bits == other.memory_type_bits && offset == other.offset;
+}
+
+bool FrameGraphResourcePool::PlacedBufferKey::operator==(const PlacedBufferKey& other) const {
+	return byte_size == other.byte_size && usage == other.usage && memory_type_bits == other.memory_type_bits && offset == other.offset;
+}
+
+usize FrameGraphResourcePool::KeyHash::operator()(const BufferKey& key) const {
+	return hash(key.byte_size, u32(key.usage), u32(key.memory));
+}
 
-	if(!(image = create_image_from_pool(format, size, usage))) {
-		_image_storage << std::make_unique<ImageContainer>(device(), format, usage, size);
-		image = _image_storage.last().get();
+usize FrameGraphResourcePool::KeyHash::operator()(const PlacedImageKey& key) const {
+	return hash((*this)(key.image), key.memory_type_bits, key.offset);
+}
+
+usize FrameGraphResourcePool::KeyHash::operator()(const PlacedBufferKey& key) const {
+	return hash(key.byte_size, u32(key.usage), key.memory_type_bits, key.offset);
+}
+
+FrameGraphResourcePool::FrameGraphResourcePool(DevicePtr dptr) : DeviceLinked(dptr), _timestamps(std::make_unique<FrameGraphTimestamps>(dptr)) {
+}
+
+FrameGraphResourcePool::~FrameGraphResourcePool() {
+	if(!_images.empty() || !_buffers.empty()) {
+		y_fatal("Not all resources have been released.");
+	}
+	for(auto& [type_bits, aliased] : _aliased_memory) {
+		unused(type_bits);
+		device()->destroy(std::move(aliased.memory));
 	}
 }
 
@@ -71,6 +97,122 @@ void FrameGraphResourcePool::create_buffer(FrameGraphBufferId res, usize byte_si
 	}
 }
 
+void FrameGraphResourcePool::create_aliased_resources(core::Span<AliasedImageCreateInfo> images, core::Span<AliasedBufferCreateInfo> buffers) {
+	y_profile();
+
+	const usize image_count = images.size();
+	auto allocations = core::vector_with_capacity<TransientAllocation>(image_count + buffers.size());
+	auto type_bits = core::vector_with_capacity<u32>(image_count + buffers.size());
+
+	for(const auto& info : images) {
+		info.res.check_valid();
+		check_usage(info.usage);
+		const vk::MemoryRequirements reqs = image_requirements(info.format, info.size, info.usage);
+		allocations << TransientAllocation{reqs.size, reqs.alignment, info.first_use, info.last_use};
+		type_bits << reqs.memoryTypeBits;
+	}
+	for(const auto& info : buffers) {
+		info.res.check_valid();
+		check_usage(info.usage);
+		const vk::MemoryRequirements reqs = BufferBase::memory_requirements(device(), info.byte_size, info.usage);
+		allocations << TransientAllocation{reqs.size, reqs.alignment, info.first_use, info.last_use};
+		type_bits << reqs.memoryTypeBits;
+	}
+
+	_aliased_resources_size = 0;
+	for(const auto& alloc : allocations) {
+		_aliased_resources_size += alloc.byte_size;
+	}
+
+	// resources can only alias resources that accept the same memory types
+	std::map<u32, core::Vector<usize>> groups;
+	for(usize i = 0; i != allocations.size(); ++i) {
+		groups[type_bits[i]] << i;
+	}
+
+	for(const auto& [bits, indexes] : groups) {
+		auto group = core::vector_with_capacity<TransientAllocation>(indexes.size());
+		for(usize i : indexes) {
+			group << allocations[i];
+		}
+
+		usize max_alignment = 1;
+		for(const auto& alloc : group) {
+			max_alignment = std::max(max_alignment, alloc.byte_size ? alloc.alignment : 1);
+		}
+
+		const usize byte_size = compute_transient_memory_layout(group);
+		const DeviceMemory& memory = aliased_memory(bits, byte_size + max_alignment);
+		const usize base_offset = (memory.vk_offset() + max_alignment - 1) / max_alignment * max_alignment;
+
+		for(usize k = 0; k != indexes.size(); ++k) {
+			const usize index = indexes[k];
+			const usize offset = base_offset + group[k].offset;
+
+			if(index < image_count) {
+				const auto& info = images[index];
+				auto& image = _images[info.res];
+				if(image) {
+					y_fatal("Image already exists.");
+				}
+				image = create_placed_image(PlacedImageKey{ImageKey{info.format, info.size, info.usage}, bits, offset}, memory, group[k].byte_size);
+			} else {
+				const auto& info = buffers[index - image_count];
+				auto& buffer = _buffers[info.res];
+				if(buffer.device()) {
+					y_fatal("Buffer already exists.");
+				}
+				const PlacedBufferKey key{info.byte_size, info.usage, bits, offset};
+				buffer = create_placed_buffer(key, memory, group[k].byte_size);
+				_aliased_buffers[info.res] = key;
+			}
+		}
+	}
+}
+
+vk::MemoryRequirements FrameGraphResourcePool::image_requirements(ImageFormat format, const math::Vec2ui& size, ImageUsage usage) {
+	for(const auto& cached : _image_requirements) {
+		if(cached.format == format && cached.size == size && cached.usage == usage) {
+			return cached.reqs;
+		}
+	}
+
+	// keep the cache small, sizes change when viewports are resized
+	static constexpr usize max_cached_requirements = 64;
+	if(_image_requirements.size() >= max_cached_requirements) {
+		_image_requirements.make_empty();
+	}
+
+	const vk::MemoryRequirements reqs = ImageBase::memory_requirements(device(), format, usage, math::Vec3ui(size, 1));
+	_image_requirements << ImageRequirements{format, size, usage, reqs};
+	return reqs;
+}
+
+const DeviceMemory& FrameGraphResourcePool::aliased_memory(u32 memory_type_bits, usize byte_size) {
+	AliasedMemory& aliased = _aliased_memory[memory_type_bits];
+	DeviceMemory& memory = aliased.memory;
+
+	aliased.high_water = std::max(aliased.high_water, byte_size);
+	if(byte_size >= memory.vk_size()) {
+		aliased.last_full_use = _frame;
+		aliased.high_water = 0;
+	}
+
+	if(memory.vk_size() < byte_size) {
+		if(memory.device()) {
+			// resources still in use are destroyed when released
+			evict_placed(memory_type_bits);
+			device()->destroy(std::move(memory));
+		}
+
+		vk::MemoryRequirements reqs;
+		reqs.size = byte_size;
+		reqs.alignment = 1;
+		reqs.memoryTypeBits = memory_type_bits;
+		memory = device()->allocator().alloc(reqs, MemoryType::DeviceLocal);
+	}
+	return memory;
+}
 
 void FrameGraphResourcePool::create_alias(FrameGraphImageId res, FrameGraphImageId alias) {
 	res.check_valid();
@@ -90,43 +232,193 @@ void FrameGraphResourcePool::create_alias(FrameGraphImageId res, FrameGraphImage
 }
 
 
-FrameGraphResourcePool::ImageContainer* FrameGraphResourcePool::create_image_from_pool(ImageFormat format, const math::Vec2ui& size, ImageUsage usage) {
-	for(auto it = _released_images.begin(); it != _released_images.end(); ++it) {
-		ImageContainer* img = *it;
-		if(img->image.format() == format && img->image.size() == size && img->image.usage() == usage) {
-			y_debug_assert(img->aliases == 0);
-			_released_images.erase_unordered(it);
-			return img;
+bool FrameGraphResourcePool::is_current_aliased_memory(u32 memory_type_bits, const DeviceMemory& memory) const {
+	const auto it = _aliased_memory.find(memory_type_bits);
+	return it != _aliased_memory.end() && it->second.memory.vk_memory() == memory.vk_memory();
+}
+
+FrameGraphResourcePool::ImageContainer* FrameGraphResourcePool::create_placed_image(const PlacedImageKey& key, const DeviceMemory& memory, usize byte_size) {
+	if(const auto it = _released_images.find(key); it != _released_images.end()) {
+		ImageContainer* img = it->second.pop().image;
+		y_debug_assert(img->aliases == 0);
+		if(it->second.is_empty()) {
+			_released_images.erase(it);
 		}
+
+		++_hits;
+		return img;
 	}
-	return nullptr;
+
+	++_misses;
+	DeviceMemory range(device(), memory.vk_memory(), key.offset, byte_size);
+	_image_storage << std::make_unique<ImageContainer>(key, device(), key.image.format, key.image.usage, key.image.size, std::move(range));
+	return _image_storage.last().get();
 }
 
+TransientBuffer FrameGraphResourcePool::create_placed_buffer(const PlacedBufferKey& key, const DeviceMemory& memory, usize byte_size) {
+	if(const auto it = _released_placed_buffers.find(key); it != _released_placed_buffers.end()) {
+		TransientBuffer buffer = std::move(it->second.pop().buffer);
+		if(it->second.is_empty()) {
+			_released_placed_buffers.erase(it);
+		}
+
+		++_hits;
+		return buffer;
+	}
+
+	++_misses;
+	return TransientBuffer(device(), key.byte_size, key.usage, DeviceMemory(device(), memory.vk_memory(), key.offset, byte_size));
+}
 
 bool FrameGraphResourcePool::create_buffer_from_pool(TransientBuffer& res, usize byte_size, BufferUsage usage, MemoryType memory) {
+	y_debug_assert(memory != MemoryType::DontCare);
+
+	const auto it = _released_buffers.find(BufferKey{byte_size, usage, memory});
+	if(it == _released_buffers.end()) {
+		++_misses;
+		return false;
+	}
+
+	res = std::move(it->second.pop().buffer);
+	if(it->second.is_empty()) {
+		_released_buffers.erase(it);
+	}
+
+	_released_bytes -= res.byte_size();
+	++_hits;
+	return true;
+}
+
+void FrameGraphResourcePool::garbage_collect() {
+	y_profile();
+
+	++_frame;
+
+	const usize evictions = _evictions;
+	auto evict_idle = [this](auto& released, auto&& evict_one) {
+		for(auto it = released.begin(); it != released.end();) {
+			auto& entries = it->second;
+			// entries are sorted by release date, so idle ones are at the front
+			while(!entries.is_empty() && _frame - entries[0].last_used > _max_idle_frames) {
+				evict_one(entries[0]);
+				entries.erase(entries.begin());
+			}
+			it = entries.is_empty() ? released.erase(it) : std::next(it);
+		}
+	};
+
+	evict_idle(_released_images, [this](const ReleasedImage& released) { evict(released.image); });
+	evict_idle(_released_placed_buffers, [this](const ReleasedBuffer&) { ++_evictions; });
+	evict_idle(_released_buffers, [this](const ReleasedBuffer& released) {
+		_released_bytes -= released.buffer.byte_size();
+		++_evictions;
+	});
+
+	shrink_aliased_memory(true);
+
+	// placed resources don't own any memory, their aliased memory is counted instead
+	while(_released_bytes + aliased_memory_size() > _memory_budget && !_released_buffers.empty()) {
+		evict_oldest();
+	}
+	if(_released_bytes + aliased_memory_size() > _memory_budget) {
+		shrink_aliased_memory(false);
+	}
+
+	if(evictions != _evictions) {
+		log_msg(fmt("Frame graph resource pool evicted % resources.", _evictions - evictions), Log::Debug);
+	}
+}
+
+void FrameGraphResourcePool::evict_oldest() {
+	auto oldest_buffer = _released_buffers.end();
+	u64 oldest = u64(-1);
+
 	for(auto it = _released_buffers.begin(); it != _released_buffers.end(); ++it) {
-		auto& buffer = *it;
+		if(it->second[0].last_used < oldest) {
+			oldest = it->second[0].last_used;
+			oldest_buffer = it;
+		}
+	}
 
-		if(buffer.byte_size() == byte_size &&
-		   buffer.usage() == usage &&
-		   (buffer.memory_type() == memory || memory == MemoryType::DontCare)) {
+	if(oldest_buffer == _released_buffers.end()) {
+		y_fatal("Nothing to evict.");
+	}
 
-			res = std::move(buffer);
-			_released_buffers.erase_unordered(it);
-			return true;
+	auto& buffers = oldest_buffer->second;
+	_released_bytes -= buffers[0].buffer.byte_size();
+	++_evictions;
+	buffers.erase(buffers.begin());
+	if(buffers.is_empty()) {
+		_released_buffers.erase(oldest_buffer);
+	}
+}
+
+// memory that is only partially used gets reallocated on its next use, to the size needed then.
+// Resources still placed in it are destroyed when released.
+void FrameGraphResourcePool::shrink_aliased_memory(bool idle_only) {
+	for(auto it = _aliased_memory.begin(); it != _aliased_memory.end();) {
+		AliasedMemory& aliased = it->second;
+		const bool is_idle = _frame - aliased.last_full_use > _max_idle_frames;
+		const bool used_by_last_graph = _frame - aliased.last_full_use <= 1;
+
+		// only worth it when at least a quarter of the memory would be freed
+		const bool is_oversized = aliased.high_water < aliased.memory.vk_size() / 4 * 3;
+
+		if(is_oversized && (is_idle || (!idle_only && !used_by_last_graph))) {
+			evict_placed(it->first);
+			device()->destroy(std::move(aliased.memory));
+			it = _aliased_memory.erase(it);
+		} else {
+			if(is_idle) {
+				// starts a new window
+				aliased.last_full_use = _frame;
+				aliased.high_water = 0;
+			}
+			++it;
 		}
 	}
-	return false;
 }
 
+void FrameGraphResourcePool::evict(ImageContainer* image) {
+	const auto it = std::find_if(_image_storage.begin(), _image_storage.end(), [=](const auto& img) { return img.get() == image; });
+	y_debug_assert(it != _image_storage.end());
+	++_evictions;
+	_image_storage.erase_unordered(it);
+}
+
+void FrameGraphResourcePool::evict_placed(u32 memory_type_bits) {
+	for(auto it = _released_images.begin(); it != _released_images.end();) {
+		if(it->first.memory_type_bits == memory_type_bits) {
+			for(const ReleasedImage& released : it->second) {
+				evict(released.image);
+			}
+			it = _released_images.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for(auto it = _released_placed_buffers.begin(); it != _released_placed_buffers.end();) {
+		if(it->first.memory_type_bits == memory_type_bits) {
+			_evictions += it->second.size();
+			it = _released_placed_buffers.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
 
 void FrameGraphResourcePool::release(FrameGraphImageId res) {
 	res.check_valid();
 	if(auto it = _images.find(res); it != _images.end()) {
-		if(it->second->aliases) {
-			--(it->second->aliases);
+		ImageContainer* image = it->second;
+		if(image->aliases) {
+			--(image->aliases);
+		} else if(is_current_aliased_memory(image->key.memory_type_bits, image->image.device_memory())) {
+			_released_images[image->key] << ReleasedImage{image, _frame};
+			_images.erase(it);
 		} else {
-			_released_images << it->second;
+			// the memory has been reallocated since the image was placed
+			evict(image);
 			_images.erase(it);
 		}
 	} else {
@@ -137,7 +429,17 @@ void FrameGraphResourcePool::release(FrameGraphImageId res) {
 void FrameGraphResourcePool::release(FrameGraphBufferId res) {
 	res.check_valid();
 	if(auto it = _buffers.find(res); it != _buffers.end()) {
-		_released_buffers << std::move(it->second);
+		TransientBuffer& buffer = it->second;
+		if(const auto aliased = _aliased_buffers.find(res); aliased != _aliased_buffers.end()) {
+			const PlacedBufferKey key = aliased->second;
+			_aliased_buffers.erase(aliased);
+			if(is_current_aliased_memory(key.memory_type_bits, buffer.device_memory())) {
+				_released_placed_buffers[key] << ReleasedBuffer{std::move(buffer), _frame};
+			}
+		} else {
+			_released_bytes += buffer.byte_size();
+			_released_buffers[BufferKey{buffer.byte_size(), buffer.usage(), buffer.memory_type()}] << ReleasedBuffer{std::move(buffer), _frame};
+		}
 		_buffers.erase(it);
 	} else {
 		y_fatal("Released buffer resource does not belong to pool.");
@@ -165,6 +467,23 @@ BufferBarrier FrameGraphResourcePool::barrier(FrameGraphBufferId res, PipelineSt
 	return BufferBarrier(_buffers.find(res)->second, src, dst);
 }
 
+bool FrameGraphResourcePool::is_aliased(FrameGraphImageId res) const {
+	// every image is placed in aliased memory
+	return _images.find(res) != _images.end();
+}
+
+bool FrameGraphResourcePool::is_aliased(FrameGraphBufferId res) const {
+	return _aliased_buffers.find(res) != _aliased_buffers.end();
+}
+
+ImageBarrier FrameGraphResourcePool::aliasing_barrier(FrameGraphImageId res) const {
+	return ImageBarrier::aliasing_barrier(find(res));
+}
+
+BufferBarrier FrameGraphResourcePool::aliasing_barrier(FrameGraphBufferId res) const {
+	return BufferBarrier::aliasing_barrier(find(res));
+}
+
 const ImageBase& FrameGraphResourcePool::image_base(FrameGraphImageId res) const {
 	return find(res);
 }
@@ -174,7 +493,77 @@ const BufferBase& FrameGraphResourcePool::buffer_base(FrameGraphBufferId res) co
 }
 
 usize FrameGraphResourcePool::allocated_resources() const {
-	return _buffers.size() + _released_buffers.size() + _image_storage.size();
+	usize released_buffers = 0;
+	for(const auto& [key, buffers] : _released_buffers) {
+		unused(key);
+		released_buffers += buffers.size();
+	}
+	for(const auto& [key, buffers] : _released_placed_buffers) {
+		unused(key);
+		released_buffers += buffers.size();
+	}
+	return _buffers.size() + released_buffers + _image_storage.size();
+}
+
+FrameGraphResourcePool::PoolStats FrameGraphResourcePool::pool_stats() const {
+	PoolStats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.evictions = _evictions;
+	stats.released_bytes = _released_bytes;
+
+	// released images are kept in the image storage
+	stats.placed_resources = _image_storage.size() + _aliased_buffers.size();
+	for(const auto& [key, buffers] : _released_placed_buffers) {
+		unused(key);
+		stats.placed_resources += buffers.size();
+	}
+
+	for(const auto& [res, buffer] : _buffers) {
+		if(_aliased_buffers.find(res) == _aliased_buffers.end()) {
+			stats.resident_bytes += buffer.byte_size();
+		}
+	}
+	for(const auto& [key, buffers] : _released_buffers) {
+		unused(key);
+		for(const auto& released : buffers) {
+			stats.resident_bytes += released.buffer.byte_size();
+		}
+	}
+	return stats;
+}
+
+const FrameGraphTimings& FrameGraphResourcePool::pass_timings() const {
+	return _timings;
+}
+
+FrameGraphTimings& FrameGraphResourcePool::pass_timings() {
+	return _timings;
+}
+
+FrameGraphTimestamps* FrameGraphResourcePool::timestamps() {
+	return _timestamps.get();
+}
+
+void FrameGraphResourcePool::set_max_idle_frames(usize frames) {
+	_max_idle_frames = frames;
+}
+
+void FrameGraphResourcePool::set_memory_budget(usize bytes) {
+	_memory_budget = bytes;
+}
+
+usize FrameGraphResourcePool::aliased_memory_size() const {
+	usize size = 0;
+	for(const auto& [type_bits, aliased] : _aliased_memory) {
+		unused(type_bits);
+		size += aliased.memory.vk_size();
+	}
+	return size;
+}
+
+usize FrameGraphResourcePool::aliased_resources_size() const {
+	return _aliased_resources_size;
 }
 
 u32 FrameGraphResourcePool::create_resource_id() {
@@ -30,6 +30,9 @@ SOFTWARE.
 
 #include "FrameGraphResourceToken.h"
 #include "FrameGraphPass.h"
+#include "FrameGraphTimestamps.h"
+
+#include <unordered_map>
 
 namespace yave {
 
@@ -38,6 +41,8 @@ class FrameGraphResourcePool : NonCopyable, public DeviceLinked {
 	Y_TODO(Split resource alloc and id mapping into two classes)
 
 	public:
+		// Without a device the pool can only create resource ids, which is enough to build and compile graphs
+		FrameGraphResourcePool() = default;
 		FrameGraphResourcePool(DevicePtr dptr);
 		~FrameGraphResourcePool();
 
@@ -64,9 +69,30 @@ class FrameGraphResourcePool : NonCopyable, public DeviceLinked {
 			return TypedMapping<T>(subbuffer);
 		}
 
-		void create_image(FrameGraphImageId res, ImageFormat format, const math::Vec2ui& size, ImageUsage usage);
+		struct AliasedImageCreateInfo {
+			FrameGraphImageId res;
+			ImageFormat format;
+			math::Vec2ui size;
+			ImageUsage usage = ImageUsage::None;
+			usize first_use = 0;
+			usize last_use = 0;
+		};
+
+		struct AliasedBufferCreateInfo {
+			FrameGraphBufferId res;
+			usize byte_size = 0;
+			BufferUsage usage = BufferUsage::None;
+			usize first_use = 0;
+			usize last_use = 0;
+		};
+
 		void create_buffer(FrameGraphBufferId res, usize byte_size, BufferUsage usage, MemoryType memory);
 
+		// Creates device local resources in shared memory: resources whose pass ranges don't overlap can alias each other.
+		// The content of aliased resources is undefined until their first use, which needs an aliasing barrier.
+		// Resources are reused as long as the memory layout places them at the same offset.
+		void create_aliased_resources(core::Span<AliasedImageCreateInfo> images, core::Span<AliasedBufferCreateInfo> buffers);
+
 		void create_alias(FrameGraphImageId res, FrameGraphImageId alias);
 
 		void release(FrameGraphImageId res);
@@ -75,6 +101,12 @@ class FrameGraphResourcePool : NonCopyable, public DeviceLinked {
 		ImageBarrier barrier(FrameGraphImageId res, PipelineStage src, PipelineStage dst) const;
 		BufferBarrier barrier(FrameGraphBufferId res, PipelineStage src, PipelineStage dst) const;
 
+		bool is_aliased(FrameGraphImageId res) const;
+		bool is_aliased(FrameGraphBufferId res) const;
+
+		ImageBarrier aliasing_barrier(FrameGraphImageId res) const;
+		BufferBarrier aliasing_barrier(FrameGraphBufferId res) const;
+
 		const ImageBase& image_base(FrameGraphImageId res) const;
 		const BufferBase& buffer_base(FrameGraphBufferId res) const;
 
@@ -82,34 +114,166 @@ class FrameGraphResourcePool : NonCopyable, public DeviceLinked {
 
 		usize allocated_resources() const;
 
+		struct PoolStats {
+			usize hits = 0;
+			usize misses = 0;
+			usize evictions = 0;
+
+			// memory owned by pooled buffers, placed resources use the aliased memory
+			usize resident_bytes = 0;
+			usize released_bytes = 0;
+
+			usize placed_resources = 0;
+		};
+
+		PoolStats pool_stats() const;
+
+		// Released resources are destroyed after staying unused for max_idle_frames frames
+		// or when released buffers and aliased memory use more than memory_budget bytes, oldest first.
+		// Aliased memory is reallocated to fit when its full size hasn't been needed for max_idle_frames frames.
+		void set_max_idle_frames(usize frames);
+		void set_memory_budget(usize bytes);
+
+		// Should be called once per rendered graph
+		void garbage_collect();
+
+		// GPU time of every pass rendered using this pool
+		const FrameGraphTimings& pass_timings() const;
+		FrameGraphTimings& pass_timings();
+
+		// Null if the pool doesn't have a device
+		FrameGraphTimestamps* timestamps();
+
+		// memory shared by aliased resources and what the last aliased resources would have needed without aliasing
+		usize aliased_memory_size() const;
+		usize aliased_resources_size() const;
+
 		u32 create_resource_id();
 
 	private:
 		const TransientImage<>& find(FrameGraphImageId res) const;
 		const TransientBuffer& find(FrameGraphBufferId res) const;
 
+		struct ImageKey {
+			ImageFormat format;
+			math::Vec2ui size;
+			ImageUsage usage;
+
+			bool operator==(const ImageKey& other) const;
+		};
+
+		struct BufferKey {
+			usize byte_size;
+			BufferUsage usage;
+			MemoryType memory;
+
+			bool operator==(const BufferKey& other) const;
+		};
+
+		// placed resources are bound to their offset in the aliased memory of their memory types
+		struct PlacedImageKey {
+			ImageKey image;
+			u32 memory_type_bits;
+			usize offset;
+
+			bool operator==(const PlacedImageKey& other) const;
+		};
+
+		struct PlacedBufferKey {
+			usize byte_size;
+			BufferUsage usage;
+			u32 memory_type_bits;
+			usize offset;
+
+			bool operator==(const PlacedBufferKey& other) const;
+		};
+
+		struct KeyHash {
+			usize operator()(const ImageKey& key) const;
+			usize operator()(const BufferKey& key) const;
+			usize operator()(const PlacedImageKey& key) const;
+			usize operator()(const PlacedBufferKey& key) const;
+		};
+
 		struct ImageContainer {
 			template<typename... Args>
-			ImageContainer(Args&&... args) : image(y_fwd(args)...) {}
+			ImageContainer(const PlacedImageKey& k, Args&&... args) : image(y_fwd(args)...), key(k) {}
 
 			TransientImage<> image;
+			PlacedImageKey key;
 			usize aliases = 0;
 		};
 
-		ImageContainer* create_image_from_pool(ImageFormat format, const math::Vec2ui& size, ImageUsage usage);
+		ImageContainer* create_placed_image(const PlacedImageKey& key, const DeviceMemory& memory, usize byte_size);
+		TransientBuffer create_placed_buffer(const PlacedBufferKey& key, const DeviceMemory& memory, usize byte_size);
 		bool create_buffer_from_pool(TransientBuffer& res, usize byte_size, BufferUsage usage, MemoryType memory);
 
+		vk::MemoryRequirements image_requirements(ImageFormat format, const math::Vec2ui& size, ImageUsage usage);
+		const DeviceMemory& aliased_memory(u32 memory_type_bits, usize byte_size);
+		bool is_current_aliased_memory(u32 memory_type_bits, const DeviceMemory& memory) const;
+
+		struct ReleasedImage {
+			ImageContainer* image;
+			u64 last_used;
+		};
+
+		struct ReleasedBuffer {
+			TransientBuffer buffer;
+			u64 last_used;
+		};
+
+		void evict_oldest();
+		void evict(ImageContainer* image);
+		void evict_placed(u32 memory_type_bits);
+
+		void shrink_aliased_memory(bool idle_only);
+
 		using hash_t = std::hash<FrameGraphResourceId>;
 		std::unordered_map<FrameGraphImageId, ImageContainer*, hash_t> _images;
 		std::unordered_map<FrameGraphBufferId, TransientBuffer, hash_t> _buffers;
 
-		core::Vector<ImageContainer*> _released_images;
-		core::Vector<TransientBuffer> _released_buffers;
+		// most recently released resources are at the back
+		std::unordered_map<PlacedImageKey, core::Vector<ReleasedImage>, KeyHash> _released_images;
+		std::unordered_map<PlacedBufferKey, core::Vector<ReleasedBuffer>, KeyHash> _released_placed_buffers;
+		std::unordered_map<BufferKey, core::Vector<ReleasedBuffer>, KeyHash> _released_buffers;
 
 		u32 _next_id = 0;
 
+		u64 _frame = 0;
+		usize _max_idle_frames = 8;
+		usize _memory_budget = 256 * 1024 * 1024;
+		usize _released_bytes = 0;
 
+		usize _hits = 0;
+		usize _misses = 0;
+		usize _evictions = 0;
+
+
+		// every image is placed, in use or released
 		core::Vector<std::unique_ptr<ImageContainer>> _image_storage;
+
+		struct ImageRequirements {
+			ImageFormat format;
+			math::Vec2ui size;
+			ImageUsage usage;
+			vk::MemoryRequirements reqs;
+		};
+
+		core::Vector<ImageRequirements> _image_requirements;
+
+		struct AliasedMemory {
+			DeviceMemory memory;
+			// largest size requested since the whole memory was last needed
+			usize high_water = 0;
+			u64 last_full_use = 0;
+		};
+
+		std::unordered_map<u32, AliasedMemory> _aliased_memory;
+		std::unordered_map<FrameGraphBufferId, PlacedBufferKey, hash_t> _aliased_buffers;
+		usize _aliased_resources_size = 0;
+
+		FrameGraphTimings _timings;
+		std::unique_ptr<FrameGraphTimestamps> _timestamps;
 };
 
 }
@@ -0,0 +1,140 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrameGraphTimestamps.h"
+
+#include <yave/device/Device.h>
+
+namespace yave {
+
+static constexpr u32 query_count = u32(FrameGraphTimestamps::max_passes * 2);
+
+FrameGraphTimestamps::FrameGraphTimestamps(DevicePtr dptr) :
+		DeviceLinked(dptr),
+		_period(dptr->vk_limits().timestampPeriod),
+		_supported(dptr->vk_limits().timestampComputeAndGraphics) {
+
+	if(!_supported) {
+		log_msg("Timestamp queries are not supported, frame graph passes will not be timed.", Log::Warning);
+		return;
+	}
+
+	for(Frame& frame : _frames) {
+		frame.pool = dptr->vk_device().createQueryPool(vk::QueryPoolCreateInfo()
+				.setQueryCount(query_count)
+				.setQueryType(vk::QueryType::eTimestamp)
+			);
+	}
+}
+
+FrameGraphTimestamps::~FrameGraphTimestamps() {
+	for(Frame& frame : _frames) {
+		if(frame.pool) {
+			destroy(frame.pool);
+		}
+	}
+}
+
+usize FrameGraphTimestamps::dropped_frames() const {
+	return _dropped;
+}
+
+void FrameGraphTimestamps::begin_frame(CmdBufferRecorder& recorder, FrameGraphTimings& timings) {
+	if(!_supported) {
+		return;
+	}
+
+	Frame& frame = _frames[_frame_index % frames_in_flight];
+	if(frame.pending) {
+		read_back(frame, timings);
+	}
+
+	frame.passes.make_empty();
+	recorder.vk_cmd_buffer().resetQueryPool(frame.pool, 0, query_count);
+}
+
+void FrameGraphTimestamps::end_frame() {
+	if(!_supported) {
+		return;
+	}
+
+	y_debug_assert(!_pass_open);
+	_frames[_frame_index % frames_in_flight].pending = true;
+	++_frame_index;
+}
+
+void FrameGraphTimestamps::begin_pass(CmdBufferRecorder& recorder, const core::String& name) {
+	if(!_supported) {
+		return;
+	}
+
+	Frame& frame = _frames[_frame_index % frames_in_flight];
+	if(frame.passes.size() == max_passes) {
+		return;
+	}
+
+	const u32 query = u32(frame.passes.size() * 2);
+	frame.passes << name;
+	_pass_open = true;
+	recorder.vk_cmd_buffer().writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, frame.pool, query);
+}
+
+void FrameGraphTimestamps::end_pass(CmdBufferRecorder& recorder) {
+	if(!_supported) {
+		return;
+	}
+
+	if(!_pass_open) {
+		return;
+	}
+
+	_pass_open = false;
+	const Frame& frame = _frames[_frame_index % frames_in_flight];
+	const u32 query = u32(frame.passes.size() * 2 - 1);
+	recorder.vk_cmd_buffer().writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, frame.pool, query);
+}
+
+void FrameGraphTimestamps::read_back(Frame& frame, FrameGraphTimings& timings) {
+	y_profile();
+
+	frame.pending = false;
+	if(frame.passes.is_empty()) {
+		return;
+	}
+
+	std::array<u64, query_count> results;
+	const u32 count = u32(frame.passes.size() * 2);
+	const vk::Result res = device()->vk_device().getQueryPoolResults<u64>(frame.pool, 0, count, vk::ArrayProxy<u64>(count, results.data()), sizeof(u64), vk::QueryResultFlagBits::e64);
+	if(res != vk::Result::eSuccess) {
+		++_dropped;
+		return;
+	}
+
+	for(usize i = 0; i != frame.passes.size(); ++i) {
+		const u64 begin = results[2 * i];
+		const u64 end = results[2 * i + 1];
+		const u64 ticks = end > begin ? end - begin : 0;
+		timings.add_sample(frame.passes[i], core::Duration::nanoseconds(u64(ticks * _period)));
+	}
+}
+
+}
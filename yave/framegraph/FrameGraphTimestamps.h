@@ -0,0 +1,71 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_FRAMEGRAPH_FRAMEGRAPHTIMESTAMPS_H
+#define YAVE_FRAMEGRAPH_FRAMEGRAPHTIMESTAMPS_H
+
+#include <yave/graphics/commands/CmdBufferRecorder.h>
+
+#include "FrameGraphTimings.h"
+
+namespace yave {
+
+// Writes timestamps around every pass of a graph.
+// Results are read back frames_in_flight renders later, when the queries are reused, and never waited on:
+// frames whose results are not available yet are dropped.
+class FrameGraphTimestamps : NonCopyable, public DeviceLinked {
+
+	public:
+		static constexpr usize frames_in_flight = 4;
+		static constexpr usize max_passes = 64;
+
+		FrameGraphTimestamps(DevicePtr dptr);
+		~FrameGraphTimestamps();
+
+		// Must be recorded outside of a render pass
+		void begin_frame(CmdBufferRecorder& recorder, FrameGraphTimings& timings);
+		void end_frame();
+
+		void begin_pass(CmdBufferRecorder& recorder, const core::String& name);
+		void end_pass(CmdBufferRecorder& recorder);
+
+		usize dropped_frames() const;
+
+	private:
+		struct Frame {
+			vk::QueryPool pool;
+			core::Vector<core::String> passes;
+			bool pending = false;
+		};
+
+		void read_back(Frame& frame, FrameGraphTimings& timings);
+
+		std::array<Frame, frames_in_flight> _frames;
+		usize _frame_index = 0;
+		usize _dropped = 0;
+		double _period = 1.0;
+		bool _supported = false;
+		bool _pass_open = false;
+};
+
+}
+
+#endif // YAVE_FRAMEGRAPH_FRAMEGRAPHTIMESTAMPS_H
@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrameGraphTimings.h"
+
+#include <algorithm>
+
+namespace yave {
+
+void FrameGraphTimings::add_sample(std::string_view pass_name, core::Duration time) {
+	auto it = std::find_if(_passes.begin(), _passes.end(), [&](const Samples& s) { return s.name.view() == pass_name; });
+	if(it == _passes.end()) {
+		_passes.emplace_back().name = pass_name;
+		it = _passes.end() - 1;
+	}
+	it->nanos[it->count % window_size] = time.to_nanos();
+	++it->count;
+}
+
+core::Vector<FrameGraphTimings::PassTiming> FrameGraphTimings::pass_timings() const {
+	auto timings = core::vector_with_capacity<PassTiming>(_passes.size());
+	for(const Samples& samples : _passes) {
+		timings << compute_timing(samples);
+	}
+	return timings;
+}
+
+core::Duration FrameGraphTimings::total_average() const {
+	u64 total = 0;
+	for(const Samples& samples : _passes) {
+		total += compute_timing(samples).average.to_nanos();
+	}
+	return core::Duration::nanoseconds(total);
+}
+
+void FrameGraphTimings::clear() {
+	_passes.clear();
+}
+
+FrameGraphTimings::PassTiming FrameGraphTimings::compute_timing(const Samples& samples) const {
+	PassTiming timing;
+	timing.name = samples.name;
+	timing.samples = std::min(samples.count, window_size);
+	if(!timing.samples) {
+		return timing;
+	}
+
+	const auto begin = samples.nanos.begin();
+	const auto end = begin + timing.samples;
+	const auto [min, max] = std::minmax_element(begin, end);
+	u64 sum = 0;
+	for(auto it = begin; it != end; ++it) {
+		sum += *it;
+	}
+
+	timing.average = core::Duration::nanoseconds(sum / timing.samples);
+	timing.min = core::Duration::nanoseconds(*min);
+	timing.max = core::Duration::nanoseconds(*max);
+	return timing;
+}
+
+}
@@ -0,0 +1,72 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_FRAMEGRAPH_FRAMEGRAPHTIMINGS_H
+#define YAVE_FRAMEGRAPH_FRAMEGRAPHTIMINGS_H
+
+#include <yave/yave.h>
+
+#include <y/core/Chrono.h>
+
+#include <array>
+
+namespace yave {
+
+// Rolling statistics over the last window_size samples of every pass.
+// Samples can come from GPU timestamps or from any other clock.
+class FrameGraphTimings {
+
+	public:
+		static constexpr usize window_size = 64;
+
+		struct PassTiming {
+			core::String name;
+			core::Duration average;
+			core::Duration min;
+			core::Duration max;
+			usize samples = 0;
+		};
+
+		void add_sample(std::string_view pass_name, core::Duration time);
+
+		// In the order the passes were first sampled
+		core::Vector<PassTiming> pass_timings() const;
+
+		// Sum of the averages of all passes
+		core::Duration total_average() const;
+
+		void clear();
+
+	private:
+		struct Samples {
+			core::String name;
+			std::array<u64, window_size> nanos = {};
+			usize count = 0;
+		};
+
+		PassTiming compute_timing(const Samples& samples) const;
+
+		core::Vector<Samples> _passes;
+};
+
+}
+
+#endif // YAVE_FRAMEGRAPH_FRAMEGRAPHTIMINGS_H
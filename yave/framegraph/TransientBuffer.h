@@ -41,6 +41,10 @@ class TransientBuffer final : public BufferBase {
 			_memory_type = type;
 		}
 
+		TransientBuffer(DevicePtr dptr, usize byte_size, BufferUsage usage, DeviceMemory&& memory) :
+				BufferBase(dptr, byte_size, usage, std::move(memory)) {
+		}
+
 		MemoryType memory_type() const {
 			return _memory_type;
 		}
@@ -47,6 +47,10 @@ class TransientImage final : public ImageBase {
 		TransientImage(DevicePtr dptr, ImageFormat format, ImageUsage usage, const size_type& image_size) : ImageBase(dptr, format, usage, to_3d_size(image_size)) {
 		}
 
+		TransientImage(DevicePtr dptr, ImageFormat format, ImageUsage usage, const size_type& image_size, DeviceMemory&& memory) :
+				ImageBase(dptr, format, usage, to_3d_size(image_size), std::move(memory)) {
+		}
+
 		TransientImage(TransientImage&&) = default;
 		TransientImage& operator=(TransientImage&&) = default;
 
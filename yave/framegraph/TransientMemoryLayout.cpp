@@ -0,0 +1,80 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TransientMemoryLayout.h"
+
+#include <y/core/Vector.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace yave {
+
+static usize align_up(usize value, usize alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+bool TransientAllocation::overlaps(const TransientAllocation& other) const {
+	return first_use <= other.last_use && other.first_use <= last_use;
+}
+
+usize compute_transient_memory_layout(core::MutableSpan<TransientAllocation> allocations) {
+	y_profile();
+
+	// big allocations first, small ones are more likely to fit in the gaps
+	core::Vector<usize> order(allocations.size(), 0);
+	std::iota(order.begin(), order.end(), usize(0));
+	std::sort(order.begin(), order.end(), [&](usize a, usize b) {
+		const auto& alloc_a = allocations[a];
+		const auto& alloc_b = allocations[b];
+		return alloc_a.byte_size != alloc_b.byte_size ? alloc_a.byte_size > alloc_b.byte_size : alloc_a.first_use < alloc_b.first_use;
+	});
+
+	usize total_size = 0;
+	core::Vector<const TransientAllocation*> placed;
+	core::Vector<const TransientAllocation*> conflicts;
+	for(usize index : order) {
+		TransientAllocation& allocation = allocations.data()[index];
+		y_debug_assert(allocation.alignment);
+
+		conflicts.make_empty();
+		std::copy_if(placed.begin(), placed.end(), std::back_inserter(conflicts), [&](const TransientAllocation* other) { return allocation.overlaps(*other); });
+		std::sort(conflicts.begin(), conflicts.end(), [](const TransientAllocation* a, const TransientAllocation* b) { return a->offset < b->offset; });
+
+		// first fit in between the live allocations
+		usize offset = 0;
+		for(const TransientAllocation* other : conflicts) {
+			if(align_up(offset, allocation.alignment) + allocation.byte_size <= other->offset) {
+				break;
+			}
+			offset = std::max(offset, other->offset + other->byte_size);
+		}
+
+		allocation.offset = align_up(offset, allocation.alignment);
+		total_size = std::max(total_size, allocation.offset + allocation.byte_size);
+		placed << &allocation;
+	}
+
+	return total_size;
+}
+
+}
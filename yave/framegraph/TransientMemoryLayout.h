@@ -0,0 +1,50 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_FRAMEGRAPH_TRANSIENTMEMORYLAYOUT_H
+#define YAVE_FRAMEGRAPH_TRANSIENTMEMORYLAYOUT_H
+
+#include <yave/yave.h>
+
+#include <y/core/Span.h>
+
+namespace yave {
+
+struct TransientAllocation {
+	usize byte_size = 0;
+	usize alignment = 1;
+
+	// index of the first and last passes using the allocation
+	usize first_use = 0;
+	usize last_use = 0;
+
+	usize offset = 0;
+
+	bool overlaps(const TransientAllocation& other) const;
+};
+
+// Sets the offset of every allocation inside a single memory block and returns the size of that block.
+// Allocations whose lifetimes overlap never share memory, all others can alias each other.
+usize compute_transient_memory_layout(core::MutableSpan<TransientAllocation> allocations);
+
+}
+
+#endif // YAVE_FRAMEGRAPH_TRANSIENTMEMORYLAYOUT_H
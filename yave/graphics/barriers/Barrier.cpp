@@ -72,6 +72,9 @@ static vk::AccessFlags vk_dst_access_flags(PipelineStage dst) {
 		case PipelineStage::HostBit:
 			return vk::AccessFlagBits::eHostRead;
 
+		case PipelineStage::DrawIndirectBit:
+			return vk::AccessFlagBits::eIndirectCommandRead;
+
 		default:
 			break;
 	}
@@ -193,6 +196,13 @@ ImageBarrier ImageBarrier::transition_from_barrier(const ImageBase& image, vk::I
 	return transition_barrier(image, src_layout, vk_image_layout(image.usage()));
 }
 
+ImageBarrier ImageBarrier::aliasing_barrier(const ImageBase& image) {
+	ImageBarrier barrier = transition_barrier(image, vk::ImageLayout::eUndefined, vk_image_layout(image.usage()));
+	barrier._barrier.setSrcAccessMask(vk::AccessFlagBits::eMemoryWrite);
+	barrier._src = PipelineStage::All;
+	return barrier;
+}
+
 vk::ImageMemoryBarrier ImageBarrier::vk_barrier() const {
 	return _barrier;
 }
@@ -217,6 +227,22 @@ BufferBarrier::BufferBarrier(const SubBufferBase& buffer, PipelineStage src, Pip
 		_src(src), _dst(dst) {
 }
 
+BufferBarrier BufferBarrier::aliasing_barrier(const BufferBase& buffer) {
+	BufferBarrier barrier;
+	barrier._barrier = vk::BufferMemoryBarrier()
+			.setSrcAccessMask(vk::AccessFlagBits::eMemoryWrite)
+			.setDstAccessMask(vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite)
+			.setBuffer(buffer.vk_buffer())
+			.setSize(buffer.byte_size())
+			.setOffset(0)
+			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		;
+	barrier._src = PipelineStage::All;
+	barrier._dst = PipelineStage::All;
+	return barrier;
+}
+
 vk::BufferMemoryBarrier BufferBarrier::vk_barrier() const {
 	return _barrier;
 }
@@ -41,6 +41,9 @@ class ImageBarrier {
 		static ImageBarrier transition_to_barrier(const ImageBase& image, vk::ImageLayout dst_layout);
 		static ImageBarrier transition_from_barrier(const ImageBase& image, vk::ImageLayout src_layout);
 
+		// discards the content of an image whose memory might have been used by another resource
+		static ImageBarrier aliasing_barrier(const ImageBase& image);
+
 
 		vk::ImageMemoryBarrier vk_barrier() const;
 
@@ -60,6 +63,8 @@ class BufferBarrier {
 		BufferBarrier(const BufferBase& buffer, PipelineStage src, PipelineStage dst);
 		BufferBarrier(const SubBufferBase& buffer, PipelineStage src, PipelineStage dst);
 
+		// waits for anything that might have used the buffer's memory before it
+		static BufferBarrier aliasing_barrier(const BufferBase& buffer);
 
 		vk::BufferMemoryBarrier vk_barrier() const;
 
@@ -67,6 +72,8 @@ class BufferBarrier {
 		PipelineStage src_stage() const;
 
 	private:
+		BufferBarrier() = default;
+
 		vk::BufferMemoryBarrier _barrier;
 		PipelineStage _src;
 		PipelineStage _dst;
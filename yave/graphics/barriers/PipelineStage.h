@@ -35,6 +35,7 @@ enum class PipelineStage {
 
 	TransferBit = uenum(vk::PipelineStageFlagBits::eTransfer),
 	HostBit = uenum(vk::PipelineStageFlagBits::eHost),
+	DrawIndirectBit = uenum(vk::PipelineStageFlagBits::eDrawIndirect),
 	VertexInputBit = uenum(vk::PipelineStageFlagBits::eVertexInput),
 	VertexBit = uenum(vk::PipelineStageFlagBits::eVertexShader),
 	FragmentBit = uenum(vk::PipelineStageFlagBits::eFragmentShader),
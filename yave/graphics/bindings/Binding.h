@@ -50,7 +50,8 @@ class Binding {
 				 _info(vk::DescriptorImageInfo()
 					.setImageLayout(vk_image_layout(view.usage()))
 					.setImageView(view.vk_view())
-					.setSampler(view.device()->vk_sampler())) {
+					.setSampler(view.device()->vk_sampler())),
+				 _upload(view.upload_fence()) {
 		}
 
 		template<ImageType Type>
@@ -59,7 +60,8 @@ class Binding {
 				 _info(vk::DescriptorImageInfo()
 					.setImageLayout(vk_image_layout(ImageUsage::StorageBit))
 					.setImageView(view.vk_view())
-					.setSampler(view.device()->vk_sampler())) {
+					.setSampler(view.device()->vk_sampler())),
+				 _upload(view.upload_fence()) {
 		}
 
 		template<ImageUsage Usage, ImageType Type>
@@ -99,6 +101,10 @@ class Binding {
 			return _type;
 		}
 
+		UploadFence upload_fence() const {
+			return _upload;
+		}
+
 		bool is_buffer() const {
 			switch(_type) {
 				case vk::DescriptorType::eUniformTexelBuffer:
@@ -130,6 +136,7 @@ class Binding {
 	private:
 		vk::DescriptorType _type;
 		DescriptorInfo _info;
+		UploadFence _upload;
 
 };
 
@@ -24,34 +24,8 @@ SOFTWARE.
 
 #include <yave/device/Device.h>
 
-#include <unordered_map>
-
 namespace yave {
 
-static vk::DescriptorPool create_descriptor_pool(DevicePtr dptr, const std::unordered_map<vk::DescriptorType, u32>& binding_counts) {
-	auto sizes = core::vector_with_capacity<vk::DescriptorPoolSize>(binding_counts.size());
-	std::transform(binding_counts.begin(), binding_counts.end(), std::back_inserter(sizes), [](const auto& count) {
-			return vk::DescriptorPoolSize()
-					.setType(count.first)
-					.setDescriptorCount(count.second)
-				;
-		});
-
-	return dptr->vk_device().createDescriptorPool(vk::DescriptorPoolCreateInfo()
-			.setPoolSizeCount(sizes.size())
-			.setPPoolSizes(sizes.begin())
-			.setMaxSets(1)
-		);
-}
-
-static vk::DescriptorSet create_descriptor_set(DevicePtr dptr, vk::DescriptorPool pool, vk::DescriptorSetLayout layout) {
-	return dptr->vk_device().allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(pool)
-			.setDescriptorSetCount(1)
-			.setPSetLayouts(&layout)
-		).front();
-}
-
 static void update_sets(DevicePtr dptr, vk::DescriptorSet set, const core::ArrayView<Binding>& bindings) {
 	auto writes = core::vector_with_capacity<vk::WriteDescriptorSet>(bindings.size());
 	for(const auto& binding : bindings) {
@@ -79,25 +53,49 @@ static void update_sets(DevicePtr dptr, vk::DescriptorSet set, const core::Array
 
 
 
-DescriptorSet::DescriptorSet(DevicePtr dptr, core::ArrayView<Binding> bindings) : DescriptorSetBase(dptr) {
+DescriptorSet::DescriptorSet(DevicePtr dptr, core::ArrayView<Binding> bindings, Lifetime lifetime) :
+		DescriptorSetBase(dptr),
+		_transient(lifetime == Lifetime::Transient) {
+
 	if(!bindings.is_empty()) {
 		auto layout_bindings = core::vector_with_capacity<vk::DescriptorSetLayoutBinding>(bindings.size());
-
-		std::unordered_map<vk::DescriptorType, u32> binding_counts;
 		for(const auto& binding : bindings) {
 			layout_bindings << binding.descriptor_set_layout_binding(layout_bindings.size());
-			++binding_counts[binding.vk_descriptor_type()];
+			_upload = _upload.merged(binding.upload_fence());
 		}
 
-		auto layout = dptr->create_descriptor_set_layout(layout_bindings);
-		_pool = create_descriptor_pool(dptr, binding_counts);
-		_set = create_descriptor_set(dptr, _pool, layout);
+		_layout = dptr->create_descriptor_set_layout(layout_bindings);
+
+		DescriptorSetAllocator& allocator = dptr->descriptor_set_allocator();
+		_set = _transient
+			? allocator.alloc_transient(_layout)
+			: allocator.alloc(_layout, layout_bindings);
+
 		update_sets(dptr, _set, bindings);
 	}
 }
 
+DescriptorSet::DescriptorSet(DescriptorSet&& other) {
+	swap(other);
+}
+
+DescriptorSet& DescriptorSet::operator=(DescriptorSet&& other) {
+	swap(other);
+	return *this;
+}
+
 DescriptorSet::~DescriptorSet() {
-	destroy(_pool);
+	if(device() && _set && !_transient) {
+		device()->descriptor_set_allocator().free(_layout, _set);
+	}
+}
+
+void DescriptorSet::swap(DescriptorSet& other) {
+	DeviceLinked::swap(other);
+	std::swap(_set, other._set);
+	std::swap(_layout, other._layout);
+	std::swap(_transient, other._transient);
+	std::swap(_upload, other._upload);
 }
 
 }
@@ -29,16 +29,26 @@ namespace yave {
 class DescriptorSet : public DescriptorSetBase {
 
 	public:
+		enum class Lifetime {
+			Persistent,
+			// Transient sets are recycled by the device once the current frame has completed and must not be kept around
+			Transient
+		};
+
 		DescriptorSet() = default;
-		DescriptorSet(DescriptorSet&&) = default;
-		DescriptorSet& operator=(DescriptorSet&&) = default;
 
-		DescriptorSet(DevicePtr dptr, core::ArrayView<Binding> bindings);
+		DescriptorSet(DescriptorSet&& other);
+		DescriptorSet& operator=(DescriptorSet&& other);
+
+		DescriptorSet(DevicePtr dptr, core::ArrayView<Binding> bindings, Lifetime lifetime = Lifetime::Persistent);
 
 		~DescriptorSet();
 
 	protected:
-		vk::DescriptorPool _pool;
+		void swap(DescriptorSet& other);
+
+		vk::DescriptorSetLayout _layout;
+		bool _transient = false;
 };
 
 }
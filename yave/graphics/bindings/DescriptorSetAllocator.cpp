@@ -0,0 +1,281 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "DescriptorSetAllocator.h"
+
+#include <yave/device/Device.h>
+
+#include <algorithm>
+#include <array>
+
+namespace yave {
+
+static vk::DescriptorPool create_pool(DevicePtr dptr, core::ArrayView<vk::DescriptorPoolSize> set_sizes, u32 set_count) {
+	auto sizes = core::vector_with_capacity<vk::DescriptorPoolSize>(set_sizes.size());
+	for(vk::DescriptorPoolSize size : set_sizes) {
+		sizes << size.setDescriptorCount(size.descriptorCount * set_count);
+	}
+
+	return dptr->vk_device().createDescriptorPool(vk::DescriptorPoolCreateInfo()
+			.setPoolSizeCount(sizes.size())
+			.setPPoolSizes(sizes.begin())
+			.setMaxSets(set_count)
+		);
+}
+
+static vk::Result try_alloc(DevicePtr dptr, vk::DescriptorPool pool, vk::DescriptorSetLayout layout, vk::DescriptorSet& set) {
+	const auto info = vk::DescriptorSetAllocateInfo()
+			.setDescriptorPool(pool)
+			.setDescriptorSetCount(1)
+			.setPSetLayouts(&layout)
+		;
+	return dptr->vk_device().allocateDescriptorSets(&info, &set);
+}
+
+
+DescriptorSetAllocator::DescriptorSetAllocator(DevicePtr dptr) : DeviceLinked(dptr) {
+}
+
+DescriptorSetAllocator::~DescriptorSetAllocator() {
+	for(auto& [layout, pools] : _layouts) {
+		unused(layout);
+		for(const auto& [pool, data] : pools.pools) {
+			unused(data);
+			destroy(vk::DescriptorPool(pool));
+		}
+	}
+	for(const RetiredPool& retired : _retired) {
+		destroy(retired.pool);
+	}
+	for(vk::DescriptorPool pool : _free_transient) {
+		destroy(pool);
+	}
+	if(_transient) {
+		destroy(_transient);
+	}
+}
+
+vk::DescriptorSet DescriptorSetAllocator::alloc(vk::DescriptorSetLayout layout, core::ArrayView<vk::DescriptorSetLayoutBinding> bindings) {
+	y_profile();
+
+	std::unique_lock lock(_lock);
+	collect_released();
+
+	++_stats.allocations;
+
+	LayoutPools& pools = _layouts[layout];
+	if(pools.sizes.is_empty()) {
+		for(const auto& binding : bindings) {
+			const auto it = std::find_if(pools.sizes.begin(), pools.sizes.end(), [&](const auto& size) { return size.type == binding.descriptorType; });
+			if(it == pools.sizes.end()) {
+				pools.sizes << vk::DescriptorPoolSize(binding.descriptorType, binding.descriptorCount);
+			} else {
+				it->descriptorCount += binding.descriptorCount;
+			}
+		}
+	}
+
+	while(!pools.available.is_empty()) {
+		const VkDescriptorPool handle = pools.available.last();
+		Pool& pool = pools.pools[handle];
+
+		if(!pool.free.is_empty()) {
+			++pool.live;
+			pool.used = true;
+			++_stats.recycled;
+			return pool.free.pop();
+		}
+
+		if(pool.remaining) {
+			vk::DescriptorSet set;
+			if(try_alloc(device(), vk::DescriptorPool(handle), layout, set) != vk::Result::eSuccess) {
+				y_fatal("Unable to allocate descriptor set.");
+			}
+			--pool.remaining;
+			++pool.live;
+			pool.used = true;
+			pools.owners[set] = handle;
+			return set;
+		}
+
+		pool.available = false;
+		pools.available.pop();
+	}
+
+	const VkDescriptorPool handle = create_pool(device(), pools.sizes, sets_per_pool);
+	Pool& pool = pools.pools[handle];
+	pools.available << handle;
+	++_stats.pools;
+
+	vk::DescriptorSet set;
+	if(try_alloc(device(), vk::DescriptorPool(handle), layout, set) != vk::Result::eSuccess) {
+		y_fatal("Unable to allocate descriptor set.");
+	}
+	--pool.remaining;
+	++pool.live;
+	pools.owners[set] = handle;
+	return set;
+}
+
+void DescriptorSetAllocator::free(vk::DescriptorSetLayout layout, vk::DescriptorSet set) {
+	const ResourceFence fence = device()->lifetime_manager().last_fence();
+
+	std::unique_lock lock(_released_lock);
+	_released.emplace_back(layout, std::pair(fence, set));
+	++_releases;
+}
+
+void DescriptorSetAllocator::collect_released() {
+	{
+		std::unique_lock lock(_released_lock);
+		for(const auto& [layout, released] : _released) {
+			_layouts[layout].released.push_back(released);
+		}
+		_released.make_empty();
+	}
+
+	const LifetimeManager& lifetime = device()->lifetime_manager();
+	for(auto& [layout, pools] : _layouts) {
+		unused(layout);
+		while(!pools.released.empty() && lifetime.is_complete(pools.released.front().first)) {
+			const vk::DescriptorSet set = pools.released.front().second;
+			pools.released.pop_front();
+
+			const VkDescriptorPool handle = pools.owners[set];
+			Pool& pool = pools.pools[handle];
+			pool.free << set;
+			--pool.live;
+			if(!pool.available) {
+				pool.available = true;
+				pools.available << handle;
+			}
+		}
+	}
+
+	if(lifetime.is_complete(_window)) {
+		close_window();
+		_window = lifetime.last_fence();
+	}
+}
+
+void DescriptorSetAllocator::close_window() {
+	y_profile();
+
+	core::Vector<VkDescriptorPool> idle;
+	for(auto& [layout, pools] : _layouts) {
+		unused(layout);
+		for(auto& [handle, pool] : pools.pools) {
+			pool.idle_windows = (pool.live || pool.used) ? 0 : pool.idle_windows + 1;
+			pool.used = false;
+			if(pool.idle_windows >= max_idle_windows) {
+				idle << handle;
+			}
+		}
+
+		for(VkDescriptorPool handle : idle) {
+			release_pool(pools, handle);
+		}
+		idle.make_empty();
+	}
+}
+
+void DescriptorSetAllocator::release_pool(LayoutPools& pools, VkDescriptorPool handle) {
+	const auto it = pools.pools.find(handle);
+	y_debug_assert(it != pools.pools.end() && !it->second.live);
+
+	// the pool is empty: every set it ever allocated is in its free list
+	for(vk::DescriptorSet set : it->second.free) {
+		pools.owners.erase(set);
+	}
+	pools.pools.erase(it);
+
+	if(const auto av = std::find(pools.available.begin(), pools.available.end(), handle); av != pools.available.end()) {
+		pools.available.erase(av);
+	}
+
+	destroy(vk::DescriptorPool(handle));
+	++_stats.released_pools;
+}
+
+vk::DescriptorSet DescriptorSetAllocator::alloc_transient(vk::DescriptorSetLayout layout) {
+	y_profile();
+
+	std::unique_lock lock(_lock);
+
+	++_stats.transient_allocations;
+
+	vk::DescriptorSet set;
+	if(_transient && try_alloc(device(), _transient, layout, set) == vk::Result::eSuccess) {
+		return set;
+	}
+
+	if(_transient) {
+		// sets allocated from a full pool can still be used by any command buffer that already exists
+		_retired.push_back(RetiredPool{device()->lifetime_manager().last_fence(), _transient});
+	}
+	_transient = create_transient_pool();
+
+	if(try_alloc(device(), _transient, layout, set) != vk::Result::eSuccess) {
+		y_fatal("Unable to allocate transient descriptor set.");
+	}
+	return set;
+}
+
+vk::DescriptorPool DescriptorSetAllocator::create_transient_pool() {
+	const LifetimeManager& lifetime = device()->lifetime_manager();
+	while(!_retired.empty() && lifetime.is_complete(_retired.front().fence)) {
+		const vk::DescriptorPool pool = _retired.front().pool;
+		device()->vk_device().resetDescriptorPool(pool);
+		_free_transient << pool;
+		_retired.pop_front();
+		++_stats.transient_resets;
+	}
+
+	if(!_free_transient.is_empty()) {
+		return _free_transient.pop();
+	}
+
+	const std::array<vk::DescriptorPoolSize, 4> sizes = {
+			vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, transient_descriptors_per_type),
+			vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, transient_descriptors_per_type),
+			vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, transient_descriptors_per_type),
+			vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, transient_descriptors_per_type),
+		};
+
+	++_stats.transient_pools;
+	return create_pool(device(), sizes, transient_sets_per_pool);
+}
+
+DescriptorSetAllocator::Stats DescriptorSetAllocator::stats() const {
+	Stats stats;
+	{
+		std::unique_lock lock(_lock);
+		stats = _stats;
+	}
+	{
+		std::unique_lock lock(_released_lock);
+		stats.releases = _releases;
+	}
+	return stats;
+}
+
+}
@@ -0,0 +1,131 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_BINDINGS_DESCRIPTORSETALLOCATOR_H
+#define YAVE_GRAPHICS_BINDINGS_DESCRIPTORSETALLOCATOR_H
+
+#include <yave/graphics/vk/vk.h>
+
+#include <yave/device/DeviceLinked.h>
+#include <yave/device/LifetimeManager.h>
+
+#include <y/core/Vector.h>
+#include <y/core/ArrayView.h>
+
+#include <unordered_map>
+#include <mutex>
+#include <deque>
+
+namespace yave {
+
+class DescriptorSetAllocator : NonCopyable, public DeviceLinked {
+
+	static constexpr u32 sets_per_pool = 64;
+	static constexpr u32 transient_sets_per_pool = 1024;
+	static constexpr u32 transient_descriptors_per_type = 4096;
+
+	// empty pools are destroyed after this many windows without any allocation
+	static constexpr u32 max_idle_windows = 16;
+
+	struct Pool {
+		u32 live = 0;
+		u32 remaining = sets_per_pool;
+		core::Vector<vk::DescriptorSet> free;
+
+		u32 idle_windows = 0;
+		bool used = true;
+
+		// true while the pool is in LayoutPools::available
+		bool available = true;
+	};
+
+	struct LayoutPools {
+		// descriptors needed by one set
+		core::Vector<vk::DescriptorPoolSize> sizes;
+
+		std::unordered_map<VkDescriptorPool, Pool> pools;
+		std::unordered_map<VkDescriptorSet, VkDescriptorPool> owners;
+
+		// pools that might have free sets or room for new ones, checked lazily
+		core::Vector<VkDescriptorPool> available;
+
+		std::deque<std::pair<ResourceFence, vk::DescriptorSet>> released;
+	};
+
+	struct RetiredPool {
+		ResourceFence fence;
+		vk::DescriptorPool pool;
+	};
+
+	public:
+		struct Stats {
+			usize allocations = 0;
+			usize recycled = 0;
+			usize releases = 0;
+			usize pools = 0;
+			usize released_pools = 0;
+
+			usize transient_allocations = 0;
+			usize transient_pools = 0;
+			usize transient_resets = 0;
+		};
+
+		DescriptorSetAllocator(DevicePtr dptr);
+		~DescriptorSetAllocator();
+
+		// Sets are suballocated from pools shared by every set with the same layout.
+		// Freed sets are recycled once every command buffer that might use them has completed.
+		// A window closes once every command buffer that existed when it opened has completed,
+		// pools that stay empty for max_idle_windows windows are destroyed.
+		vk::DescriptorSet alloc(vk::DescriptorSetLayout layout, core::ArrayView<vk::DescriptorSetLayoutBinding> bindings);
+		void free(vk::DescriptorSetLayout layout, vk::DescriptorSet set);
+
+		// Transient sets are never freed: their pool is reset once every command buffer created before it was full has completed.
+		// They should only be used by command buffers that already exist when they are allocated.
+		vk::DescriptorSet alloc_transient(vk::DescriptorSetLayout layout);
+
+		Stats stats() const;
+
+	private:
+		void collect_released();
+		void close_window();
+		void release_pool(LayoutPools& pools, VkDescriptorPool handle);
+		vk::DescriptorPool create_transient_pool();
+
+		mutable std::mutex _lock;
+		std::unordered_map<VkDescriptorSetLayout, LayoutPools> _layouts;
+		ResourceFence _window;
+
+		vk::DescriptorPool _transient;
+		std::deque<RetiredPool> _retired;
+		core::Vector<vk::DescriptorPool> _free_transient;
+
+		// free can be called while the lifetime manager is collecting, which alloc might wait for while holding _lock
+		mutable std::mutex _released_lock;
+		core::Vector<std::pair<VkDescriptorSetLayout, std::pair<ResourceFence, vk::DescriptorSet>>> _released;
+		usize _releases = 0;
+
+		Stats _stats;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_BINDINGS_DESCRIPTORSETALLOCATOR_H
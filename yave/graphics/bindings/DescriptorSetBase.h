@@ -35,6 +35,15 @@ class DescriptorSetBase : NonCopyable, public DeviceLinked {
 			return _set;
 		}
 
+		// command buffers binding the set wait for the uploads of the bound images
+		UploadFence upload_fence() const {
+			return _upload;
+		}
+
+		bool is_ready() const {
+			return _upload.is_null() || device()->staging_ring().is_ready(_upload);
+		}
+
 	protected:
 		DescriptorSetBase(DevicePtr dptr) : DeviceLinked(dptr) {
 		}
@@ -43,6 +52,7 @@ class DescriptorSetBase : NonCopyable, public DeviceLinked {
 		DescriptorSetBase& operator=(DescriptorSetBase&&) = default;
 
 		vk::DescriptorSet _set;
+		UploadFence _upload;
 };
 
 static_assert(is_safe_base<DescriptorSetBase>::value);
@@ -60,6 +60,18 @@ BufferBase::BufferBase(DevicePtr dptr, usize byte_size, BufferUsage usage, Memor
 	std::tie(_buffer, _memory) = alloc_buffer(dptr, byte_size, vk::BufferUsageFlagBits(usage), type);
 }
 
+BufferBase::BufferBase(DevicePtr dptr, usize byte_size, BufferUsage usage, DeviceMemory&& memory) : _size(byte_size), _usage(usage), _memory(std::move(memory)) {
+	_buffer = create_buffer(dptr, byte_size, vk::BufferUsageFlagBits(usage));
+	bind_buffer_memory(dptr, _buffer, _memory);
+}
+
+vk::MemoryRequirements BufferBase::memory_requirements(DevicePtr dptr, usize byte_size, BufferUsage usage) {
+	const vk::Buffer buffer = create_buffer(dptr, byte_size, vk::BufferUsageFlagBits(usage));
+	const vk::MemoryRequirements reqs = dptr->vk_device().getBufferMemoryRequirements(buffer);
+	dptr->vk_device().destroyBuffer(buffer);
+	return reqs;
+}
+
 BufferBase::~BufferBase() {
 	if(device()) {
 		device()->destroy(_buffer);
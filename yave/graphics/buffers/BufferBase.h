@@ -50,6 +50,11 @@ class BufferBase : NonCopyable {
 
 		BufferBase(DevicePtr dptr, usize byte_size, BufferUsage usage, MemoryType type);
 
+		// Binds the buffer to externally managed memory (that might be aliased)
+		BufferBase(DevicePtr dptr, usize byte_size, BufferUsage usage, DeviceMemory&& memory);
+
+		static vk::MemoryRequirements memory_requirements(DevicePtr dptr, usize byte_size, BufferUsage usage);
+
 	private:
 		usize _size = 0;
 		vk::Buffer _buffer;
@@ -24,7 +24,6 @@ SOFTWARE.
 #include "buffers.h"
 
 #include <yave/device/Device.h>
-#include <yave/graphics/commands/CmdBufferRecorder.h>
 
 namespace yave {
 
@@ -65,11 +64,4 @@ const void* Mapping::data() const {
 	return _mapping;
 }
 
-void Mapping::stage(const SubBuffer<BufferUsage::TransferDstBit>& dst, CmdBufferRecorder& recorder, const void* data) {
-	StagingBuffer buffer(dst.device(), dst.byte_size());
-	Mapping map(buffer);
-	std::memcpy(map.data(), data, dst.byte_size());
-	recorder.copy(buffer, dst);
-}
-
 }
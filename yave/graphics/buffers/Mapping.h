@@ -26,8 +26,6 @@ SOFTWARE.
 
 namespace yave {
 
-class CmdBufferRecorder;
-
 class Mapping : NonCopyable {
 
 	public:
@@ -39,8 +37,6 @@ class Mapping : NonCopyable {
 
 		Mapping(const SubBuffer<BufferUsage::None, MemoryType::CpuVisible>& buffer);
 
-		static void stage(const SubBuffer<BufferUsage::TransferDstBit>& dst, CmdBufferRecorder& recorder, const void* data);
-
 		~Mapping();
 
 		// No need to barrier after flush
@@ -0,0 +1,362 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "StagingRing.h"
+#include "Mapping.h"
+
+#include <yave/graphics/images/ImageBase.h>
+#include <yave/device/Device.h>
+
+namespace yave {
+
+static void pipeline_barrier(CmdBufferRecorder& recorder, vk::PipelineStageFlags src, vk::PipelineStageFlags dst, const vk::BufferMemoryBarrier& barrier) {
+	recorder.vk_cmd_buffer().pipelineBarrier(src, dst, vk::DependencyFlags(), 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+static void pipeline_barrier(CmdBufferRecorder& recorder, vk::PipelineStageFlags src, vk::PipelineStageFlags dst, const vk::ImageMemoryBarrier& barrier) {
+	recorder.vk_cmd_buffer().pipelineBarrier(src, dst, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+// the release and acquire barriers need to match, only their access masks differ.
+// The acquire half is kept until the graphic queue waits on the transfer.
+template<typename T>
+static void transfer_ownership(CmdBufferRecorder& release, core::Vector<T>& acquire, T barrier) {
+	barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+	barrier.setDstAccessMask(vk::AccessFlags());
+	pipeline_barrier(release, vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, barrier);
+
+	barrier.setSrcAccessMask(vk::AccessFlags());
+	barrier.setDstAccessMask(vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+	acquire << barrier;
+}
+
+
+StagingRing::StagingRing(DevicePtr dptr, usize byte_size) :
+		DeviceLinked(dptr),
+		_buffer(dptr, byte_size),
+		_alignment(std::max(min_alignment, StagingSubBuffer::alignment(dptr))),
+		_async_transfers(&dptr->transfer_queue() != &dptr->graphic_queue()),
+		_transfer_family(dptr->transfer_queue().family_index()),
+		_graphic_family(dptr->graphic_queue().family_index()),
+		_graphic_pool(dptr, _graphic_family),
+		_transfer_pool(dptr, _transfer_family) {
+
+	// staging memory lives in persistently mapped heaps
+	_mapping = static_cast<u8*>(SubBufferBase(_buffer).device_memory().map());
+	y_debug_assert(_mapping);
+}
+
+StagingRing::~StagingRing() {
+	if(device()) {
+		if(auto batch = take_batch(UploadFence(_upload_count))) {
+			device()->graphic_queue().submit<SyncSubmit>(std::move(*batch));
+		}
+		SubBufferBase(_buffer).device_memory().unmap();
+	}
+}
+
+UploadFence StagingRing::upload(const SubBuffer<BufferUsage::TransferDstBit>& dst, const void* data) {
+	std::unique_lock lock(_lock);
+
+	CmdBufferRecorder& recorder = transfer_recorder();
+	recorder.copy(stage(recorder, data, dst.byte_size()), dst);
+
+	if(_transfer_family != _graphic_family) {
+		transfer_ownership(recorder, _acquire.buffers, vk::BufferMemoryBarrier()
+				.setSrcQueueFamilyIndex(_transfer_family)
+				.setDstQueueFamilyIndex(_graphic_family)
+				.setBuffer(dst.vk_buffer())
+				.setOffset(dst.byte_offset())
+				.setSize(dst.byte_size())
+			);
+	}
+
+	return staged();
+}
+
+UploadFence StagingRing::upload(const ImageBase& image, const void* data, usize byte_size, core::ArrayView<vk::BufferImageCopy> regions) {
+	std::unique_lock lock(_lock);
+
+	CmdBufferRecorder& recorder = transfer_recorder();
+	const StagingSubBuffer staging = stage(recorder, data, byte_size);
+
+	auto copies = core::vector_with_capacity<vk::BufferImageCopy>(regions.size());
+	for(vk::BufferImageCopy copy : regions) {
+		copies << copy.setBufferOffset(copy.bufferOffset + staging.byte_offset());
+	}
+
+	const vk::ImageLayout layout = vk_image_layout(image.usage());
+	{
+		auto region = recorder.region("Image upload");
+		recorder.barriers({ImageBarrier::transition_barrier(image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal)});
+		recorder.vk_cmd_buffer().copyBufferToImage(staging.vk_buffer(), image.vk_image(), vk::ImageLayout::eTransferDstOptimal, copies.size(), copies.data());
+	}
+
+	if(_transfer_family != _graphic_family) {
+		// the layout transition is done by the ownership transfer
+		transfer_ownership(recorder, _acquire.images, vk::ImageMemoryBarrier()
+				.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+				.setNewLayout(layout)
+				.setSrcQueueFamilyIndex(_transfer_family)
+				.setDstQueueFamilyIndex(_graphic_family)
+				.setImage(image.vk_image())
+				.setSubresourceRange(vk::ImageSubresourceRange()
+						.setAspectMask(image.format().vk_aspect())
+						.setLayerCount(image.layers())
+						.setLevelCount(image.mipmaps())
+					)
+			);
+	} else {
+		recorder.barriers({ImageBarrier::transition_barrier(image, vk::ImageLayout::eTransferDstOptimal, layout)});
+	}
+
+	return staged();
+}
+
+bool StagingRing::is_ready(UploadFence fence) const {
+	return fence.value() <= _ready;
+}
+
+void StagingRing::flush() {
+	std::unique_lock lock(_lock);
+	flush_transfers();
+}
+
+std::optional<RecordedCmdBuffer> StagingRing::take_batch(UploadFence required) {
+	std::unique_lock lock(_lock);
+
+	flush_transfers();
+
+	// transfers complete in submission order, so the ones taken are always the oldest
+	const auto is_taken = [&](const Transfer& transfer) {
+		return transfer.last_upload <= required || device()->lifetime_manager().is_complete(transfer.fence);
+	};
+
+	const bool take_transfers = !_transfers.empty() && is_taken(_transfers.front());
+	if(!_graphic_batch && !take_transfers) {
+		return std::nullopt;
+	}
+
+	y_profile();
+
+	CmdBufferRecorder& recorder = graphic_recorder();
+
+	u64 ready = _ready;
+	if(_async_transfers) {
+		if(take_transfers && _transfer_family == _graphic_family) {
+			// there is no acquire barrier: this chains the semaphore waits with everything submitted after the batch
+			const auto barrier = vk::MemoryBarrier(vk::AccessFlags(), vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+			recorder.vk_cmd_buffer().pipelineBarrier(
+					vk::PipelineStageFlagBits::eTopOfPipe,
+					vk::PipelineStageFlagBits::eAllCommands,
+					vk::DependencyFlags(),
+					1, &barrier,
+					0, nullptr,
+					0, nullptr
+				);
+		}
+
+		for(; !_transfers.empty() && is_taken(_transfers.front()); _transfers.pop_front()) {
+			const Transfer& transfer = _transfers.front();
+
+			// waiting on a completed transfer is free
+			recorder.wait_for(transfer.semaphore);
+
+			const AcquireBarriers& acquire = transfer.acquire;
+			if(!acquire.buffers.is_empty() || !acquire.images.is_empty()) {
+				recorder.vk_cmd_buffer().pipelineBarrier(
+						vk::PipelineStageFlagBits::eAllCommands,
+						vk::PipelineStageFlagBits::eAllCommands,
+						vk::DependencyFlags(),
+						0, nullptr,
+						u32(acquire.buffers.size()), acquire.buffers.data(),
+						u32(acquire.images.size()), acquire.images.data()
+					);
+			}
+
+			ready = transfer.last_upload.value();
+		}
+	} else {
+		flush_mapping();
+
+		// transfers have been recorded in the batch itself, this makes them visible to everything submitted after it
+		const auto barrier = vk::MemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+		recorder.vk_cmd_buffer().pipelineBarrier(
+				vk::PipelineStageFlagBits::eTransfer,
+				vk::PipelineStageFlagBits::eAllCommands,
+				vk::DependencyFlags(),
+				1, &barrier,
+				0, nullptr,
+				0, nullptr
+			);
+
+		ready = _upload_count;
+	}
+
+	RecordedCmdBuffer recorded(std::move(recorder));
+	_graphic_batch = std::nullopt;
+
+	if(!_async_transfers) {
+		push_region(recorded.resource_fence());
+	}
+	++_stats.batches;
+
+	// the batch is submitted before anything else by the graphic queue, which holds its lock until then
+	_ready = ready;
+
+	return recorded;
+}
+
+StagingRing::Stats StagingRing::stats() const {
+	std::unique_lock lock(_lock);
+	Stats stats = _stats;
+	stats.used = _used;
+	stats.capacity = _buffer.byte_size();
+	stats.async_transfers = _async_transfers;
+	return stats;
+}
+
+CmdBufferRecorder& StagingRing::graphic_recorder() {
+	if(!_graphic_batch) {
+		_graphic_batch.emplace(_graphic_pool.create_buffer());
+	}
+	return *_graphic_batch;
+}
+
+CmdBufferRecorder& StagingRing::transfer_recorder() {
+	if(!_async_transfers) {
+		return graphic_recorder();
+	}
+	if(!_transfer_batch) {
+		_transfer_batch.emplace(_transfer_pool.create_buffer());
+	}
+	return *_transfer_batch;
+}
+
+StagingRing::StagingSubBuffer StagingRing::stage(CmdBufferRecorder& recorder, const void* data, usize byte_size) {
+	y_debug_assert(data);
+
+	++_stats.uploads;
+	_stats.uploaded_bytes += byte_size;
+	_pending_bytes += byte_size;
+
+	if(auto offset = alloc(byte_size)) {
+		std::memcpy(_mapping + offset.unwrap(), data, byte_size);
+		return StagingSubBuffer(_buffer, byte_size, offset.unwrap());
+	}
+
+	// too big for the ring or the ring is full: the data gets its own buffer, kept alive by the batch
+	++_stats.spills;
+	StagingBuffer spill(device(), byte_size);
+	std::memcpy(Mapping(spill).data(), data, byte_size);
+
+	const StagingSubBuffer staging(spill);
+	recorder.keep_alive(std::move(spill));
+	return staging;
+}
+
+UploadFence StagingRing::staged() {
+	const UploadFence fence(++_upload_count);
+	if(_async_transfers && _pending_bytes >= flush_threshold) {
+		flush_transfers();
+	}
+	return fence;
+}
+
+void StagingRing::flush_transfers() {
+	if(!_transfer_batch) {
+		return;
+	}
+
+	y_profile();
+
+	flush_mapping();
+
+	RecordedCmdBuffer recorded(std::move(*_transfer_batch));
+	_transfer_batch = std::nullopt;
+
+	Transfer transfer;
+	transfer.last_upload = UploadFence(_upload_count);
+	transfer.fence = recorded.resource_fence();
+	transfer.acquire = std::move(_acquire);
+	_acquire = AcquireBarriers();
+
+	push_region(transfer.fence);
+	transfer.semaphore = device()->transfer_queue().submit_sem(std::move(recorded));
+	_transfers.push_back(std::move(transfer));
+	++_stats.transfer_batches;
+}
+
+void StagingRing::flush_mapping() {
+	if(_pending_bytes) {
+		device()->vk_device().flushMappedMemoryRanges(SubBufferBase(_buffer).memory_range());
+		_pending_bytes = 0;
+	}
+}
+
+void StagingRing::push_region(ResourceFence fence) {
+	if(_batch_size) {
+		_regions.push_back(Region{fence, _batch_size});
+		_batch_size = 0;
+	}
+}
+
+core::Result<usize> StagingRing::alloc(usize byte_size) {
+	const usize capacity = _buffer.byte_size();
+	const usize aligned = memory::align_up_to(std::max(byte_size, usize(1)), _alignment);
+	if(aligned > capacity) {
+		return core::Err();
+	}
+
+	reclaim();
+
+	usize offset = _head;
+	usize needed = aligned;
+	if(offset + aligned > capacity) {
+		// the end of the buffer is skipped and only reclaimed with the allocation
+		needed += capacity - offset;
+		offset = 0;
+	}
+
+	if(needed > capacity - _used) {
+		return core::Err();
+	}
+
+	_head = (offset + aligned) % capacity;
+	_used += needed;
+	_batch_size += needed;
+
+	return core::Ok(offset);
+}
+
+void StagingRing::reclaim() {
+	while(!_regions.empty() && device()->lifetime_manager().is_complete(_regions.front().fence)) {
+		_used -= _regions.front().byte_size;
+		_regions.pop_front();
+	}
+
+	if(!_used) {
+		_head = 0;
+	}
+}
+
+}
@@ -0,0 +1,165 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_BUFFERS_STAGINGRING_H
+#define YAVE_GRAPHICS_BUFFERS_STAGINGRING_H
+
+#include "buffers.h"
+#include "UploadFence.h"
+
+#include <yave/device/LifetimeManager.h>
+#include <yave/graphics/commands/pool/CmdBufferPool.h>
+#include <yave/graphics/commands/RecordedCmdBuffer.h>
+#include <yave/graphics/queues/Semaphore.h>
+
+#include <y/core/Result.h>
+
+#include <optional>
+#include <atomic>
+#include <mutex>
+#include <deque>
+
+namespace yave {
+
+class ImageBase;
+
+class StagingRing : NonCopyable, public DeviceLinked {
+
+	static constexpr usize default_byte_size = 32 * 1024 * 1024;
+	static constexpr usize min_alignment = 256;
+
+	// pending transfers are submitted once they get this big, so that streaming overlaps with rendering
+	static constexpr usize flush_threshold = 4 * 1024 * 1024;
+
+	struct Region {
+		ResourceFence fence;
+		usize byte_size = 0;
+	};
+
+	// ownership acquire barriers that need to be recorded on the graphic queue once the transfer has been waited on
+	struct AcquireBarriers {
+		core::Vector<vk::BufferMemoryBarrier> buffers;
+		core::Vector<vk::ImageMemoryBarrier> images;
+	};
+
+	struct Transfer {
+		UploadFence last_upload;
+		ResourceFence fence;
+		Semaphore semaphore;
+		AcquireBarriers acquire;
+	};
+
+	public:
+		using StagingSubBuffer = SubBuffer<BufferUsage::TransferSrcBit>;
+
+		struct Stats {
+			usize uploads = 0;
+			usize uploaded_bytes = 0;
+			usize spills = 0;
+			usize batches = 0;
+			usize transfer_batches = 0;
+
+			usize used = 0;
+			usize capacity = 0;
+
+			bool async_transfers = false;
+		};
+
+		StagingRing() = default;
+		StagingRing(DevicePtr dptr, usize byte_size = default_byte_size);
+
+		~StagingRing();
+
+		// Copies data into the ring and records the transfer in the pending upload batch.
+		// The destination can only be used once the returned fence is ready, or by submissions that wait for it.
+		UploadFence upload(const SubBuffer<BufferUsage::TransferDstBit>& dst, const void* data);
+
+		// Region buffer offsets are relative to data. The image is left in the layout matching its usage.
+		UploadFence upload(const ImageBase& image, const void* data, usize byte_size, core::ArrayView<vk::BufferImageCopy> regions);
+
+		// Ready uploads are visible to anything submitted on the graphic queue from now on.
+		bool is_ready(UploadFence fence) const;
+
+		// Records work that needs to run on the graphic queue before anything submitted afterward (like image layout transitions).
+		template<typename F>
+		void record(F&& f) {
+			std::unique_lock lock(_lock);
+			f(graphic_recorder());
+		}
+
+		// Submits the pending transfers to the transfer queue without waiting for the next graphic submission.
+		void flush();
+
+		// Ends the pending graphic batch, which acquires the transfers that have completed along with the ones needed by required.
+		// Only required makes the batch wait on the transfer queue, everything else keeps streaming alongside rendering.
+		// It has to be submitted before the command buffers that depend on required.
+		// This is done by the graphic queue before every submission.
+		std::optional<RecordedCmdBuffer> take_batch(UploadFence required = UploadFence());
+
+		Stats stats() const;
+
+	private:
+		CmdBufferRecorder& graphic_recorder();
+		CmdBufferRecorder& transfer_recorder();
+
+		StagingSubBuffer stage(CmdBufferRecorder& recorder, const void* data, usize byte_size);
+		UploadFence staged();
+
+		void flush_transfers();
+		void flush_mapping();
+		void push_region(ResourceFence fence);
+
+		core::Result<usize> alloc(usize byte_size);
+		void reclaim();
+
+		mutable std::mutex _lock;
+
+		StagingBuffer _buffer;
+		u8* _mapping = nullptr;
+		usize _alignment = min_alignment;
+
+		usize _head = 0;
+		usize _used = 0;
+		usize _batch_size = 0;
+		usize _pending_bytes = 0;
+		std::deque<Region> _regions;
+
+		// transfers are recorded in the graphic batch when there is no queue other than the graphic one
+		bool _async_transfers = false;
+		u32 _transfer_family = 0;
+		u32 _graphic_family = 0;
+
+		CmdBufferPool<CmdBufferUsage::Disposable> _graphic_pool;
+		CmdBufferPool<CmdBufferUsage::Disposable> _transfer_pool;
+		std::optional<CmdBufferRecorder> _graphic_batch;
+		std::optional<CmdBufferRecorder> _transfer_batch;
+		AcquireBarriers _acquire;
+		std::deque<Transfer> _transfers;
+
+		u64 _upload_count = 0;
+		std::atomic<u64> _ready = 0;
+
+		Stats _stats;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_BUFFERS_STAGINGRING_H
@@ -0,0 +1,73 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_BUFFERS_UPLOADFENCE_H
+#define YAVE_GRAPHICS_BUFFERS_UPLOADFENCE_H
+
+#include <yave/yave.h>
+
+#include <algorithm>
+
+namespace yave {
+
+// Identifies an upload done through the StagingRing.
+// Uploads become usable in submission order, so a fence also covers every upload done before it.
+class UploadFence {
+	public:
+		UploadFence() = default;
+
+		bool is_null() const {
+			return !_value;
+		}
+
+		u64 value() const {
+			return _value;
+		}
+
+		// the fence of the latest of two uploads
+		UploadFence merged(const UploadFence& other) const {
+			return UploadFence(std::max(_value, other._value));
+		}
+
+		bool operator==(const UploadFence& other) const {
+			return _value == other._value;
+		}
+
+		bool operator!=(const UploadFence& other) const {
+			return _value != other._value;
+		}
+
+		bool operator<=(const UploadFence& other) const {
+			return _value <= other._value;
+		}
+
+	private:
+		friend class StagingRing;
+
+		UploadFence(u64 v) : _value(v) {
+		}
+
+		u64 _value = 0;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_BUFFERS_UPLOADFENCE_H
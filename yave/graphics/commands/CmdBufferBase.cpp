@@ -38,6 +38,14 @@ void CmdBufferBase::wait_for(const Semaphore& sem) {
 	_proxy->data().wait_for(sem);
 }
 
+void CmdBufferBase::wait_for_upload(UploadFence upload) {
+	_proxy->data().wait_for_upload(upload);
+}
+
+UploadFence CmdBufferBase::upload_dependency() const {
+	return _proxy->data().upload_dependency();
+}
+
 DevicePtr CmdBufferBase::device() const {
 	auto pool = _proxy ? _proxy->data().pool() : nullptr;
 	return pool ? pool->device() : nullptr;
@@ -36,6 +36,8 @@ struct CmdBufferBase : NonCopyable {
 
 		void wait() const;
 		void wait_for(const Semaphore& sem);
+		void wait_for_upload(UploadFence upload);
+		UploadFence upload_dependency() const;
 
 		template<typename T>
 		T wait_for(BoxSemaphore<T>&& t) {
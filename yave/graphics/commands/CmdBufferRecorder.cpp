@@ -21,6 +21,7 @@ SOFTWARE.
 **********************************/
 
 #include "CmdBufferRecorder.h"
+#include "RecordedCmdBuffer.h"
 
 #include <yave/material/Material.h>
 #include <yave/graphics/bindings/DescriptorSet.h>
@@ -31,7 +32,7 @@ SOFTWARE.
 namespace yave {
 
 static vk::CommandBufferUsageFlagBits cmd_usage(CmdBufferUsage u) {
-	return vk::CommandBufferUsageFlagBits(uenum(u) /*& ~uenum(CmdBufferUsage::Secondary)*/);
+	return vk::CommandBufferUsageFlagBits(uenum(u));
 }
 
 
@@ -43,7 +44,7 @@ CmdBufferRegion::~CmdBufferRegion() {
 	}
 }
 
-CmdBufferRegion::CmdBufferRegion(const CmdBufferRecorder& cmd_buffer, const char* name, const math::Vec4& color) :
+CmdBufferRegion::CmdBufferRegion(const CmdBufferBase& cmd_buffer, const char* name, const math::Vec4& color) :
 		DeviceLinked(cmd_buffer.device()),
 		_buffer(cmd_buffer.vk_cmd_buffer()) {
 
@@ -55,11 +56,23 @@ CmdBufferRegion::CmdBufferRegion(const CmdBufferRecorder& cmd_buffer, const char
 
 // -------------------------------------------------- RenderPassRecorder --------------------------------------------------
 
-RenderPassRecorder::RenderPassRecorder(CmdBufferRecorder& cmd_buffer, const Viewport& viewport) : _cmd_buffer(cmd_buffer), _viewport(viewport) {
+RenderPassRecorder::RenderPassRecorder(CmdBufferRecorder& cmd_buffer, const RenderPass& render_pass, const Viewport& viewport) :
+		_cmd_buffer(cmd_buffer),
+		_render_pass(&render_pass),
+		_viewport(viewport),
+		_primary(&cmd_buffer) {
+}
+
+RenderPassRecorder::RenderPassRecorder(CmdBufferBase& cmd_buffer, const RenderPass& render_pass, const Viewport& viewport) :
+		_cmd_buffer(cmd_buffer),
+		_render_pass(&render_pass),
+		_viewport(viewport) {
 }
 
 RenderPassRecorder::~RenderPassRecorder() {
-	_cmd_buffer.end_renderpass();
+	if(_primary) {
+		_primary->end_renderpass();
+	}
 }
 
 void RenderPassRecorder::bind_material(const Material& material) {
@@ -67,12 +80,16 @@ void RenderPassRecorder::bind_material(const Material& material) {
 }
 
 void RenderPassRecorder::bind_material(const MaterialTemplate* material, DescriptorSetList descriptor_sets) {
-	bind_pipeline(material->compile(*_cmd_buffer._render_pass), descriptor_sets);
+	bind_pipeline(material->compile(*_render_pass), descriptor_sets);
 }
 
 void RenderPassRecorder::bind_pipeline(const GraphicPipeline& pipeline, DescriptorSetList descriptor_sets) {
 	vk_cmd_buffer().bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.vk_pipeline());
 
+	for(const auto& d : descriptor_sets) {
+		_cmd_buffer.wait_for_upload(d.get().upload_fence());
+	}
+
 	auto ds = core::vector_with_capacity<vk::DescriptorSet>(descriptor_sets.size() + 1);
 	std::transform(descriptor_sets.begin(), descriptor_sets.end(), std::back_inserter(ds), [](const auto& d) { return d.get().vk_descriptor_set(); });
 
@@ -97,6 +114,15 @@ void RenderPassRecorder::draw(const vk::DrawIndirectCommand& indirect) {
 						 indirect.firstInstance);
 }
 
+void RenderPassRecorder::draw_indirect(const SubBuffer<BufferUsage::IndirectBit>& indirect, usize first_draw, usize draw_count) {
+	const usize stride = sizeof(vk::DrawIndexedIndirectCommand);
+	vk_cmd_buffer().drawIndexedIndirect(indirect.vk_buffer(), indirect.byte_offset() + first_draw * stride, u32(draw_count), u32(stride));
+}
+
+void RenderPassRecorder::wait_for_upload(UploadFence upload) {
+	_cmd_buffer.wait_for_upload(upload);
+}
+
 void RenderPassRecorder::bind_buffers(const SubBuffer<BufferUsage::IndexBit>& indices, const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs) {
 	bind_index_buffer(indices);
 	bind_attrib_buffers(attribs);
@@ -122,7 +148,7 @@ const Viewport& RenderPassRecorder::viewport() const {
 }
 
 CmdBufferRegion RenderPassRecorder::region(const char* name, const math::Vec4& color) {
-	return _cmd_buffer.region(name, color);
+	return CmdBufferRegion(_cmd_buffer, name, color);
 }
 
 DevicePtr RenderPassRecorder::device() const {
@@ -175,6 +201,17 @@ CmdBufferRegion CmdBufferRecorder::region(const char* name, const math::Vec4& co
 
 
 RenderPassRecorder CmdBufferRecorder::bind_framebuffer(const Framebuffer& framebuffer) {
+	bind_framebuffer(framebuffer, vk::SubpassContents::eInline);
+
+	// set viewport
+	auto size = framebuffer.size();
+	vk_cmd_buffer().setViewport(0, {vk::Viewport(0, 0, size.x(), size.y(), 0.0f, 1.0f)});
+	vk_cmd_buffer().setScissor(0, {vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(size.x(), size.y()))});
+
+	return RenderPassRecorder(*this, framebuffer.render_pass(), Viewport(size));
+}
+
+void CmdBufferRecorder::bind_framebuffer(const Framebuffer& framebuffer, vk::SubpassContents subpass) {
 	check_no_renderpass();
 
 	auto clear_values = core::vector_with_capacity<vk::ClearValue>(framebuffer.attachment_count() + 1);
@@ -191,15 +228,26 @@ RenderPassRecorder CmdBufferRecorder::bind_framebuffer(const Framebuffer& frameb
 			.setClearValueCount(u32(clear_values.size()))
 		;
 
-	vk_cmd_buffer().beginRenderPass(pass_info, vk::SubpassContents::eInline);
+	vk_cmd_buffer().beginRenderPass(pass_info, subpass);
 	_render_pass = &framebuffer.render_pass();
+}
 
-	// set viewport
-	auto size = framebuffer.size();
-	vk_cmd_buffer().setViewport(0, {vk::Viewport(0, 0, size.x(), size.y(), 0.0f, 1.0f)});
-	vk_cmd_buffer().setScissor(0, {vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(size.x(), size.y()))});
+void CmdBufferRecorder::execute(const Framebuffer& framebuffer, core::Vector<RecordedSecondaryCmdBuffer>&& secondaries) {
+	auto buffers = core::vector_with_capacity<vk::CommandBuffer>(secondaries.size());
+	std::transform(secondaries.begin(), secondaries.end(), std::back_inserter(buffers), [](const auto& s) { return s.vk_cmd_buffer(); });
+
+	bind_framebuffer(framebuffer, vk::SubpassContents::eSecondaryCommandBuffers);
+	if(!buffers.is_empty()) {
+		vk_cmd_buffer().executeCommands(u32(buffers.size()), buffers.begin());
+	}
+	end_renderpass();
 
-	return RenderPassRecorder(*this, Viewport(size));
+	for(const auto& s : secondaries) {
+		wait_for_upload(s.upload_dependency());
+	}
+
+	// secondary buffers are recycled with this one
+	keep_alive(std::move(secondaries));
 }
 
 void CmdBufferRecorder::dispatch(const ComputeProgram& program, const math::Vec3ui& size, DescriptorSetList descriptor_sets, const PushConstant& push_constants) {
@@ -210,6 +258,10 @@ void CmdBufferRecorder::dispatch(const ComputeProgram& program, const math::Vec3
 
 	vk_cmd_buffer().bindPipeline(vk::PipelineBindPoint::eCompute, program.vk_pipeline());
 
+	for(const auto& d : descriptor_sets) {
+		wait_for_upload(d.get().upload_fence());
+	}
+
 	if(!ds.is_empty()) {
 		vk_cmd_buffer().bindDescriptorSets(vk::PipelineBindPoint::eCompute, program.vk_pipeline_layout(), 0, ds.size(), ds.begin(), 0, nullptr);
 	}
@@ -289,6 +341,8 @@ void CmdBufferRecorder::copy(const SrcCopyImage& src, const DstCopyImage& dst) {
 		y_fatal("Image size do not match.");
 	}
 
+	wait_for_upload(src.upload_fence().merged(dst.upload_fence()));
+
 	auto src_resource = vk::ImageSubresourceLayers()
 		.setAspectMask(src.format().vk_aspect())
 		.setMipLevel(0)
@@ -307,6 +361,8 @@ void CmdBufferRecorder::copy(const SrcCopyImage& src, const DstCopyImage& dst) {
 }
 
 void CmdBufferRecorder::blit(const SrcCopyImage& src, const DstCopyImage& dst) {
+	wait_for_upload(src.upload_fence().merged(dst.upload_fence()));
+
 	vk::ImageBlit blit = vk::ImageBlit()
 			.setSrcSubresource(
 				vk::ImageSubresourceLayers()
@@ -328,6 +384,7 @@ void CmdBufferRecorder::transition_image(ImageBase& image, vk::ImageLayout src,
 }
 
 void CmdBufferRecorder::barriered_copy(const ImageBase& src,  const ImageBase& dst) {
+	wait_for_upload(src.upload_fence().merged(dst.upload_fence()));
 
 	{
 		std::array<ImageBarrier, 2> image_barriers = {
@@ -368,4 +425,41 @@ void CmdBufferRecorder::barriered_copy(const ImageBase& src,  const ImageBase& d
 	}
 }
 
+
+
+// -------------------------------------------------- SecondaryCmdBufferRecorder --------------------------------------------------
+
+SecondaryCmdBufferRecorder::SecondaryCmdBufferRecorder(CmdBuffer<CmdBufferUsage::Secondary>&& buffer, const Framebuffer& framebuffer) :
+		CmdBufferBase(std::move(buffer)),
+		_render_pass(*this, framebuffer.render_pass(), Viewport(framebuffer.size())) {
+
+	auto inheritance = vk::CommandBufferInheritanceInfo()
+			.setRenderPass(framebuffer.render_pass().vk_render_pass())
+			.setSubpass(0)
+			.setFramebuffer(framebuffer.vk_framebuffer())
+		;
+
+	auto info = vk::CommandBufferBeginInfo()
+			.setFlags(cmd_usage(CmdBufferUsage::Secondary))
+			.setPInheritanceInfo(&inheritance)
+		;
+
+	vk_cmd_buffer().begin(info);
+
+	// dynamic states are not inherited from the primary buffer
+	auto size = framebuffer.size();
+	vk_cmd_buffer().setViewport(0, {vk::Viewport(0, 0, size.x(), size.y(), 0.0f, 1.0f)});
+	vk_cmd_buffer().setScissor(0, {vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(size.x(), size.y()))});
+}
+
+SecondaryCmdBufferRecorder::~SecondaryCmdBufferRecorder() {
+	if(device()) {
+		y_fatal("SecondaryCmdBufferRecorder destroyed before end() was called.");
+	}
+}
+
+RenderPassRecorder& SecondaryCmdBufferRecorder::render_pass() {
+	return _render_pass;
+}
+
 }
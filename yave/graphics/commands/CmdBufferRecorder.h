@@ -92,8 +92,9 @@ struct CmdBufferRegion : NonCopyable, public DeviceLinked {
 
 	private:
 		friend class CmdBufferRecorder;
+		friend class RenderPassRecorder;
 
-		CmdBufferRegion(const CmdBufferRecorder& cmd_buffer, const char* name, const math::Vec4& color);
+		CmdBufferRegion(const CmdBufferBase& cmd_buffer, const char* name, const math::Vec4& color);
 
 		vk::CommandBuffer _buffer;
 };
@@ -112,6 +113,12 @@ class RenderPassRecorder : NonCopyable {
 		void draw(const vk::DrawIndexedIndirectCommand& indirect);
 		void draw(const vk::DrawIndirectCommand& indirect);
 
+		// indirect contains vk::DrawIndexedIndirectCommands
+		void draw_indirect(const SubBuffer<BufferUsage::IndirectBit>& indirect, usize first_draw, usize draw_count);
+
+		// for buffers filled through the staging ring, descriptor sets do this on their own
+		void wait_for_upload(UploadFence upload);
+
 		void bind_buffers(const SubBuffer<BufferUsage::IndexBit>& indices, const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs);
 		void bind_index_buffer(const SubBuffer<BufferUsage::IndexBit>& indices);
 		void bind_attrib_buffers(const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs);
@@ -125,11 +132,17 @@ class RenderPassRecorder : NonCopyable {
 
 	private:
 		friend class CmdBufferRecorder;
+		friend class SecondaryCmdBufferRecorder;
 
-		RenderPassRecorder(CmdBufferRecorder& cmd_buffer, const Viewport& viewport);
+		RenderPassRecorder(CmdBufferRecorder& cmd_buffer, const RenderPass& render_pass, const Viewport& viewport);
+		RenderPassRecorder(CmdBufferBase& cmd_buffer, const RenderPass& render_pass, const Viewport& viewport);
 
-		CmdBufferRecorder& _cmd_buffer;
+		CmdBufferBase& _cmd_buffer;
+		const RenderPass* _render_pass = nullptr;
 		Viewport _viewport;
+
+		// null when recording in a secondary buffer, that doesn't own the render pass
+		CmdBufferRecorder* _primary = nullptr;
 };
 
 class CmdBufferRecorder : public CmdBufferBase {
@@ -171,6 +184,9 @@ class CmdBufferRecorder : public CmdBufferBase {
 
 		void barriered_copy(const ImageBase& src,  const ImageBase& dst);
 
+		// Executes, in order, secondary buffers recorded for framebuffer in a render pass of their own
+		void execute(const Framebuffer& framebuffer, core::Vector<RecordedSecondaryCmdBuffer>&& secondaries);
+
 		// never use directly, needed for internal work
 		void transition_image(ImageBase& image, vk::ImageLayout src, vk::ImageLayout dst);
 
@@ -189,6 +205,19 @@ class CmdBufferRecorder : public CmdBufferBase {
 		const RenderPass* _render_pass = nullptr;
 };
 
+class SecondaryCmdBufferRecorder : public CmdBufferBase {
+	public:
+		// Secondary buffers record the content of a render pass begun by the primary buffer that executes them
+		SecondaryCmdBufferRecorder(CmdBuffer<CmdBufferUsage::Secondary>&& buffer, const Framebuffer& framebuffer);
+
+		~SecondaryCmdBufferRecorder();
+
+		RenderPassRecorder& render_pass();
+
+	private:
+		RenderPassRecorder _render_pass;
+};
+
 }
 
 #endif // YAVE_GRAPHICS_COMMANDS_CMDBUFFERRECORDER_H
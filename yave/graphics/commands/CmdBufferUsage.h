@@ -31,7 +31,8 @@ namespace yave {
 enum class CmdBufferUsage {
 	//Primary = uenum(vk::CommandBufferUsageFlagBits()), // eSimultaneousUse ?
 	Disposable = uenum(vk::CommandBufferUsageFlagBits::eOneTimeSubmit),
-	//Secondary = uenum((std::max(Primary, Disposable) << 1)) | uenum(vk::CommandBufferUsageFlagBits::eSimultaneousUse)
+	// secondary buffers are only recorded inside a render pass and executed once by a primary buffer
+	Secondary = uenum(vk::CommandBufferUsageFlagBits::eOneTimeSubmit) | uenum(vk::CommandBufferUsageFlagBits::eRenderPassContinue)
 };
 
 class CmdBufferBase;
@@ -45,6 +46,8 @@ class CmdBuffer;
 
 class RecordedCmdBuffer;
 class CmdBufferRecorder;
+class SecondaryCmdBufferRecorder;
+class RecordedSecondaryCmdBuffer;
 
 }
 
@@ -48,6 +48,26 @@ class RecordedCmdBuffer : public CmdBufferBase {
 		}
 };
 
+class RecordedSecondaryCmdBuffer : public CmdBufferBase {
+
+	CmdBufferBase&& end_recorder(SecondaryCmdBufferRecorder&& recorder) {
+		recorder.vk_cmd_buffer().end();
+		return std::move(recorder);
+	}
+
+	public:
+		RecordedSecondaryCmdBuffer() = default;
+		RecordedSecondaryCmdBuffer(RecordedSecondaryCmdBuffer&&) = default;
+		RecordedSecondaryCmdBuffer& operator=(RecordedSecondaryCmdBuffer&&) = default;
+
+		RecordedSecondaryCmdBuffer(SecondaryCmdBufferRecorder&& recorder) : RecordedSecondaryCmdBuffer(end_recorder(std::move(recorder))) {
+		}
+
+	private:
+		RecordedSecondaryCmdBuffer(CmdBufferBase&& other) : CmdBufferBase(std::move(other)) {
+		}
+};
+
 }
 
 #endif // YAVE_GRAPHICS_COMMANDS_RECORDEDCMDBUFFER_H
@@ -25,8 +25,12 @@ SOFTWARE.
 
 namespace yave {
 
-CmdBufferData::CmdBufferData(vk::CommandBuffer buf, vk::Fence fen, CmdBufferPoolBase* p) :
-		_cmd_buffer(buf), _fence(fen), _pool(p), _resource_fence(device()->lifetime_manager().create_fence()) {
+CmdBufferData::CmdBufferData(vk::CommandBuffer buf, vk::Fence fen, vk::CommandPool vk_pool, CmdBufferPoolBase* p) :
+		_cmd_buffer(buf), _fence(fen), _vk_pool(vk_pool), _pool(p) {
+
+	if(!is_secondary()) {
+		_resource_fence = device()->lifetime_manager().create_fence();
+	}
 }
 
 CmdBufferData::CmdBufferData(CmdBufferData&& other) {
@@ -40,10 +44,11 @@ CmdBufferData& CmdBufferData::operator=(CmdBufferData&& other) {
 
 CmdBufferData::~CmdBufferData() {
 	if(_pool) {
-		if(_fence && device()->vk_device().getFenceStatus(_fence) != vk::Result::eSuccess) {
+		// batched buffers never signal their own fence
+		if(_fence && !is_batched() && device()->vk_device().getFenceStatus(_fence) != vk::Result::eSuccess) {
 			y_fatal("CmdBuffer is still in use.");
 		}
-		device()->vk_device().freeCommandBuffers(_pool->vk_pool(), _cmd_buffer);
+		device()->vk_device().freeCommandBuffers(_vk_pool, _cmd_buffer);
 		device()->destroy(_fence);
 	}
 }
@@ -56,6 +61,10 @@ CmdBufferPoolBase* CmdBufferData::pool() const {
 	return _pool;
 }
 
+bool CmdBufferData::is_secondary() const {
+	return _pool && _pool->usage() == CmdBufferUsage::Secondary;
+}
+
 vk::CommandBuffer CmdBufferData::vk_cmd_buffer() const {
 	return _cmd_buffer;
 }
@@ -64,18 +73,38 @@ vk::Fence CmdBufferData::vk_fence() const {
 	return _fence;
 }
 
+vk::CommandPool CmdBufferData::vk_pool() const {
+	return _vk_pool;
+}
+
 ResourceFence CmdBufferData::resource_fence() const {
 	return _resource_fence;
 }
 
+vk::Fence CmdBufferData::vk_batch_fence() const {
+	return _batch_fence;
+}
+
+ResourceFence CmdBufferData::batch_resource_fence() const {
+	return _batch_resource_fence;
+}
+
+bool CmdBufferData::is_batched() const {
+	return bool(_batch_fence);
+}
+
 void CmdBufferData::swap(CmdBufferData& other) {
 	std::swap(_cmd_buffer, other._cmd_buffer);
 	std::swap(_fence, other._fence);
+	std::swap(_vk_pool, other._vk_pool);
 	std::swap(_keep_alive, other._keep_alive);
 	std::swap(_pool, other._pool);
 	std::swap(_signal, other._signal);
 	std::swap(_waits, other._waits);
+	std::swap(_uploads, other._uploads);
 	std::swap(_resource_fence, other._resource_fence);
+	std::swap(_batch_fence, other._batch_fence);
+	std::swap(_batch_resource_fence, other._batch_resource_fence);
 }
 
 void CmdBufferData::reset() {
@@ -84,10 +113,18 @@ void CmdBufferData::reset() {
 		device()->vk_device().resetFences({_fence});
 	}
 
-	_cmd_buffer.reset(vk::CommandBufferResetFlags());
+	// the command buffer itself has been reset along with the rest of its command pool
+
 	_waits.clear();
+	_uploads = UploadFence();
 	_signal = Semaphore();
-	_resource_fence = device()->lifetime_manager().create_fence();
+	_batch_fence = vk::Fence();
+	_batch_resource_fence = ResourceFence();
+
+	// the lifetime manager expects every fence to be submitted, which secondary buffers never are
+	if(!is_secondary()) {
+		_resource_fence = device()->lifetime_manager().create_fence();
+	}
 }
 
 void CmdBufferData::release_resources() {
@@ -100,6 +137,14 @@ void CmdBufferData::wait_for(const Semaphore& sem) {
 	}
 }
 
+void CmdBufferData::wait_for_upload(UploadFence upload) {
+	_uploads = _uploads.merged(upload);
+}
+
+UploadFence CmdBufferData::upload_dependency() const {
+	return _uploads;
+}
+
 
 
 CmdBufferDataProxy::CmdBufferDataProxy(CmdBufferData&& d) : _data(std::move(d)) {
@@ -107,8 +152,12 @@ CmdBufferDataProxy::CmdBufferDataProxy(CmdBufferData&& d) : _data(std::move(d))
 
 CmdBufferDataProxy::~CmdBufferDataProxy() {
 	if(_data.device()) {
-		_data.device()->lifetime_manager().recycle(std::move(_data));
-		//_data.pool()->release(std::move(_data));
+		if(_data.is_secondary()) {
+			// secondary buffers are kept alive by the primary buffer that executed them, so they are done by now
+			_data.pool()->release(std::move(_data));
+		} else {
+			_data.device()->lifetime_manager().recycle(std::move(_data));
+		}
 	}
 }
 
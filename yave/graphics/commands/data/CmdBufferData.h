@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <yave/graphics/commands/CmdBufferUsage.h>
 #include <yave/graphics/queues/Semaphore.h>
+#include <yave/graphics/buffers/UploadFence.h>
 #include <yave/device/LifetimeManager.h>
 
 namespace yave {
@@ -37,7 +38,7 @@ class CmdBufferData final : NonCopyable {
 	};
 
 	public:
-		CmdBufferData(vk::CommandBuffer buf, vk::Fence fen, CmdBufferPoolBase* p);
+		CmdBufferData(vk::CommandBuffer buf, vk::Fence fen, vk::CommandPool vk_pool, CmdBufferPoolBase* p);
 
 		CmdBufferData() = default;
 
@@ -48,15 +49,27 @@ class CmdBufferData final : NonCopyable {
 
 		DevicePtr device() const;
 		CmdBufferPoolBase* pool() const;
+		bool is_secondary() const;
 		vk::CommandBuffer vk_cmd_buffer() const;
 		vk::Fence vk_fence() const;
+		vk::CommandPool vk_pool() const;
 		ResourceFence resource_fence() const;
 
+		// Buffers submitted in a batch don't signal their own fence, but the one of the last buffer of the batch.
+		// That buffer is identified by its resource fence: once it has been retired its fence can't be relied on anymore.
+		vk::Fence vk_batch_fence() const;
+		ResourceFence batch_resource_fence() const;
+		bool is_batched() const;
+
 		void reset();
 		void release_resources();
 
 		void wait_for(const Semaphore& sem);
 
+		// the staging ring batch submitted along with the buffer will wait for the upload to complete
+		void wait_for_upload(UploadFence upload);
+		UploadFence upload_dependency() const;
+
 		template<typename T>
 		void keep_alive(T&& t) {
 			struct Box : KeepAlive {
@@ -74,14 +87,19 @@ class CmdBufferData final : NonCopyable {
 
 		vk::CommandBuffer _cmd_buffer;
 		vk::Fence _fence;
+		vk::CommandPool _vk_pool;
 
 		core::Vector<std::unique_ptr<KeepAlive>> _keep_alive;
 		CmdBufferPoolBase* _pool = nullptr;
 
 		Semaphore _signal;
 		core::Vector<Semaphore> _waits;
+		UploadFence _uploads;
 
 		ResourceFence _resource_fence;
+
+		vk::Fence _batch_fence;
+		ResourceFence _batch_resource_fence;
 };
 
 
@@ -36,6 +36,10 @@ class CmdBufferPool : public CmdBufferPoolBase {
 		CmdBufferPool(DevicePtr dptr) : CmdBufferPoolBase(dptr, Usage) {
 		}
 
+		// buffers can only be submitted to queues of queue_family
+		CmdBufferPool(DevicePtr dptr, u32 queue_family) : CmdBufferPoolBase(dptr, Usage, queue_family) {
+		}
+
 		CmdBuffer<Usage> create_buffer() {
 			return CmdBuffer<Usage>(alloc());
 		}
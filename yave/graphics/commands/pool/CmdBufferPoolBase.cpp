@@ -25,55 +25,53 @@ SOFTWARE.
 
 #include <y/core/Chrono.h>
 
+#include <algorithm>
 #include <mutex>
 
 namespace yave {
 
 static vk::CommandBufferLevel cmd_level(CmdBufferUsage u) {
-	unused(u);
-	return /*u == CmdBufferUsage::Secondary ? vk::CommandBufferLevel::eSecondary :*/ vk::CommandBufferLevel::ePrimary;
+	return u == CmdBufferUsage::Secondary ? vk::CommandBufferLevel::eSecondary : vk::CommandBufferLevel::ePrimary;
 }
 
-static vk::CommandPoolCreateFlagBits cmd_create_flags(CmdBufferUsage u) {
-	return u == CmdBufferUsage::Disposable ? vk::CommandPoolCreateFlagBits::eTransient : vk::CommandPoolCreateFlagBits();
+static vk::CommandPoolCreateFlags cmd_create_flags(CmdBufferUsage u) {
+	return u == CmdBufferUsage::Disposable || u == CmdBufferUsage::Secondary ? vk::CommandPoolCreateFlagBits::eTransient : vk::CommandPoolCreateFlags();
 }
 
-static vk::CommandPool create_pool(DevicePtr dptr, CmdBufferUsage usage) {
+static vk::CommandPool create_pool(DevicePtr dptr, CmdBufferUsage usage, u32 queue_family) {
 	return dptr->vk_device().createCommandPool(vk::CommandPoolCreateInfo()
-			.setQueueFamilyIndex(dptr->queue_family(QueueFamily::Graphics).index())
-			.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer | cmd_create_flags(usage))
+			.setQueueFamilyIndex(queue_family)
+			.setFlags(cmd_create_flags(usage))
 		);
 }
 
 CmdBufferPoolBase::CmdBufferPoolBase(DevicePtr dptr, CmdBufferUsage preferred) :
+		CmdBufferPoolBase(dptr, preferred, dptr->queue_family(QueueFamily::Graphics).index()) {
+}
+
+CmdBufferPoolBase::CmdBufferPoolBase(DevicePtr dptr, CmdBufferUsage preferred, u32 queue_family) :
 		DeviceLinked(dptr),
-		_pool(create_pool(dptr, preferred)),
-		_usage(preferred) {
+		_usage(preferred),
+		_queue_family(queue_family) {
 }
 
 CmdBufferPoolBase::~CmdBufferPoolBase() {
 	if(device()) {
-		if(_fences.size() != _cmd_buffers.size()) {
-			y_fatal("CmdBuffers are still in use.");
+		for(const auto& segment : _segments) {
+			if(segment->released.size() != segment->allocated) {
+				y_fatal("CmdBuffers are still in use.");
+			}
+		}
+		for(const auto& segment : _segments) {
+			segment->ready.clear();
+			segment->released.clear();
+			destroy(segment->pool);
 		}
-		join_all();
-		_cmd_buffers.clear();
-		destroy(_pool);
 	}
 }
 
-vk::CommandPool CmdBufferPoolBase::vk_pool() const {
-	return _pool;
-}
-
-void CmdBufferPoolBase::join_all() {
-	if(_fences.is_empty()/* || _usage == CmdBufferUsage::Secondary*/) {
-		return;
-	}
-
-	if(device()->vk_device().waitForFences(_fences.size(), _fences.data(), true, u64(-1)) != vk::Result::eSuccess) {
-		y_fatal("Unable to join fences.");
-	}
+CmdBufferUsage CmdBufferPoolBase::usage() const {
+	return _usage;
 }
 
 void CmdBufferPoolBase::release(CmdBufferData&& data) {
@@ -82,33 +80,75 @@ void CmdBufferPoolBase::release(CmdBufferData&& data) {
 		y_fatal("CmdBufferData was not returned to its original pool.");
 	}
 	data.release_resources();
+
 	std::unique_lock lock(_lock);
-	_cmd_buffers.push_back(std::move(data));
+	const auto it = std::find_if(_segments.begin(), _segments.end(), [&](const auto& s) { return s->pool == data.vk_pool(); });
+	y_debug_assert(it != _segments.end());
+
+	Segment& segment = **it;
+	segment.released.push_back(std::move(data));
+
+	// the current segment is reset once it's full
+	if(&segment != _current && segment.released.size() == segment.allocated) {
+		reset(segment);
+	}
 }
 
 std::unique_ptr<CmdBufferDataProxy> CmdBufferPoolBase::alloc() {
 	y_profile();
 	std::unique_lock lock(_lock);
-	if(!_cmd_buffers.is_empty()) {
-		CmdBufferData data = _cmd_buffers.pop();
+	if(!_current || _current->allocated == segment_size) {
+		_current = &next_segment();
+	}
+
+	Segment& segment = *_current;
+	++segment.allocated;
+	if(!segment.ready.is_empty()) {
+		CmdBufferData data = segment.ready.pop();
 		data.reset();
 		return std::make_unique<CmdBufferDataProxy>(std::move(data));
 	}
-	return std::make_unique<CmdBufferDataProxy>(create_data());
+	return std::make_unique<CmdBufferDataProxy>(create_data(segment));
+}
+
+CmdBufferPoolBase::Segment& CmdBufferPoolBase::next_segment() {
+	if(_current && _current->released.size() == _current->allocated) {
+		reset(*_current);
+	}
+
+	for(const auto& segment : _segments) {
+		if(!segment->allocated) {
+			return *segment;
+		}
+	}
+
+	auto& segment = _segments.emplace_back(std::make_unique<Segment>());
+	segment->pool = create_pool(device(), _usage, _queue_family);
+	return *segment;
+}
+
+void CmdBufferPoolBase::reset(Segment& segment) {
+	y_profile();
+	device()->vk_device().resetCommandPool(segment.pool, vk::CommandPoolResetFlags());
+	for(CmdBufferData& data : segment.released) {
+		segment.ready.push_back(std::move(data));
+	}
+	segment.released.make_empty();
+	segment.allocated = 0;
 }
 
-CmdBufferData CmdBufferPoolBase::create_data() {
+CmdBufferData CmdBufferPoolBase::create_data(Segment& segment) {
 	auto buffer = device()->vk_device().allocateCommandBuffers(vk::CommandBufferAllocateInfo()
 			.setCommandBufferCount(1)
-			.setCommandPool(_pool)
+			.setCommandPool(segment.pool)
 			.setLevel(cmd_level(_usage))
 		).back();
 
-	auto fence = device()->vk_device().createFence(vk::FenceCreateInfo());
+	// secondary buffers are never submitted, they complete with the primary buffer that executes them
+	// fences stay with their command buffer, which is reused once its segment is reset
+	auto fence = _usage == CmdBufferUsage::Secondary ? vk::Fence() : device()->vk_device().createFence(vk::FenceCreateInfo());
 
-	_fences << fence;
-	//log_msg("new command buffer created (" + core::str(uenum(_usage)) + ") " + _cmd_buffers.size() + " waiting");
-	return CmdBufferData(buffer, fence, this);
+	return CmdBufferData(buffer, fence, segment.pool, this);
 }
 
 }
@@ -36,10 +36,22 @@ class CmdBufferDataProxy;
 
 class CmdBufferPoolBase : NonCopyable, public DeviceLinked {
 
+	// Buffers are allocated from segments, each with a command pool of its own.
+	// Once the current segment has handed out segment_size buffers, another one takes over.
+	// Segments are reset as a whole, with vkResetCommandPool, once all their buffers have been released.
+	static constexpr usize segment_size = 16;
+
+	struct Segment : NonMovable {
+		vk::CommandPool pool;
+		core::Vector<CmdBufferData> ready;
+		core::Vector<CmdBufferData> released;
+		usize allocated = 0;
+	};
+
 	public:
 		~CmdBufferPoolBase();
 
-		vk::CommandPool vk_pool() const;
+		CmdBufferUsage usage() const;
 
 	protected:
 		friend class CmdBufferDataProxy;
@@ -47,20 +59,23 @@ class CmdBufferPoolBase : NonCopyable, public DeviceLinked {
 
 		CmdBufferPoolBase() = default;
 		CmdBufferPoolBase(DevicePtr dptr, CmdBufferUsage preferred);
+		CmdBufferPoolBase(DevicePtr dptr, CmdBufferUsage preferred, u32 queue_family);
 
 		void release(CmdBufferData&& data);
 		std::unique_ptr<CmdBufferDataProxy> alloc();
 
-		void join_all();
-
 	private:
-		CmdBufferData create_data();
+		CmdBufferData create_data(Segment& segment);
+
+		Segment& next_segment();
+		void reset(Segment& segment);
 
 		concurrent::SpinLock _lock;
-		vk::CommandPool _pool;
 		CmdBufferUsage _usage;
-		core::Vector<CmdBufferData> _cmd_buffers;
-		core::Vector<vk::Fence> _fences;
+		u32 _queue_family = 0;
+
+		core::Vector<std::unique_ptr<Segment>> _segments;
+		Segment* _current = nullptr;
 };
 
 static_assert(is_safe_base<CmdBufferPoolBase>::value);
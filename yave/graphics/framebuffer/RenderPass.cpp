@@ -154,6 +154,21 @@ static vk::RenderPass create_renderpass(DevicePtr dptr, RenderPass::ImageData de
 	;
 }
 
+// load ops and image layouts don't affect render pass compatibility
+static RenderPass::ImageData compatible_depth(ImageFormat format) {
+	return format.vk_format() == vk::Format::eUndefined
+		? RenderPass::ImageData()
+		: RenderPass::ImageData(format, ImageUsage::DepthBit, RenderPass::LoadOp::Load);
+}
+
+static core::Vector<RenderPass::ImageData> compatible_colors(core::ArrayView<ImageFormat> formats) {
+	auto colors = core::vector_with_capacity<RenderPass::ImageData>(formats.size());
+	for(ImageFormat format : formats) {
+		colors << RenderPass::ImageData(format, ImageUsage::ColorBit, RenderPass::LoadOp::Load);
+	}
+	return colors;
+}
+
 RenderPass::Layout::Layout(ImageData depth, core::ArrayView<ImageData> colors) : _depth(depth.format) {
 	_colors.reserve(colors.size());
 	std::transform(colors.begin(), colors.end(), std::back_inserter(_colors), [](const auto& e) { return e.format; });
@@ -187,6 +202,10 @@ RenderPass::RenderPass(DevicePtr dptr, core::ArrayView<ImageData> colors) :
 		RenderPass(dptr, ImageData(), colors) {
 }
 
+RenderPass::RenderPass(DevicePtr dptr, const Layout& layout) :
+		RenderPass(dptr, compatible_depth(layout._depth), compatible_colors(layout._colors)) {
+}
+
 RenderPass::~RenderPass() {
 	destroy(_render_pass);
 }
@@ -67,6 +67,8 @@ class RenderPass : NonCopyable, public DeviceLinked {
 				bool operator==(const Layout& other) const;
 
 			private:
+				friend class RenderPass;
+
 				ImageFormat _depth;
 				core::SmallVector<ImageFormat, 7> _colors;
 		};
@@ -78,6 +80,9 @@ class RenderPass : NonCopyable, public DeviceLinked {
 		RenderPass(DevicePtr dptr, ImageData depth, core::ArrayView<ImageData> colors);
 		RenderPass(DevicePtr dptr, core::ArrayView<ImageData> colors);
 
+		// Creates a render pass compatible with every render pass that has the given layout
+		RenderPass(DevicePtr dptr, const Layout& layout);
+
 		~RenderPass();
 
 		bool is_depth_only() const;
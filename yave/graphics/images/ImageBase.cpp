@@ -22,8 +22,7 @@ SOFTWARE.
 
 #include "ImageBase.h"
 
-#include <yave/graphics/buffers/buffers.h>
-#include <yave/graphics/buffers/Mapping.h>
+#include <yave/graphics/buffers/StagingRing.h>
 #include <yave/graphics/commands/CmdBufferRecorder.h>
 #include <yave/device/Device.h>
 
@@ -70,13 +69,6 @@ static auto get_copy_regions(const ImageData& data) {
 	return regions;
 }
 
-static auto get_staging_buffer(DevicePtr dptr, usize byte_size, const void* data) {
-	y_debug_assert(data);
-	auto staging_buffer = StagingBuffer(dptr, byte_size);
-	std::memcpy(Mapping(staging_buffer).data(), data, byte_size);
-	return staging_buffer;
-}
-
 static vk::ImageView create_view(DevicePtr dptr, vk::Image image, ImageFormat format, usize layers, usize mips, ImageType type) {
 	return dptr->vk_device().createImageView(vk::ImageViewCreateInfo()
 			.setImage(image)
@@ -100,32 +92,20 @@ static std::tuple<vk::Image, DeviceMemory, vk::ImageView> alloc_image(DevicePtr
 	return {image, std::move(memory), create_view(dptr, image, format, layers, mips, type)};
 }
 
-static void upload_data(ImageBase& image, const ImageData& data) {
+static UploadFence upload_data(ImageBase& image, const ImageData& data) {
 	y_profile();
 	DevicePtr dptr = image.device();
 
-	auto staging_buffer = get_staging_buffer(dptr, data.combined_byte_size(), data.data());
-	auto regions = get_copy_regions(data);
-
-	CmdBufferRecorder recorder(dptr->create_disposable_cmd_buffer());
-
-	{
-		auto region = recorder.region("Image upload");
-		recorder.barriers({ImageBarrier::transition_barrier(image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal)});
-		recorder.vk_cmd_buffer().copyBufferToImage(staging_buffer.vk_buffer(), image.vk_image(), vk::ImageLayout::eTransferDstOptimal, regions.size(), regions.data());
-		recorder.barriers({ImageBarrier::transition_barrier(image, vk::ImageLayout::eTransferDstOptimal, vk_image_layout(image.usage()))});
-	}
-
-	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+	return dptr->staging_ring().upload(image, data.data(), data.combined_byte_size(), get_copy_regions(data));
 }
 
 static void transition_image(ImageBase& image) {
 	y_profile();
 	DevicePtr dptr = image.device();
 
-	CmdBufferRecorder recorder(dptr->create_disposable_cmd_buffer());
-	recorder.barriers({ImageBarrier::transition_barrier(image, vk::ImageLayout::eUndefined, vk_image_layout(image.usage()))});
-	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+	dptr->staging_ring().record([&](CmdBufferRecorder& recorder) {
+		recorder.barriers({ImageBarrier::transition_barrier(image, vk::ImageLayout::eUndefined, vk_image_layout(image.usage()))});
+	});
 }
 
 static void check_layer_count(ImageType type, const math::Vec3ui& size, usize layers) {
@@ -169,7 +149,27 @@ ImageBase::ImageBase(DevicePtr dptr, ImageUsage usage, ImageType type, const Ima
 
 	std::tie(_image, _memory, _view) = alloc_image(dptr, _size, _layers, _mips, _format, _usage, type);
 
-	upload_data(*this, data);
+	_upload = upload_data(*this, data);
+}
+
+ImageBase::ImageBase(DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size, DeviceMemory&& memory) :
+		_size(size),
+		_format(format),
+		_usage(usage),
+		_memory(std::move(memory)) {
+
+	check_layer_count(ImageType::TwoD, _size, _layers);
+
+	_image = create_image(dptr, _size, _layers, _mips, _format, _usage, ImageType::TwoD);
+	bind_image_memory(dptr, _image, _memory);
+	_view = create_view(dptr, _image, _format, _layers, _mips, ImageType::TwoD);
+}
+
+vk::MemoryRequirements ImageBase::memory_requirements(DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size) {
+	const vk::Image image = create_image(dptr, size, 1, 1, format, usage, ImageType::TwoD);
+	const vk::MemoryRequirements reqs = dptr->vk_device().getImageMemoryRequirements(image);
+	dptr->vk_device().destroyImage(image);
+	return reqs;
 }
 
 ImageBase::~ImageBase() {
@@ -204,6 +204,14 @@ ImageUsage ImageBase::usage() const {
 	return _usage;
 }
 
+UploadFence ImageBase::upload_fence() const {
+	return _upload;
+}
+
+bool ImageBase::is_ready() const {
+	return _upload.is_null() || device()->staging_ring().is_ready(_upload);
+}
+
 vk::ImageView ImageBase::vk_view() const {
 	return _view;
 }
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include <yave/device/DeviceLinked.h>
 #include <yave/graphics/memory/DeviceMemory.h>
+#include <yave/graphics/buffers/UploadFence.h>
 
 namespace yave {
 
@@ -50,6 +51,10 @@ class ImageBase : NonCopyable {
 		ImageFormat format() const;
 		ImageUsage usage() const;
 
+		// images created from data are only usable once the data has been uploaded
+		UploadFence upload_fence() const;
+		bool is_ready() const;
+
 	protected:
 		ImageBase() = default;
 		ImageBase(ImageBase&&) = default;
@@ -58,6 +63,11 @@ class ImageBase : NonCopyable {
 		ImageBase(DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size, ImageType type = ImageType::TwoD, usize layers = 1, usize mips = 1);
 		ImageBase(DevicePtr dptr, ImageUsage usage, ImageType type, const ImageData& data);
 
+		// Binds the image to externally managed memory (that might be aliased), the image is left in an undefined layout
+		ImageBase(DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size, DeviceMemory&& memory);
+
+		static vk::MemoryRequirements memory_requirements(DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size);
+
 
 		math::Vec3ui _size;
 		u32 _layers = 1;
@@ -70,6 +80,8 @@ class ImageBase : NonCopyable {
 
 		vk::Image _image;
 		vk::ImageView _view;
+
+		UploadFence _upload;
 };
 
 static_assert(is_safe_base<ImageBase>::value);
@@ -70,7 +70,15 @@ usize ImageData::data_offset(usize layer, usize mip) const {
 }
 
 const u8* ImageData::data(usize layer, usize mip) const {
-	return _data.get() + data_offset(layer, mip);
+	return _data.data() + data_offset(layer, mip);
+}
+
+bool ImageData::is_compressed() const {
+	return _compressed;
+}
+
+void ImageData::set_compressed(bool compressed) {
+	_compressed = compressed;
 }
 
 ImageData::ImageData(const math::Vec2ui& size, const u8* data, ImageFormat format, u32 mips) :
@@ -79,9 +87,8 @@ ImageData::ImageData(const math::Vec2ui& size, const u8* data, ImageFormat forma
 		_layers(1),
 		_mips(mips) {
 
-	usize data_size = combined_byte_size();
-	_data = std::make_unique<u8[]>(data_size);
-	std::memcpy(_data.get(), data, data_size);
+	_storage.push_back(data, data + combined_byte_size());
+	_data = _storage;
 }
 
 }
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_GRAPHICS_IMAGES_IMAGEDATA_H
 
 #include <yave/utils/serde.h>
+#include <y/serde2/compressed.h>
 #include <y/math/Vec.h>
 
 #include "ImageFormat.h"
@@ -51,21 +52,36 @@ class ImageData : NonCopyable {
 
 		ImageData(const math::Vec2ui& size, const u8* data, ImageFormat format, u32 mips = 1);
 
+		// whether the pixel data is compressed when serialized (on by default)
+		bool is_compressed() const;
+		void set_compressed(bool compressed);
 
 
 
-		y_serialize2(fs::magic_number, AssetType::Image, u32(3),
-			_size.to<2>(), _layers, _mips, _format,
-			serde2::array(combined_byte_size(), _data.get()))
 
-		y_deserialize2(serde2::check(fs::magic_number, AssetType::Image, u32(3)),
+		y_serialize2(fs::magic_number, AssetType::Image, u32(4),
 			_size.to<2>(), _layers, _mips, _format,
-			serde2::func([this]() -> serde2::Result {
-				if(!_format.is_valid()) { return core::Err(); }
-				_data = std::make_unique<u8[]>(combined_byte_size());
-				return core::Ok();
-			}),
-			serde2::array(combined_byte_size(), _data.get()))
+			serde2::compressed_array(_compressed, combined_byte_size(), _data.data()))
+
+		// Version 3 predates compression and is read as is.
+		// When deserialized uncompressed from a mapped file, the data is borrowed from it and the ImageData must not outlive the reader
+		template<typename Arc, typename = std::enable_if_t<serde2::is_readable_archive_v<Arc>>>
+		serde2::Result deserialize(Arc& arc) noexcept {
+			try {
+				u32 version = 0;
+				if(!arc(serde2::check(fs::magic_number, AssetType::Image), version) || (version != 3 && version != 4)) {
+					return core::Err();
+				}
+				if(!arc(_size.to<2>(), _layers, _mips, _format) || !_format.is_valid()) {
+					return core::Err();
+				}
+				return version == 3
+					? arc(serde2::array_view(combined_byte_size(), _data, _storage))
+					: arc(serde2::compressed_array_view(combined_byte_size(), _data, _storage));
+			} catch(...) {
+				return core::Err();
+			}
+		}
 
 
 	private:
@@ -75,7 +91,10 @@ class ImageData : NonCopyable {
 		u32 _layers = 1;
 		u32 _mips = 1;
 
-		std::unique_ptr<u8[]> _data;
+		core::Span<u8> _data;
+		core::Vector<u8> _storage;
+
+		bool _compressed = true;
 };
 
 }
@@ -42,12 +42,12 @@ class ImageView : public DeviceLinked {
 		ImageView() = default;
 
 		template<ImageUsage U, typename = std::enable_if_t<is_compatible(U)>>
-		ImageView(const Image<U, Type>& img) : ImageView(img.device(), img.size(), img.usage(), img.format(), img.vk_view(), img.vk_image()) {
+		ImageView(const Image<U, Type>& img) : ImageView(img.device(), img.size(), img.usage(), img.format(), img.vk_view(), img.vk_image(), img.upload_fence()) {
 			static_assert(is_compatible(U));
 		}
 
 		template<ImageUsage U, typename = std::enable_if_t<is_compatible(U)>>
-		ImageView(const ImageView<U, Type>& img) : ImageView(img.device(), img.size(), img.usage(), img.format(), img.vk_view(), img.vk_image()) {
+		ImageView(const ImageView<U, Type>& img) : ImageView(img.device(), img.size(), img.usage(), img.format(), img.vk_view(), img.vk_image(), img.upload_fence()) {
 			static_assert(is_compatible(U));
 		}
 
@@ -71,6 +71,10 @@ class ImageView : public DeviceLinked {
 			return _size;
 		}
 
+		UploadFence upload_fence() const {
+			return _upload;
+		}
+
 		bool operator==(const ImageView& other) const {
 			return _view == other._view;
 		}
@@ -80,13 +84,14 @@ class ImageView : public DeviceLinked {
 		}
 
 	protected:
-		ImageView(DevicePtr dptr, const size_type& size, ImageUsage usage, ImageFormat format, vk::ImageView view, vk::Image image) :
+		ImageView(DevicePtr dptr, const size_type& size, ImageUsage usage, ImageFormat format, vk::ImageView view, vk::Image image, UploadFence upload = UploadFence()) :
 				DeviceLinked(dptr),
 				_size(size),
 				_usage(usage),
 				_format(format),
 				_view(view),
-				_image(image) {
+				_image(image),
+				_upload(upload) {
 		}
 
 
@@ -99,6 +104,7 @@ class ImageView : public DeviceLinked {
 		ImageFormat _format;
 		vk::ImageView _view;
 		vk::Image _image;
+		UploadFence _upload;
 };
 
 using TextureView = ImageView<ImageUsage::TextureBit>;
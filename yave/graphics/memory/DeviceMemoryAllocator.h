@@ -42,6 +42,7 @@ class DeviceMemoryAllocator : NonCopyable, public DeviceLinked {
 
 		DeviceMemory alloc(vk::Image image);
 		DeviceMemory alloc(vk::Buffer buffer, MemoryType type);
+		DeviceMemory alloc(vk::MemoryRequirements reqs, MemoryType type);
 
 		auto heaps() const {
 			return core::Range(_heaps.begin(), _heaps.end());
@@ -52,7 +53,6 @@ class DeviceMemoryAllocator : NonCopyable, public DeviceLinked {
 		}
 
 	private:
-		DeviceMemory alloc(vk::MemoryRequirements reqs, MemoryType type);
 		DeviceMemory dedicated_alloc(vk::MemoryRequirements reqs, MemoryType type);
 
 		std::unordered_map<HeapType, core::Vector<std::unique_ptr<DeviceMemoryHeap>>> _heaps;
@@ -23,33 +23,12 @@ SOFTWARE.
 #include "DeviceMemoryHeap.h"
 #include "alloc.h"
 
-#include <numeric>
-#include <mutex>
-
 namespace yave {
 
-static usize align_size(usize total_byte_size, usize alignent) {
-	return (total_byte_size + alignent - 1) & ~(alignent - 1);
-}
-
-usize DeviceMemoryHeap::FreeBlock::end_offset() const {
-	return offset + size;
-}
-
-bool DeviceMemoryHeap::FreeBlock::contiguous(const FreeBlock& blck) const {
-	return end_offset() == blck.offset || blck.end_offset() == offset;
-}
-
-void DeviceMemoryHeap::FreeBlock::merge(const FreeBlock& block) {
-	y_debug_assert(contiguous(block));
-	std::tie(offset, size) = std::tuple{std::min(offset, block.offset), size + block.size};
-}
-
-
 DeviceMemoryHeap::DeviceMemoryHeap(DevicePtr dptr, u32 type_bits, MemoryType type) :
 		DeviceMemoryHeapBase(dptr),
 		_memory(alloc_memory(dptr, heap_size, type_bits, type)),
-		_blocks({FreeBlock{0, heap_size}}),
+		_allocator(heap_size, alignment),
 		_mapping(is_cpu_visible(type)
 				? static_cast<u8*>(device()->vk_device().mapMemory(_memory, 0, heap_size))
 				: nullptr
@@ -57,10 +36,7 @@ DeviceMemoryHeap::DeviceMemoryHeap(DevicePtr dptr, u32 type_bits, MemoryType typ
 }
 
 DeviceMemoryHeap::~DeviceMemoryHeap() {
-	if(_blocks.size() != 1) {
-		y_fatal("Not all memory has been free: heap fragmented.");
-	}
-	if(_blocks[0].offset || _blocks[0].size != heap_size) {
+	if(_allocator.available() != heap_size) {
 		y_fatal("Not all memory has been freed.");
 	}
 	if(_mapping) {
@@ -74,72 +50,16 @@ DeviceMemory DeviceMemoryHeap::create(usize offset, usize size) {
 }
 
 core::Result<DeviceMemory> DeviceMemoryHeap::alloc(vk::MemoryRequirements reqs) {
-	usize size = align_size(reqs.size, alignment);
-
-	for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
-		usize full_size = it->size;
-
-		if(full_size < size) {
-			continue;
-		}
-
-		usize offset = it->offset;
-
-		usize aligned_offset = align_size(offset, reqs.alignment);
-		usize align_correction = aligned_offset - offset;
-		usize aligned_size = full_size - align_correction;
-
-		y_debug_assert(aligned_size % alignment == 0);
-		y_debug_assert(aligned_offset % alignment == 0);
-		y_debug_assert(aligned_offset % reqs.alignment == 0);
-
-		if(aligned_size == size) {
-			_blocks.erase_unordered(it);
-			if(align_correction) {
-				_blocks << FreeBlock{offset, align_correction};
-			}
-			return core::Ok(create(aligned_offset, size));
-		} else if(aligned_size > size) {
-			usize end = offset + full_size;
-			it->size = end - (it->offset = aligned_offset + size);
-			if(align_correction) {
-				_blocks << FreeBlock{offset, align_correction};
-			}
-			return core::Ok(create(aligned_offset, size));
-		}
+	if(auto offset = _allocator.alloc(reqs.size, reqs.alignment)) {
+		const usize size = (reqs.size + alignment - 1) & ~(alignment - 1);
+		return core::Ok(create(offset.unwrap(), size));
 	}
-
 	return core::Err();
 }
 
 void DeviceMemoryHeap::free(const DeviceMemory& memory) {
 	y_debug_assert(memory.vk_memory() == _memory);
-	free(FreeBlock {memory.vk_offset(), memory.vk_size()});
-}
-
-void DeviceMemoryHeap::free(const FreeBlock& block) {
-	y_debug_assert(block.end_offset() <= heap_size);
-	compact_block(block);
-}
-
-void DeviceMemoryHeap::compact_block(FreeBlock block) {
-	y_profile();
-	// sort ?
-	bool compacted = false;
-	do {
-		compacted = false;
-		for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
-			FreeBlock b = *it;
-			if(b.contiguous(block)) {
-				_blocks.erase_unordered(it);
-				b.merge(block);
-				block = b;
-				compacted = true;
-				break;
-			}
-		}
-	} while(compacted);
-	_blocks << block;
+	_allocator.free(memory.vk_offset());
 }
 
 void* DeviceMemoryHeap::map(const DeviceMemoryView& view) {
@@ -154,15 +74,19 @@ usize DeviceMemoryHeap::size() const {
 }
 
 usize DeviceMemoryHeap::available() const {
-	usize tot = 0;
-	for(const auto& b : _blocks) {
-		tot += b.size;
-	}
-	return tot;
+	return _allocator.available();
 }
 
 usize DeviceMemoryHeap::free_blocks() const {
-	return _blocks.size();
+	return _allocator.free_blocks();
+}
+
+usize DeviceMemoryHeap::largest_free_block() const {
+	return _allocator.largest_free_block();
+}
+
+float DeviceMemoryHeap::fragmentation() const {
+	return _allocator.fragmentation();
 }
 
 }
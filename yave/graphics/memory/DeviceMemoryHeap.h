@@ -25,21 +25,13 @@ SOFTWARE.
 #include <y/concurrent/SpinLock.h>
 
 #include "DeviceMemoryHeapBase.h"
+#include "TLSFAllocator.h"
 
 namespace yave {
 
 // For DeviceAllocator, should not be used directly
 class DeviceMemoryHeap : public DeviceMemoryHeapBase {
 
-	struct FreeBlock {
-		usize offset;
-		usize size;
-
-		usize end_offset() const;
-		bool contiguous(const FreeBlock& blck) const;
-		void merge(const FreeBlock& block);
-	};
-
 	public:
 		static constexpr usize alignment = 256;
 
@@ -58,20 +50,18 @@ class DeviceMemoryHeap : public DeviceMemoryHeapBase {
 		void unmap(const DeviceMemoryView&) override;
 
 		usize size() const;
-		usize available() const; // slow!
+		usize available() const;
 		usize free_blocks() const;
+		usize largest_free_block() const;
+		float fragmentation() const;
 
 		bool mapped() const;
 
 	private:
-		void swap(DeviceMemoryHeap& other);
-
 		DeviceMemory create(usize offset, usize size);
-		void free(const FreeBlock& block);
-		void compact_block(FreeBlock block);
 
 		vk::DeviceMemory _memory;
-		core::Vector<FreeBlock> _blocks;
+		TLSFAllocator _allocator;
 		u8* _mapping = nullptr;
 
 };
@@ -0,0 +1,302 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TLSFAllocator.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace yave {
+
+static usize align_up(usize value, usize alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static usize lowest_bit(u64 bits) {
+	y_debug_assert(bits);
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward64(&index, bits);
+	return index;
+#else
+	return usize(__builtin_ctzll(bits));
+#endif
+}
+
+static usize highest_bit(u64 bits) {
+	y_debug_assert(bits);
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanReverse64(&index, bits);
+	return index;
+#else
+	return usize(63 - __builtin_clzll(bits));
+#endif
+}
+
+
+TLSFAllocator::TLSFAllocator(usize size, usize granularity) :
+		_size(size / granularity * granularity),
+		_granularity(granularity) {
+
+	y_debug_assert(granularity);
+
+	for(auto& lists : _free_lists) {
+		lists.fill(null_index);
+	}
+
+	if(_size) {
+		const u32 index = create_block();
+		_blocks[index].size = _size;
+		insert_free(index);
+		_available = _size;
+	}
+}
+
+// returns the list containing blocks of the given size (in granules)
+std::pair<usize, usize> TLSFAllocator::mapping(usize size) const {
+	if(size < sl_count) {
+		return {0, size};
+	}
+	const usize high = highest_bit(size);
+	return {high - sl_bits + 1, (size >> (high - sl_bits)) - sl_count};
+}
+
+// returns a free block of at least size bytes
+u32 TLSFAllocator::find_free(usize size) const {
+	usize granules = size / _granularity;
+	if(granules >= sl_count) {
+		// round up to the next list so that every block in it is big enough
+		granules += (usize(1) << (highest_bit(granules) - sl_bits)) - 1;
+	}
+
+	auto [fl, sl] = mapping(granules);
+	if(fl >= fl_count) {
+		return null_index;
+	}
+
+	u32 sl_bitmap = _sl_bitmaps[fl] & (~u32(0) << sl);
+	if(!sl_bitmap) {
+		const u64 fl_bitmap = fl + 1 < 64 ? _fl_bitmap & (~u64(0) << (fl + 1)) : 0;
+		if(!fl_bitmap) {
+			return null_index;
+		}
+		fl = lowest_bit(fl_bitmap);
+		sl_bitmap = _sl_bitmaps[fl];
+	}
+	sl = lowest_bit(sl_bitmap);
+
+	return _free_lists[fl][sl];
+}
+
+void TLSFAllocator::insert_free(u32 index) {
+	Block& block = _blocks[index];
+	const auto [fl, sl] = mapping(block.size / _granularity);
+
+	const u32 head = _free_lists[fl][sl];
+	block.is_free = true;
+	block.prev_free = null_index;
+	block.next_free = head;
+	if(head != null_index) {
+		_blocks[head].prev_free = index;
+	}
+
+	_free_lists[fl][sl] = index;
+	_sl_bitmaps[fl] |= u32(1) << sl;
+	_fl_bitmap |= u64(1) << fl;
+
+	++_free_blocks;
+}
+
+void TLSFAllocator::remove_free(u32 index) {
+	Block& block = _blocks[index];
+	y_debug_assert(block.is_free);
+
+	if(block.prev_free != null_index) {
+		_blocks[block.prev_free].next_free = block.next_free;
+	} else {
+		const auto [fl, sl] = mapping(block.size / _granularity);
+		_free_lists[fl][sl] = block.next_free;
+		if(block.next_free == null_index) {
+			_sl_bitmaps[fl] &= ~(u32(1) << sl);
+			if(!_sl_bitmaps[fl]) {
+				_fl_bitmap &= ~(u64(1) << fl);
+			}
+		}
+	}
+	if(block.next_free != null_index) {
+		_blocks[block.next_free].prev_free = block.prev_free;
+	}
+
+	block.is_free = false;
+	block.prev_free = block.next_free = null_index;
+
+	--_free_blocks;
+}
+
+u32 TLSFAllocator::create_block() {
+	if(!_unused_blocks.is_empty()) {
+		const u32 index = _unused_blocks.pop();
+		_blocks[index] = Block();
+		return index;
+	}
+	_blocks.emplace_back();
+	return u32(_blocks.size() - 1);
+}
+
+// shrinks the block to size and returns a new block for the remainder
+u32 TLSFAllocator::split(u32 index, usize size) {
+	const u32 next = create_block();
+
+	Block& block = _blocks[index];
+	Block& remainder = _blocks[next];
+	y_debug_assert(block.size > size);
+
+	remainder.offset = block.offset + size;
+	remainder.size = block.size - size;
+	remainder.prev_phys = index;
+	remainder.next_phys = block.next_phys;
+	if(block.next_phys != null_index) {
+		_blocks[block.next_phys].prev_phys = next;
+	}
+
+	block.size = size;
+	block.next_phys = next;
+
+	return next;
+}
+
+// absorbs the next physical block, which should not be in any free list
+void TLSFAllocator::merge_next(u32 index) {
+	Block& block = _blocks[index];
+	const u32 next = block.next_phys;
+	Block& next_block = _blocks[next];
+
+	block.size += next_block.size;
+	block.next_phys = next_block.next_phys;
+	if(block.next_phys != null_index) {
+		_blocks[block.next_phys].prev_phys = index;
+	}
+
+	_unused_blocks << next;
+}
+
+core::Result<usize> TLSFAllocator::alloc(usize size, usize alignment) {
+	y_debug_assert(alignment && (alignment & (alignment - 1)) == 0);
+
+	size = align_up(std::max(size, usize(1)), _granularity);
+	alignment = std::max(alignment, _granularity);
+
+	// blocks always start on a granule, so at most alignment - granularity bytes are lost to alignment
+	const usize padded_size = size + (alignment - _granularity);
+	u32 index = find_free(padded_size);
+	if(index == null_index) {
+		return core::Err();
+	}
+	remove_free(index);
+
+	const usize padding = align_up(_blocks[index].offset, alignment) - _blocks[index].offset;
+	if(padding) {
+		const u32 aligned = split(index, padding);
+		insert_free(index);
+		index = aligned;
+	}
+	if(_blocks[index].size > size) {
+		insert_free(split(index, size));
+	}
+
+	_available -= size;
+
+	const usize offset = _blocks[index].offset;
+	_allocated[offset] = index;
+	return core::Ok(offset);
+}
+
+void TLSFAllocator::free(usize offset) {
+	const auto it = _allocated.find(offset);
+	if(it == _allocated.end()) {
+		y_fatal("Invalid free: offset was not allocated.");
+	}
+
+	u32 index = it->second;
+	_allocated.erase(it);
+
+	_available += _blocks[index].size;
+
+	const u32 prev = _blocks[index].prev_phys;
+	if(prev != null_index && _blocks[prev].is_free) {
+		remove_free(prev);
+		merge_next(prev);
+		index = prev;
+	}
+
+	const u32 next = _blocks[index].next_phys;
+	if(next != null_index && _blocks[next].is_free) {
+		remove_free(next);
+		merge_next(index);
+	}
+
+	insert_free(index);
+}
+
+usize TLSFAllocator::size() const {
+	return _size;
+}
+
+usize TLSFAllocator::granularity() const {
+	return _granularity;
+}
+
+usize TLSFAllocator::available() const {
+	return _available;
+}
+
+usize TLSFAllocator::allocations() const {
+	return _allocated.size();
+}
+
+usize TLSFAllocator::free_blocks() const {
+	return _free_blocks;
+}
+
+usize TLSFAllocator::largest_free_block() const {
+	if(!_fl_bitmap) {
+		return 0;
+	}
+
+	// only the highest non empty list needs to be searched
+	const usize fl = highest_bit(_fl_bitmap);
+	const usize sl = highest_bit(_sl_bitmaps[fl]);
+
+	usize largest = 0;
+	for(u32 index = _free_lists[fl][sl]; index != null_index; index = _blocks[index].next_free) {
+		largest = std::max(largest, _blocks[index].size);
+	}
+	return largest;
+}
+
+float TLSFAllocator::fragmentation() const {
+	return _available ? 1.0f - float(largest_free_block()) / float(_available) : 0.0f;
+}
+
+}
@@ -0,0 +1,104 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_MEMORY_TLSFALLOCATOR_H
+#define YAVE_GRAPHICS_MEMORY_TLSFALLOCATOR_H
+
+#include <yave/yave.h>
+
+#include <y/core/Result.h>
+
+#include <array>
+#include <unordered_map>
+
+namespace yave {
+
+// Two level segregated fit allocator, only does offset bookkeeping.
+// Free blocks are binned by size in power of two ranges split in sl_count linear subranges,
+// allocations and frees run in constant time and free blocks are merged with their neighbours immediatly.
+class TLSFAllocator : NonCopyable {
+
+	static constexpr u32 null_index = u32(-1);
+
+	struct Block {
+		usize offset = 0;
+		usize size = 0;
+
+		u32 prev_phys = null_index;
+		u32 next_phys = null_index;
+
+		u32 prev_free = null_index;
+		u32 next_free = null_index;
+
+		bool is_free = false;
+	};
+
+	public:
+		static constexpr usize sl_bits = 4;
+		static constexpr usize sl_count = usize(1) << sl_bits;
+		static constexpr usize fl_count = 64 - sl_bits + 1;
+
+		TLSFAllocator(usize size, usize granularity);
+
+		// Sizes are rounded up to the granularity, alignment should be a power of two
+		core::Result<usize> alloc(usize size, usize alignment = 1);
+		void free(usize offset);
+
+		usize size() const;
+		usize granularity() const;
+
+		usize available() const;
+		usize allocations() const;
+		usize free_blocks() const;
+		usize largest_free_block() const;
+
+		// 0 when all free memory is contiguous, tends toward 1 as it gets split in small blocks
+		float fragmentation() const;
+
+	private:
+		std::pair<usize, usize> mapping(usize size) const;
+
+		u32 find_free(usize size) const;
+		void insert_free(u32 index);
+		void remove_free(u32 index);
+
+		u32 create_block();
+		u32 split(u32 index, usize size);
+		void merge_next(u32 index);
+
+		usize _size = 0;
+		usize _granularity = 0;
+		usize _available = 0;
+		usize _free_blocks = 0;
+
+		u64 _fl_bitmap = 0;
+		std::array<u32, fl_count> _sl_bitmaps = {};
+		std::array<std::array<u32, sl_count>, fl_count> _free_lists;
+
+		core::Vector<Block> _blocks;
+		core::Vector<u32> _unused_blocks;
+
+		std::unordered_map<usize, u32> _allocated;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_MEMORY_TLSFALLOCATOR_H
@@ -24,11 +24,102 @@ SOFTWARE.
 
 #include "Queue.h"
 
+#include <yave/graphics/swapchain/Swapchain.h>
+
 namespace yave {
 
-Queue::Queue(DevicePtr dptr, vk::Queue queue) :
+// Builds the vk::SubmitInfos of a single vkQueueSubmit without allocating
+struct Queue::SubmitInfos : NonMovable {
+	static constexpr usize max_submits = SubmitBatch::max_cmd_buffers + 1;
+	static constexpr usize max_semaphores = 32;
+
+	std::array<vk::SubmitInfo, max_submits> infos;
+	std::array<vk::CommandBuffer, max_submits> cmd_buffers;
+	std::array<CmdBufferData*, max_submits> datas;
+	usize count = 0;
+
+	std::array<vk::Semaphore, max_semaphores> semaphores;
+	std::array<vk::PipelineStageFlags, max_semaphores> stages;
+	usize semaphore_count = 0;
+
+	void add(const CmdBufferBase& base) {
+		if(count == max_submits) {
+			y_fatal("Too many command buffers in submission.");
+		}
+
+		CmdBufferData& data = base._proxy->data();
+		cmd_buffers[count] = data.vk_cmd_buffer();
+		datas[count] = &data;
+		infos[count] = vk::SubmitInfo()
+				.setCommandBufferCount(1)
+				.setPCommandBuffers(&cmd_buffers[count])
+			;
+		++count;
+
+		for(const Semaphore& semaphore : data._waits) {
+			wait(semaphore.vk_semaphore(), vk::PipelineStageFlagBits::eAllCommands);
+		}
+		if(data._signal.device()) {
+			signal(data._signal.vk_semaphore());
+		}
+	}
+
+	// waits and signals are added to the last command buffer
+	void wait(vk::Semaphore semaphore, vk::PipelineStageFlags stage) {
+		vk::SubmitInfo& info = last();
+		y_debug_assert(!info.signalSemaphoreCount);
+		if(!info.waitSemaphoreCount) {
+			info.setPWaitSemaphores(&semaphores[semaphore_count]);
+			info.setPWaitDstStageMask(&stages[semaphore_count]);
+		}
+		stages[semaphore_count] = stage;
+		push(semaphore);
+		++info.waitSemaphoreCount;
+	}
+
+	void signal(vk::Semaphore semaphore) {
+		vk::SubmitInfo& info = last();
+		if(!info.signalSemaphoreCount) {
+			info.setPSignalSemaphores(&semaphores[semaphore_count]);
+		}
+		push(semaphore);
+		++info.signalSemaphoreCount;
+	}
+
+	void submit(vk::Queue queue) {
+		if(!count) {
+			return;
+		}
+
+		// a submission can only signal one fence: the other command buffers are retired along with the last one
+		const CmdBufferData& last_data = *datas[count - 1];
+		for(usize i = 0; i + 1 < count; ++i) {
+			datas[i]->_batch_fence = last_data.vk_fence();
+			datas[i]->_batch_resource_fence = last_data.resource_fence();
+		}
+
+		queue.submit(vk::ArrayProxy<const vk::SubmitInfo>(u32(count), infos.data()), last_data.vk_fence());
+	}
+
+	private:
+		vk::SubmitInfo& last() {
+			y_debug_assert(count);
+			return infos[count - 1];
+		}
+
+		void push(vk::Semaphore semaphore) {
+			if(semaphore_count == max_semaphores) {
+				y_fatal("Too many semaphores in submission.");
+			}
+			semaphores[semaphore_count++] = semaphore;
+		}
+};
+
+
+Queue::Queue(DevicePtr dptr, u32 family_index, vk::Queue queue) :
 		DeviceLinked(dptr),
 		_queue(queue),
+		_family_index(family_index),
 		_lock(std::make_unique<std::mutex>()){
 }
 
@@ -43,6 +134,10 @@ vk::Queue Queue::vk_queue() const {
 	return _queue;
 }
 
+u32 Queue::family_index() const {
+	return _family_index;
+}
+
 void Queue::wait() const {
 	std::unique_lock lock(*_lock);
 	_queue.waitIdle();
@@ -55,29 +150,70 @@ Semaphore Queue::submit_sem(RecordedCmdBuffer&& cmd) const {
 	return sync;
 }
 
+void Queue::submit(SubmitBatch& batch) const {
+	std::unique_lock lock(*_lock);
+	auto uploads = take_uploads(batch_uploads(batch));
+
+	SubmitInfos infos;
+	if(uploads) {
+		infos.add(*uploads);
+	}
+	for(usize i = 0; i != batch.size(); ++i) {
+		infos.add(batch._cmd_buffers[i]);
+	}
+	infos.submit(_queue);
+
+	batch.clear();
+}
+
+void Queue::present(SubmitBatch& batch, Swapchain& swapchain, const FrameToken& token) const {
+	y_debug_assert(!batch.is_empty());
+
+	std::unique_lock lock(*_lock);
+	auto uploads = take_uploads(batch_uploads(batch));
+
+	SubmitInfos infos;
+	if(uploads) {
+		infos.add(*uploads);
+	}
+	for(usize i = 0; i != batch.size(); ++i) {
+		infos.add(batch._cmd_buffers[i]);
+	}
+	infos.wait(token.image_aquired, vk::PipelineStageFlagBits::eBottomOfPipe);
+	infos.signal(token.render_finished);
+	infos.submit(_queue);
+
+	swapchain.present(token, _queue);
+
+	batch.clear();
+}
+
 void Queue::submit_base(CmdBufferBase& base) const {
 	std::unique_lock lock(*_lock);
+	auto uploads = take_uploads(base.upload_dependency());
 
-	auto cmd = base.vk_cmd_buffer();
-
-	const auto& wait = base._proxy->data()._waits;
-	auto wait_semaphores = core::vector_with_capacity<vk::Semaphore>(wait.size());
-	std::transform(wait.begin(), wait.end(), std::back_inserter(wait_semaphores), [](const auto& s) { return s.vk_semaphore(); });
-	core::Vector<vk::PipelineStageFlags> stages(wait.size(), vk::PipelineStageFlagBits::eAllCommands);
-
-	const Semaphore& signal = base._proxy->data()._signal;
-	vk::Semaphore sig_semaphore = signal.device() ? signal.vk_semaphore() : vk::Semaphore();
-
-	_queue.submit(vk::SubmitInfo()
-			.setSignalSemaphoreCount(signal.device() ? 1 : 0)
-			.setPSignalSemaphores(signal.device() ? &sig_semaphore : nullptr)
-			.setWaitSemaphoreCount(wait_semaphores.size())
-			.setPWaitSemaphores(wait_semaphores.data())
-			.setPWaitDstStageMask(stages.data())
-			.setCommandBufferCount(1)
-			.setPCommandBuffers(&cmd),
-		base.vk_fence());
+	SubmitInfos infos;
+	if(uploads) {
+		infos.add(*uploads);
+	}
+	infos.add(base);
+	infos.submit(_queue);
 }
 
+std::optional<RecordedCmdBuffer> Queue::take_uploads(UploadFence required) const {
+	// uploads are recorded in command buffers from the graphic family
+	if(this != &device()->graphic_queue()) {
+		return std::nullopt;
+	}
+	return device()->staging_ring().take_batch(required);
 }
 
+UploadFence Queue::batch_uploads(const SubmitBatch& batch) {
+	UploadFence required;
+	for(usize i = 0; i != batch.size(); ++i) {
+		required = required.merged(batch._cmd_buffers[i].upload_dependency());
+	}
+	return required;
+}
+
+}
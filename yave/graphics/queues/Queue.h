@@ -26,11 +26,16 @@ SOFTWARE.
 
 #include "Semaphore.h"
 #include "submit.h"
+#include "SubmitBatch.h"
 
+#include <optional>
 #include <mutex>
 
 namespace yave {
 
+class Swapchain;
+struct FrameToken;
+
 class Queue : NonCopyable, public DeviceLinked {
 
 	public:
@@ -41,6 +46,7 @@ class Queue : NonCopyable, public DeviceLinked {
 		~Queue();
 
 		vk::Queue vk_queue() const;
+		u32 family_index() const;
 
 		void wait() const;
 
@@ -52,18 +58,27 @@ class Queue : NonCopyable, public DeviceLinked {
 			policy(cmd);
 		}
 
-		std::mutex& lock() const {
-			return *_lock;
-		}
+		// Submits every command buffer of the batch with a single vkQueueSubmit, the batch is empty afterward
+		void submit(SubmitBatch& batch) const;
+
+		// Submits the batch, its last command buffer waits for the swapchain image and signals its presentation
+		void present(SubmitBatch& batch, Swapchain& swapchain, const FrameToken& token) const;
 
 	private:
 		friend class QueueFamily;
 
-		Queue(DevicePtr dptr, vk::Queue queue);
+		struct SubmitInfos;
+
+		Queue(DevicePtr dptr, u32 family_index, vk::Queue queue);
 
 		void submit_base(CmdBufferBase& base) const;
 
+		// expects _lock to be held, the uploads need to be submitted before anything else
+		std::optional<RecordedCmdBuffer> take_uploads(UploadFence required) const;
+		static UploadFence batch_uploads(const SubmitBatch& batch);
+
 		vk::Queue _queue;
+		u32 _family_index = 0;
 		std::unique_ptr<std::mutex> _lock;
 
 };
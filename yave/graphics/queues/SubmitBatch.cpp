@@ -0,0 +1,59 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "SubmitBatch.h"
+
+namespace yave {
+
+SubmitBatch::~SubmitBatch() {
+	if(!is_empty()) {
+		y_fatal("SubmitBatch destroyed before being submitted.");
+	}
+}
+
+void SubmitBatch::add(RecordedCmdBuffer&& cmd) {
+	if(is_full()) {
+		y_fatal("SubmitBatch is full.");
+	}
+	_cmd_buffers[_size++] = std::move(cmd);
+}
+
+usize SubmitBatch::size() const {
+	return _size;
+}
+
+bool SubmitBatch::is_empty() const {
+	return !_size;
+}
+
+bool SubmitBatch::is_full() const {
+	return _size == _cmd_buffers.size();
+}
+
+void SubmitBatch::clear() {
+	for(usize i = 0; i != _size; ++i) {
+		_cmd_buffers[i] = RecordedCmdBuffer();
+	}
+	_size = 0;
+}
+
+}
@@ -64,7 +64,7 @@ ComputeProgram::ComputeProgram(const ComputeShader& comp, const SpecializationDa
 			.setPSpecializationInfo(&spec_info)
 		;
 
-	_pipeline = device()->vk_device().createComputePipeline(vk::PipelineCache(), vk::ComputePipelineCreateInfo()
+	_pipeline = device()->pipeline_cache().create_pipeline(vk::ComputePipelineCreateInfo()
 			.setLayout(_layout)
 			.setStage(stage)
 		);
@@ -0,0 +1,172 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "PipelineCache.h"
+
+#include <yave/device/Device.h>
+
+namespace yave {
+
+// https://www.khronos.org/registry/vulkan/specs/1.1/html/vkspec.html#pipelines-cache-header
+struct CacheHeader {
+	u32 header_size;
+	u32 header_version;
+	u32 vendor_id;
+	u32 device_id;
+	u8 uuid[VK_UUID_SIZE];
+};
+
+static bool is_compatible(const vk::PhysicalDeviceProperties& properties, core::ArrayView<u8> data) {
+	CacheHeader header = {};
+	if(data.size() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	return header.header_size >= sizeof(header) &&
+		   header.header_version == u32(VK_PIPELINE_CACHE_HEADER_VERSION_ONE) &&
+		   header.vendor_id == properties.vendorID &&
+		   header.device_id == properties.deviceID &&
+		   std::equal(std::begin(header.uuid), std::end(header.uuid), std::begin(properties.pipelineCacheUUID));
+}
+
+
+PipelineCache::PipelineCache(DevicePtr dptr) :
+		DeviceLinked(dptr),
+		_cache(dptr->vk_device().createPipelineCache(vk::PipelineCacheCreateInfo())) {
+}
+
+PipelineCache::~PipelineCache() {
+	if(device()) {
+		log_msg(fmt("Pipeline cache: % programs (% hits), % shader modules (% hits), % pipelines created in %ms",
+			_stats.program_misses, _stats.program_hits, _stats.module_misses, _stats.module_hits, _stats.pipelines, _stats.pipeline_time_ms));
+		device()->vk_device().destroyPipelineCache(_cache);
+	}
+}
+
+template<ShaderType Type>
+const ShaderModule<Type>& PipelineCache::module(ModuleMap<Type>& modules, const SpirVData& data) {
+	auto& bucket = modules[data.hash()];
+	for(const auto& entry : bucket) {
+		if(entry.spirv == data) {
+			++_stats.module_hits;
+			return *entry.module;
+		}
+	}
+
+	++_stats.module_misses;
+	bucket.emplace_back(ModuleEntry<Type>{data, std::make_unique<ShaderModule<Type>>(device(), data)});
+	return *bucket.last().module;
+}
+
+const ShaderProgram& PipelineCache::program(const SpirVData& frag, const SpirVData& vert, const SpirVData& geom) {
+	y_profile();
+
+	std::unique_lock lock(_lock);
+
+	const auto& frag_module = module(_frag_modules, frag);
+	const auto& vert_module = module(_vert_modules, vert);
+	const auto& geom_module = geom.is_empty() ? _empty_geom : module(_geom_modules, geom);
+
+	auto& cached = _programs[ProgramKey(&frag_module, &vert_module, &geom_module)];
+	if(cached) {
+		++_stats.program_hits;
+	} else {
+		++_stats.program_misses;
+		cached = std::make_unique<ShaderProgram>(frag_module, vert_module, geom_module);
+	}
+	return *cached;
+}
+
+vk::Pipeline PipelineCache::create_pipeline(const vk::GraphicsPipelineCreateInfo& create_info) {
+	y_profile();
+	core::Chrono chrono;
+	const vk::Pipeline pipeline = device()->vk_device().createGraphicsPipeline(_cache, create_info);
+	add_pipeline_time(chrono.elapsed());
+	return pipeline;
+}
+
+vk::Pipeline PipelineCache::create_pipeline(const vk::ComputePipelineCreateInfo& create_info) {
+	y_profile();
+	core::Chrono chrono;
+	const vk::Pipeline pipeline = device()->vk_device().createComputePipeline(_cache, create_info);
+	add_pipeline_time(chrono.elapsed());
+	return pipeline;
+}
+
+void PipelineCache::add_pipeline_time(const core::Duration& time) {
+	std::unique_lock lock(_lock);
+	++_stats.pipelines;
+	_stats.pipeline_time_ms += time.to_millis();
+}
+
+core::String PipelineCache::file_name() const {
+	const char* digits = "0123456789abcdef";
+	core::String name = "pipelines_";
+	for(u8 c : device()->physical_device().vk_properties().pipelineCacheUUID) {
+		const char hex[] = {digits[c >> 4], digits[c & 0x0F], 0};
+		name += hex;
+	}
+	return name + ".cache";
+}
+
+bool PipelineCache::load(io2::Reader& reader) {
+	y_profile();
+
+	core::Vector<u8> data;
+	if(!reader.read_all(data)) {
+		return false;
+	}
+
+	if(!is_compatible(device()->physical_device().vk_properties(), data)) {
+		log_msg("Pipeline cache was created by a different driver and has been discarded.", Log::Warning);
+		return false;
+	}
+
+	const vk::PipelineCache loaded = device()->vk_device().createPipelineCache(vk::PipelineCacheCreateInfo()
+			.setInitialDataSize(data.size())
+			.setPInitialData(data.data())
+		);
+	device()->vk_device().mergePipelineCaches(_cache, loaded);
+	device()->vk_device().destroyPipelineCache(loaded);
+
+	log_msg(fmt("Pipeline cache loaded (%KB)", data.size() / 1024));
+	return true;
+}
+
+bool PipelineCache::save(io2::Writer& writer) const {
+	y_profile();
+
+	const std::vector<u8> data = device()->vk_device().getPipelineCacheData(_cache);
+	return writer.write(data.data(), data.size()) && writer.flush();
+}
+
+PipelineCache::Stats PipelineCache::stats() const {
+	std::unique_lock lock(_lock);
+	return _stats;
+}
+
+vk::PipelineCache PipelineCache::vk_pipeline_cache() const {
+	return _cache;
+}
+
+}
@@ -0,0 +1,105 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_SHADERS_PIPELINECACHE_H
+#define YAVE_GRAPHICS_SHADERS_PIPELINECACHE_H
+
+#include "ShaderProgram.h"
+
+#include <y/core/Chrono.h>
+#include <y/core/String.h>
+
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <map>
+
+namespace yave {
+
+class PipelineCache : NonCopyable, public DeviceLinked {
+
+	// hashes only select the bucket, modules are matched against their full SPIR-V
+	template<ShaderType Type>
+	struct ModuleEntry {
+		SpirVData spirv;
+		std::unique_ptr<ShaderModule<Type>> module;
+	};
+
+	template<ShaderType Type>
+	using ModuleMap = std::unordered_map<u64, core::Vector<ModuleEntry<Type>>>;
+
+	// modules are unique per SPIR-V, so programs are identified by their modules
+	using ProgramKey = std::tuple<const ShaderModuleBase*, const ShaderModuleBase*, const ShaderModuleBase*>;
+
+	public:
+		struct Stats {
+			usize program_hits = 0;
+			usize program_misses = 0;
+			usize module_hits = 0;
+			usize module_misses = 0;
+
+			usize pipelines = 0;
+			double pipeline_time_ms = 0.0;
+		};
+
+		PipelineCache(DevicePtr dptr);
+		~PipelineCache();
+
+		// Programs (and their shader modules) are shared by every material using the same SPIR-V, and live as long as the device.
+		const ShaderProgram& program(const SpirVData& frag, const SpirVData& vert, const SpirVData& geom);
+
+		vk::Pipeline create_pipeline(const vk::GraphicsPipelineCreateInfo& create_info);
+		vk::Pipeline create_pipeline(const vk::ComputePipelineCreateInfo& create_info);
+
+		// Pipeline cache data is only valid for the driver that produced it, the file name contains the driver's cache UUID.
+		core::String file_name() const;
+
+		// Returns false if the data was not produced by this driver and device.
+		// Should not be called while pipelines are being created.
+		bool load(io2::Reader& reader);
+		bool save(io2::Writer& writer) const;
+
+		Stats stats() const;
+
+		vk::PipelineCache vk_pipeline_cache() const;
+
+	private:
+		template<ShaderType Type>
+		const ShaderModule<Type>& module(ModuleMap<Type>& modules, const SpirVData& data);
+
+		void add_pipeline_time(const core::Duration& time);
+
+		vk::PipelineCache _cache;
+
+		mutable std::mutex _lock;
+
+		ModuleMap<ShaderType::Fragment> _frag_modules;
+		ModuleMap<ShaderType::Vertex> _vert_modules;
+		ModuleMap<ShaderType::Geomery> _geom_modules;
+		std::map<ProgramKey, std::unique_ptr<ShaderProgram>> _programs;
+		GeometryShader _empty_geom;
+
+		Stats _stats;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_SHADERS_PIPELINECACHE_H
@@ -21,6 +21,8 @@ SOFTWARE.
 **********************************/
 #include "SpirVData.h"
 
+#include <string_view>
+
 namespace yave {
 
 
@@ -52,6 +54,18 @@ const u32* SpirVData::data() const {
 	return _data.begin();
 }
 
+u64 SpirVData::hash() const {
+	return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(_data.begin()), size()));
+}
+
+bool SpirVData::operator==(const SpirVData& other) const {
+	return _data.size() == other._data.size() && std::equal(_data.begin(), _data.end(), other._data.begin());
+}
+
+bool SpirVData::operator!=(const SpirVData& other) const {
+	return !operator==(other);
+}
+
 bool SpirVData::is_empty() const {
 	return _data.is_empty();
 }
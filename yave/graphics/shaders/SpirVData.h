@@ -37,6 +37,11 @@ class SpirVData {
 
 		const u32* data() const;
 
+		u64 hash() const;
+
+		bool operator==(const SpirVData& other) const;
+		bool operator!=(const SpirVData& other) const;
+
 		static SpirVData deserialized(io2::Reader& reader);
 
 	private:
@@ -21,7 +21,7 @@ SOFTWARE.
 **********************************/
 #include "MaterialCompiler.h"
 
-#include <yave/graphics/shaders/ShaderProgram.h>
+#include <yave/graphics/shaders/PipelineCache.h>
 #include <yave/meshes/Vertex.h>
 #include <yave/device/Device.h>
 
@@ -42,15 +42,9 @@ MaterialCompiler::MaterialCompiler(DevicePtr dptr) : DeviceLinked(dptr) {
 GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, const RenderPass& render_pass) const {
 	y_profile();
 	core::DebugTimer _("MaterialCompiler::compile", core::Duration::milliseconds(2));
-	Y_TODO(move program creation programs can be reused)
 
-	DevicePtr dptr = material->device();
 	const auto& mat_data = material->data();
-
-	FragmentShader frag = FragmentShader(dptr, mat_data._frag);
-	VertexShader vert = VertexShader(dptr, mat_data._vert);
-	GeometryShader geom = mat_data._geom.is_empty() ? GeometryShader() : GeometryShader(dptr, mat_data._geom);
-	ShaderProgram program(frag, vert, geom);
+	const ShaderProgram& program = device()->pipeline_cache().program(mat_data._frag, mat_data._vert, mat_data._geom);
 
 	core::Vector<vk::PipelineShaderStageCreateInfo> pipeline_shader_stages(program.vk_pipeline_stage_info());
 	if(render_pass.is_depth_only()) {
@@ -137,7 +131,7 @@ GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, cons
 			.setPDynamicStates(dynamics.begin())
 		;
 
-	auto pipeline = device()->vk_device().createGraphicsPipeline(vk::PipelineCache(), vk::GraphicsPipelineCreateInfo()
+	auto pipeline = device()->pipeline_cache().create_pipeline(vk::GraphicsPipelineCreateInfo()
 			.setStageCount(u32(pipeline_shader_stages.size()))
 			.setPStages(pipeline_shader_stages.begin())
 			.setPDynamicState(&dynamic_states)
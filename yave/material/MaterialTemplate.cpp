@@ -19,42 +19,214 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 **********************************/
+
+#include "MaterialTemplate.h"
 #include "Material.h"
 #include "MaterialCompiler.h"
 
 #include <yave/device/Device.h>
 
+#include <y/concurrent/concurrent.h>
+
 #include <mutex>
+#include <condition_variable>
+#include <deque>
 
 namespace yave {
 
+struct MaterialTemplate::Pipelines {
+	struct Entry {
+		RenderPass::Layout layout;
+		// null while the pipeline is being compiled
+		std::unique_ptr<GraphicPipeline> pipeline;
+		u64 last_used = 0;
+		// set once a thread has started compiling the pipeline, until then the job queued on the thread pool can be taken over
+		bool claimed = false;
+	};
+
+	// evicted pipelines are kept alive until every command buffer that might have been recorded with them has completed,
+	// as other threads may have just been handed a reference
+	struct Retired {
+		ResourceFence fence;
+		std::unique_ptr<GraphicPipeline> pipeline;
+	};
+
+	std::mutex lock;
+	std::condition_variable compiled;
+
+	core::Vector<Entry> entries;
+	std::deque<Retired> retired;
+
+	// number of jobs scheduled on the thread pool that haven't run yet
+	usize jobs = 0;
+	u64 uses = 0;
+
+	Entry* find(const RenderPass::Layout& layout) {
+		const auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry& e) { return e.layout == layout; });
+		return it == entries.end() ? nullptr : it;
+	}
+
+	const GraphicPipeline* use(Entry& entry) {
+		entry.last_used = ++uses;
+		return entry.pipeline.get();
+	}
+
+	// adds an empty entry that will be filled once the pipeline has been compiled
+	Entry& push_pending(const RenderPass::Layout& layout, LifetimeManager& lifetime) {
+		if(entries.size() >= max_compiled_pipelines) {
+			evict_least_recently_used(lifetime);
+		}
+		return entries.emplace_back(Entry{layout, nullptr, ++uses, false});
+	}
+
+	void evict_least_recently_used(LifetimeManager& lifetime) {
+		while(!retired.empty() && lifetime.is_complete(retired.front().fence)) {
+			retired.pop_front();
+		}
+
+		Entry* lru = nullptr;
+		for(Entry& entry : entries) {
+			if(entry.pipeline && (!lru || entry.last_used < lru->last_used)) {
+				lru = &entry;
+			}
+		}
+		if(!lru) {
+			return;
+		}
+
+		log_msg("Discarding graphic pipeline", Log::Warning);
+		retired.push_back(Retired{lifetime.last_fence(), std::move(lru->pipeline)});
+		entries.erase_unordered(lru);
+	}
+};
+
+
+MaterialTemplate::MaterialTemplate() {
+}
+
 MaterialTemplate::MaterialTemplate(DevicePtr dptr, MaterialTemplateData&& data) :
 		DeviceLinked(dptr),
+		_pipelines(std::make_unique<Pipelines>()),
 		_data(std::move(data)) {
 }
 
+MaterialTemplate::~MaterialTemplate() {
+	wait_for_pipelines();
+}
+
+// pipelines being compiled on the thread pool reference the template, so they have to be waited for before it can be moved
+MaterialTemplate::MaterialTemplate(MaterialTemplate&& other) {
+	*this = std::move(other);
+}
+
+MaterialTemplate& MaterialTemplate::operator=(MaterialTemplate&& other) {
+	wait_for_pipelines();
+	other.wait_for_pipelines();
+
+	DeviceLinked::operator=(std::move(other));
+	_pipelines = std::move(other._pipelines);
+	_data = std::move(other._data);
+	return *this;
+}
+
+void MaterialTemplate::wait_for_pipelines() const {
+	if(_pipelines) {
+		std::unique_lock lock(_pipelines->lock);
+		_pipelines->compiled.wait(lock, [this] { return !_pipelines->jobs; });
+	}
+}
+
+const GraphicPipeline& MaterialTemplate::store(const RenderPass::Layout& layout, GraphicPipeline&& pipeline) const {
+	std::unique_lock lock(_pipelines->lock);
+
+	Pipelines::Entry* entry = _pipelines->find(layout);
+	y_debug_assert(entry && !entry->pipeline);
+
+	entry->pipeline = std::make_unique<GraphicPipeline>(std::move(pipeline));
+	_pipelines->compiled.notify_all();
+
+	return *entry->pipeline;
+}
+
 const GraphicPipeline& MaterialTemplate::compile(const RenderPass& render_pass) const {
-	Y_TODO(make material compilation thread safe?)
 	if(!render_pass.vk_render_pass()) {
 		y_fatal("Unable to compile material: null renderpass.");
 	}
 
 	const auto& key = render_pass.layout();
-	auto it = _compiled.find(key);
-	if(it == _compiled.end()) {
-		if(_compiled.size() == max_compiled_pipelines) {
-			log_msg("Discarding graphic pipeline", Log::Warning);
-			std::move(_compiled.begin() + 1, _compiled.end(), _compiled.begin());
-			_compiled.pop();
+	{
+		std::unique_lock lock(_pipelines->lock);
+		Pipelines::Entry* entry = nullptr;
+		_pipelines->compiled.wait(lock, [&] {
+			entry = _pipelines->find(key);
+			return !entry || entry->pipeline || !entry->claimed;
+		});
+
+		if(entry && entry->pipeline) {
+			return *_pipelines->use(*entry);
+		}
+
+		// the job might still be queued behind the calling thread (if it is a pool worker), so it is compiled here instead
+		if(!entry) {
+			entry = &_pipelines->push_pending(key, device()->lifetime_manager());
 		}
+		entry->claimed = true;
+	}
+
+	MaterialCompiler compiler(device());
+	return store(key, compiler.compile(this, render_pass));
+}
 
-		MaterialCompiler compiler(device());
-		_compiled.insert(key, compiler.compile(this, render_pass));
-		return _compiled.last().second;
+const GraphicPipeline* MaterialTemplate::compile_async(const RenderPass& render_pass) const {
+	if(!render_pass.vk_render_pass()) {
+		y_fatal("Unable to compile material: null renderpass.");
+	}
+
+	const auto& key = render_pass.layout();
+	{
+		std::unique_lock lock(_pipelines->lock);
+		if(Pipelines::Entry* entry = _pipelines->find(key)) {
+			return _pipelines->use(*entry);
+		}
+		_pipelines->push_pending(key, device()->lifetime_manager());
+		++_pipelines->jobs;
 	}
-	return it->second;
+
+	// render passes are owned by their framebuffers which might not outlive the compilation,
+	// so the pipeline is compiled against a compatible render pass
+	concurrent::default_thread_pool().schedule([this, key] {
+		bool claimed = false;
+		{
+			std::unique_lock lock(_pipelines->lock);
+			Pipelines::Entry* entry = _pipelines->find(key);
+			if(entry && !entry->claimed) {
+				entry->claimed = claimed = true;
+			}
+		}
+
+		if(claimed) {
+			const RenderPass render_pass(device(), key);
+			MaterialCompiler compiler(device());
+			store(key, compiler.compile(this, render_pass));
+		}
+
+		std::unique_lock lock(_pipelines->lock);
+		--_pipelines->jobs;
+		_pipelines->compiled.notify_all();
+	});
+
+	return nullptr;
 }
 
+void MaterialTemplate::precompile(const RenderPass& render_pass) const {
+	compile_async(render_pass);
+}
+
+bool MaterialTemplate::is_compiled(const RenderPass& render_pass) const {
+	std::unique_lock lock(_pipelines->lock);
+	const Pipelines::Entry* entry = _pipelines->find(render_pass.layout());
+	return entry && entry->pipeline;
+}
 
 const MaterialTemplateData& MaterialTemplate::data() const {
 	return _data;
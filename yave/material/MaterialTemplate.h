@@ -27,7 +27,7 @@ SOFTWARE.
 #include <yave/graphics/framebuffer/RenderPass.h>
 #include <yave/graphics/bindings/DescriptorSet.h>
 
-#include <y/core/AssocVector.h>
+#include <memory>
 
 #include "GraphicPipeline.h"
 #include "MaterialTemplateData.h"
@@ -39,17 +39,35 @@ class MaterialTemplate final : NonCopyable, public DeviceLinked {
 	public:
 		static constexpr usize max_compiled_pipelines = 8;
 
-		MaterialTemplate() = default;
+		MaterialTemplate();
 		MaterialTemplate(DevicePtr dptr, MaterialTemplateData&& data);
 
+		// Waits for the pipelines being compiled on the thread pool
+		~MaterialTemplate();
+
+		MaterialTemplate(MaterialTemplate&&);
+		MaterialTemplate& operator=(MaterialTemplate&&);
+
+		// Thread safe: the pipeline is compiled on the calling thread, or waited for if another thread is already compiling it.
+		// Pipelines that are only queued on the thread pool are compiled on the calling thread.
 		const GraphicPipeline& compile(const RenderPass& render_pass) const;
 
+		// Returns nullptr and compiles the pipeline on the thread pool if it isn't ready yet
+		const GraphicPipeline* compile_async(const RenderPass& render_pass) const;
+
+		// Starts compiling the pipeline on the thread pool so that it is ready for its first use
+		void precompile(const RenderPass& render_pass) const;
+		bool is_compiled(const RenderPass& render_pass) const;
+
 		const MaterialTemplateData& data() const;
 
 	private:
-		//void swap(Material& other);
+		struct Pipelines;
+
+		const GraphicPipeline& store(const RenderPass::Layout& layout, GraphicPipeline&& pipeline) const;
+		void wait_for_pipelines() const;
 
-		mutable core::AssocVector<RenderPass::Layout, GraphicPipeline> _compiled;
+		std::unique_ptr<Pipelines> _pipelines;
 
 		MaterialTemplateData _data;
 };
@@ -39,7 +39,9 @@ serde2::Result SimpleMaterialData::deserialize(ReadableAssetArchive& arc) noexce
 		if(!arc(id)) {
 			return core::Err();
 		}
-		if(id != AssetId::invalid_id()) {
+		if(AssetPrefetch* prefetch = arc.prefetch()) {
+			arc.loader().prefetch<Texture>(id, *prefetch);
+		} else if(id != AssetId::invalid_id()) {
 			auto t = arc.loader().load<Texture>(id);
 			if(!t) {
 				return core::Err();
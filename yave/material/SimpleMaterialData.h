@@ -47,6 +47,8 @@ class SimpleMaterialData {
 
 		static constexpr usize texture_count = usize(Textures::Max);
 
+		static constexpr bool has_asset_dependencies = true;
+
 		SimpleMaterialData() = default;
 		SimpleMaterialData(std::array<AssetPtr<Texture>, texture_count>&& textures);
 
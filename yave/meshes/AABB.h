@@ -62,6 +62,53 @@ class AABB {
 			return _max;
 		}
 
+		float surface_area() const {
+			math::Vec3 ext = extent();
+			return 2.0f * (ext.x() * ext.y() + ext.y() * ext.z() + ext.z() * ext.x());
+		}
+
+		bool contains(const AABB& other) const {
+			for(usize i = 0; i != 3; ++i) {
+				if(other._min[i] < _min[i] || other._max[i] > _max[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool contains(const math::Vec3& pos) const {
+			for(usize i = 0; i != 3; ++i) {
+				if(pos[i] < _min[i] || pos[i] > _max[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		AABB merged(const AABB& other) const {
+			return AABB(_min.min(other._min), _max.max(other._max));
+		}
+
+		// smallest AABB containing this one once transformed
+		AABB transformed(const math::Matrix4<>& tr) const {
+			math::Vec3 c = center();
+			math::Vec3 h = half_extent();
+			math::Vec3 new_center(0.0f);
+			math::Vec3 new_half(0.0f);
+			for(usize i = 0; i != 3; ++i) {
+				new_center[i] = tr[3][i];
+				for(usize j = 0; j != 3; ++j) {
+					new_center[i] += tr[j][i] * c[j];
+					new_half[i] += std::abs(tr[j][i]) * h[j];
+				}
+			}
+			return AABB(new_center - new_half, new_center + new_half);
+		}
+
+		AABB expanded(float margin) const {
+			return AABB(_min - math::Vec3(margin), _max + math::Vec3(margin));
+		}
+
 	private:
 		math::Vec3 _min;
 		math::Vec3 _max;
@@ -0,0 +1,161 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "MeshAllocator.h"
+
+#include <yave/device/Device.h>
+
+#include <numeric>
+
+namespace yave {
+
+// the smallest element count whose byte size is a multiple of the sub-buffer alignment
+template<typename T>
+static usize granularity(DevicePtr dptr) {
+	const usize alignment = T::alignment(dptr);
+	return alignment / std::gcd(alignment, sizeof(typename T::value_type));
+}
+
+static usize round_up(usize size, usize granularity) {
+	return ((std::max(size, usize(1)) + granularity - 1) / granularity) * granularity;
+}
+
+
+// TLSF only looks for free blocks in size classes that are guaranteed to fit the request,
+// so a page needs some slack to always be able to hold an allocation of count elements
+static usize page_size(usize count, usize granularity) {
+	const usize size = round_up(count, granularity);
+	return round_up(size + size / TLSFAllocator::sl_count, granularity);
+}
+
+
+MeshAllocator::Page::Page(DevicePtr dptr, usize vertex_count, usize triangle_count, usize vertex_granularity, usize triangle_granularity) :
+		triangles(dptr, triangle_count),
+		vertices(dptr, vertex_count),
+		free_triangles(triangle_count, triangle_granularity),
+		free_vertices(vertex_count, vertex_granularity) {
+}
+
+
+MeshAllocator::MeshAllocator(DevicePtr dptr) : DeviceLinked(dptr) {
+}
+
+MeshAllocator::~MeshAllocator() {
+}
+
+MeshAllocator::Allocation MeshAllocator::alloc(usize vertex_count, usize triangle_count) {
+	y_profile();
+
+	std::unique_lock lock(_lock);
+	collect();
+
+	Allocation allocation;
+	for(u32 i = 0; i != _pages.size(); ++i) {
+		if(alloc_from_page(i, vertex_count, triangle_count, allocation)) {
+			return allocation;
+		}
+	}
+
+	usize page_vertices = min_page_vertex_count;
+	usize page_triangles = min_page_triangle_count;
+	if(!_pages.is_empty()) {
+		page_vertices = std::min(max_page_vertex_count, _pages.last()->free_vertices.size() * 2);
+		page_triangles = std::min(max_page_triangle_count, _pages.last()->free_triangles.size() * 2);
+	}
+	page_vertices = std::max(round_up(page_vertices, vertex_granularity()), page_size(vertex_count, vertex_granularity()));
+	page_triangles = std::max(round_up(page_triangles, triangle_granularity()), page_size(triangle_count, triangle_granularity()));
+	_pages.emplace_back(std::make_unique<Page>(device(), page_vertices, page_triangles, vertex_granularity(), triangle_granularity()));
+
+	if(!alloc_from_page(u32(_pages.size() - 1), vertex_count, triangle_count, allocation)) {
+		y_fatal("Unable to allocate mesh.");
+	}
+	return allocation;
+}
+
+void MeshAllocator::free(const Allocation& allocation) {
+	std::unique_lock lock(_lock);
+	_pending.emplace_back(device()->lifetime_manager().last_fence(), allocation);
+	collect();
+}
+
+TriangleSubBuffer MeshAllocator::triangle_buffer(u32 page) const {
+	std::unique_lock lock(_lock);
+	return TriangleSubBuffer(_pages[page]->triangles);
+}
+
+VertexSubBuffer MeshAllocator::vertex_buffer(u32 page) const {
+	std::unique_lock lock(_lock);
+	return VertexSubBuffer(_pages[page]->vertices);
+}
+
+usize MeshAllocator::page_count() const {
+	std::unique_lock lock(_lock);
+	return _pages.size();
+}
+
+void MeshAllocator::collect() {
+	const LifetimeManager& lifetime = device()->lifetime_manager();
+	for(usize i = 0; i < _pending.size();) {
+		const auto& [fence, allocation] = _pending[i];
+		if(!lifetime.is_complete(fence)) {
+			++i;
+			continue;
+		}
+
+		Page& page = *_pages[allocation.page];
+		page.free_triangles.free(allocation.triangles.offset());
+		page.free_vertices.free(allocation.vertices.offset());
+		_pending.erase_unordered(_pending.begin() + i);
+	}
+}
+
+bool MeshAllocator::alloc_from_page(u32 page_index, usize vertex_count, usize triangle_count, Allocation& allocation) {
+	Page& page = *_pages[page_index];
+
+	auto triangle_offset = page.free_triangles.alloc(triangle_count);
+	if(!triangle_offset) {
+		return false;
+	}
+
+	auto vertex_offset = page.free_vertices.alloc(vertex_count);
+	if(!vertex_offset) {
+		page.free_triangles.free(triangle_offset.unwrap());
+		return false;
+	}
+
+	allocation = Allocation {
+			page_index,
+			TriangleAllocation(page.triangles, triangle_count, triangle_offset.unwrap() * sizeof(IndexedTriangle)),
+			VertexAllocation(page.vertices, vertex_count, vertex_offset.unwrap() * sizeof(Vertex))
+		};
+	return true;
+}
+
+usize MeshAllocator::vertex_granularity() const {
+	return granularity<VertexAllocation>(device());
+}
+
+usize MeshAllocator::triangle_granularity() const {
+	return granularity<TriangleAllocation>(device());
+}
+
+}
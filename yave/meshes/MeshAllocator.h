@@ -0,0 +1,91 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_MESHES_MESHALLOCATOR_H
+#define YAVE_MESHES_MESHALLOCATOR_H
+
+#include <yave/graphics/buffers/buffers.h>
+#include <yave/graphics/memory/TLSFAllocator.h>
+#include <yave/device/LifetimeManager.h>
+
+#include <mutex>
+
+namespace yave {
+
+// Sub-allocates the vertices and triangles of static meshes from a few large buffers (pages)
+// so that meshes living in the same page can be drawn without rebinding buffers.
+// Pages start small and double in size (up to max_page_*_count) as more are needed.
+class MeshAllocator : NonMovable, public DeviceLinked {
+	public:
+		using TriangleAllocation = TriangleBuffer<>::sub_buffer_type;
+		using VertexAllocation = VertexBuffer<>::sub_buffer_type;
+
+		struct Allocation {
+			u32 page = 0;
+			TriangleAllocation triangles;
+			VertexAllocation vertices;
+		};
+
+		static constexpr usize min_page_vertex_count = 64 * 1024;
+		static constexpr usize min_page_triangle_count = 64 * 1024;
+		static constexpr usize max_page_vertex_count = 1024 * 1024;
+		static constexpr usize max_page_triangle_count = 1024 * 1024;
+
+		MeshAllocator(DevicePtr dptr);
+		~MeshAllocator();
+
+		Allocation alloc(usize vertex_count, usize triangle_count);
+
+		// the memory is only reused once the GPU is done with it
+		void free(const Allocation& allocation);
+
+		TriangleSubBuffer triangle_buffer(u32 page) const;
+		VertexSubBuffer vertex_buffer(u32 page) const;
+
+		usize page_count() const;
+
+	private:
+		struct Page : NonMovable {
+			Page(DevicePtr dptr, usize vertex_count, usize triangle_count, usize vertex_granularity, usize triangle_granularity);
+
+			TriangleBuffer<> triangles;
+			VertexBuffer<> vertices;
+
+			// offsets and sizes are in triangles and vertices
+			TLSFAllocator free_triangles;
+			TLSFAllocator free_vertices;
+		};
+
+		void collect();
+		bool alloc_from_page(u32 page_index, usize vertex_count, usize triangle_count, Allocation& allocation);
+
+		usize vertex_granularity() const;
+		usize triangle_granularity() const;
+
+		core::Vector<std::unique_ptr<Page>> _pages;
+		core::Vector<std::pair<ResourceFence, Allocation>> _pending;
+
+		mutable std::mutex _lock;
+};
+
+}
+
+#endif // YAVE_MESHES_MESHALLOCATOR_H
@@ -27,8 +27,10 @@ SOFTWARE.
 namespace yave {
 
 MeshData::MeshData(core::Vector<Vertex>&& vertices, core::Vector<IndexedTriangle>&& triangles, core::Vector<SkinWeights>&& skin, core::Vector<Bone>&& bones) :
-		_vertices(std::move(vertices)),
-		_triangles(std::move(triangles)) {
+		_vertices(vertices),
+		_triangles(triangles),
+		_vertex_storage(std::move(vertices)),
+		_triangle_storage(std::move(triangles)) {
 
 	if(bones.is_empty() != skin.is_empty()) {
 		y_fatal("Invalid skeleton.");
@@ -96,4 +98,12 @@ bool MeshData::has_skeleton() const {
 	return bool(_skeleton);
 }
 
+bool MeshData::is_compressed() const {
+	return _compressed;
+}
+
+void MeshData::set_compressed(bool compressed) {
+	_compressed = compressed;
+}
+
 }
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_MESHES_MESHDATA_H
 
 #include <yave/utils/serde.h>
+#include <y/serde2/compressed.h>
 
 #include "Skeleton.h"
 #include "AABB.h"
@@ -47,10 +48,36 @@ class MeshData {
 
 		bool has_skeleton() const;
 
-		y_serialize2(fs::magic_number, AssetType::Mesh, u32(7), _aabb, _vertices, _triangles,
+		// whether vertices and triangles are compressed when serialized (on by default)
+		bool is_compressed() const;
+		void set_compressed(bool compressed);
+
+		y_serialize2(fs::magic_number, AssetType::Mesh, u32(8), _aabb,
+					u64(_vertices.size()), serde2::compressed_array(_compressed, _vertices.size(), _vertices.data()),
+					u64(_triangles.size()), serde2::compressed_array(_compressed, _triangles.size(), _triangles.data()),
 					(_skeleton ? u32(1) : u32(0)), serde2::cond(!!_skeleton, [this] { return *_skeleton; }))
-		y_deserialize2(serde2::check(fs::magic_number, AssetType::Mesh, u32(7)), _aabb, _vertices, _triangles,
-					serde2::func([this](u32 s) { if(s) { _skeleton = std::make_unique<SkeletonData>(); } }), serde2::cond(!!_skeleton, [this]{ return *_skeleton; }))
+
+		// Version 7 predates compression and is read as is.
+		// When deserialized uncompressed from a mapped file, vertices and triangles are borrowed from it and the MeshData must not outlive the reader
+		template<typename Arc, typename = std::enable_if_t<serde2::is_readable_archive_v<Arc>>>
+		serde2::Result deserialize(Arc& arc) noexcept {
+			try {
+				u32 version = 0;
+				if(!arc(serde2::check(fs::magic_number, AssetType::Mesh), version) || (version != 7 && version != 8)) {
+					return core::Err();
+				}
+				const bool compressible = version == 8;
+				auto read_array = [&](auto& view, auto& storage) {
+					return compressible ? arc(serde2::compressed_array_view(view, storage)) : arc(serde2::array_view(view, storage));
+				};
+				if(!arc(_aabb) || !read_array(_vertices, _vertex_storage) || !read_array(_triangles, _triangle_storage)) {
+					return core::Err();
+				}
+				return arc(serde2::func([this](u32 s) { if(s) { _skeleton = std::make_unique<SkeletonData>(); } }), serde2::cond(!!_skeleton, [this]{ return *_skeleton; }));
+			} catch(...) {
+				return core::Err();
+			}
+		}
 
 	private:
 		struct SkeletonData {
@@ -62,10 +89,15 @@ class MeshData {
 
 		AABB _aabb;
 
-		core::Vector<Vertex> _vertices;
-		core::Vector<IndexedTriangle> _triangles;
+		core::Span<Vertex> _vertices;
+		core::Span<IndexedTriangle> _triangles;
+
+		core::Vector<Vertex> _vertex_storage;
+		core::Vector<IndexedTriangle> _triangle_storage;
 
 		std::unique_ptr<SkeletonData> _skeleton;
+
+		bool _compressed = true;
 };
 
 }
@@ -23,8 +23,6 @@ SOFTWARE.
 #include "SkinnedMesh.h"
 
 #include <yave/graphics/buffers/TypedWrapper.h>
-#include <yave/graphics/commands/CmdBufferRecorder.h>
-#include <yave/graphics/commands/RecordedCmdBuffer.h>
 #include <yave/device/Device.h>
 
 namespace yave {
@@ -36,10 +34,8 @@ SkinnedMesh::SkinnedMesh(DevicePtr dptr, const MeshData& mesh_data) :
 		_skeleton(mesh_data.bones()),
 		_radius(mesh_data.radius()) {
 
-	CmdBufferRecorder recorder(dptr->create_disposable_cmd_buffer());
-	Mapping::stage(_triangle_buffer, recorder, mesh_data.triangles().data());
-	Mapping::stage(_vertex_buffer, recorder, mesh_data.skinned_vertices().data());
-	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+	dptr->staging_ring().upload(_triangle_buffer, mesh_data.triangles().data());
+	_upload = dptr->staging_ring().upload(_vertex_buffer, mesh_data.skinned_vertices().data());
 }
 
 const TriangleBuffer<>& SkinnedMesh::triangle_buffer() const {
@@ -62,4 +58,13 @@ float SkinnedMesh::radius() const {
 	return _radius;
 }
 
+UploadFence SkinnedMesh::upload_fence() const {
+	return _upload;
+}
+
+bool SkinnedMesh::is_ready() const {
+	const DevicePtr dptr = _vertex_buffer.device();
+	return !dptr || dptr->staging_ring().is_ready(_upload);
+}
+
 }
@@ -26,6 +26,7 @@ SOFTWARE.
 #include "Skeleton.h"
 
 #include <yave/graphics/buffers/buffers.h>
+#include <yave/graphics/buffers/UploadFence.h>
 
 #include <yave/assets/AssetTraits.h>
 
@@ -46,6 +47,9 @@ class SkinnedMesh : NonCopyable {
 
 		float radius() const;
 
+		UploadFence upload_fence() const;
+		bool is_ready() const;
+
 	private:
 		TriangleBuffer<> _triangle_buffer;
 		SkinnedVertexBuffer<> _vertex_buffer;
@@ -54,6 +58,8 @@ class SkinnedMesh : NonCopyable {
 		Skeleton _skeleton;
 
 		float _radius;
+
+		UploadFence _upload;
 };
 
 YAVE_DECLARE_ASSET_TRAITS(SkinnedMesh, MeshData, AssetType::Mesh);
@@ -22,38 +22,81 @@ SOFTWARE.
 #include "StaticMesh.h"
 
 #include <yave/graphics/buffers/TypedWrapper.h>
-#include <yave/graphics/commands/CmdBufferRecorder.h>
-#include <yave/graphics/commands/RecordedCmdBuffer.h>
 #include <yave/device/Device.h>
 
 namespace yave {
 
 StaticMesh::StaticMesh(DevicePtr dptr, const MeshData& mesh_data) :
-		_triangle_buffer(dptr, mesh_data.triangles().size()),
-		_vertex_buffer(dptr, mesh_data.vertices().size()),
+		_allocation(dptr->mesh_allocator().alloc(mesh_data.vertices().size(), mesh_data.triangles().size())),
 		_indirect_data(mesh_data.triangles().size() * 3, 1),
-		_radius(mesh_data.radius()) {
+		_radius(mesh_data.radius()),
+		_aabb(mesh_data.aabb()) {
 
-	CmdBufferRecorder recorder(dptr->create_disposable_cmd_buffer());
-	Mapping::stage(_triangle_buffer, recorder, mesh_data.triangles().data());
-	Mapping::stage(_vertex_buffer, recorder, mesh_data.vertices().data());
-	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+	dptr->staging_ring().upload(_allocation.triangles, mesh_data.triangles().data());
+	_upload = dptr->staging_ring().upload(_allocation.vertices, mesh_data.vertices().data());
 }
 
-const TriangleBuffer<>& StaticMesh::triangle_buffer() const {
-	return _triangle_buffer;
+StaticMesh::~StaticMesh() {
+	if(DevicePtr dptr = _allocation.vertices.device()) {
+		dptr->mesh_allocator().free(_allocation);
+	}
 }
 
-const VertexBuffer<>& StaticMesh::vertex_buffer() const {
-	return _vertex_buffer;
+StaticMesh::StaticMesh(StaticMesh&& other) {
+	swap(other);
+}
+
+StaticMesh& StaticMesh::operator=(StaticMesh&& other) {
+	swap(other);
+	return *this;
+}
+
+void StaticMesh::swap(StaticMesh& other) {
+	std::swap(_allocation, other._allocation);
+	std::swap(_indirect_data, other._indirect_data);
+	std::swap(_radius, other._radius);
+	std::swap(_aabb, other._aabb);
+	std::swap(_upload, other._upload);
+}
+
+const MeshAllocator::TriangleAllocation& StaticMesh::triangle_buffer() const {
+	return _allocation.triangles;
+}
+
+const MeshAllocator::VertexAllocation& StaticMesh::vertex_buffer() const {
+	return _allocation.vertices;
 }
 
 const vk::DrawIndexedIndirectCommand& StaticMesh::indirect_data() const {
 	return _indirect_data;
 }
 
+u32 StaticMesh::pool_page() const {
+	return _allocation.page;
+}
+
+vk::DrawIndexedIndirectCommand StaticMesh::pool_indirect_data() const {
+	auto indirect = _indirect_data;
+	indirect.setFirstIndex(u32(_allocation.triangles.offset() * 3));
+	indirect.setVertexOffset(i32(_allocation.vertices.offset()));
+	return indirect;
+}
+
 float StaticMesh::radius() const {
 	return _radius;
 }
 
+const AABB& StaticMesh::aabb() const {
+	return _aabb;
+}
+
+UploadFence StaticMesh::upload_fence() const {
+	return _upload;
+}
+
+bool StaticMesh::is_ready() const {
+	const DevicePtr dptr = _allocation.vertices.device();
+	return !dptr || dptr->staging_ring().is_ready(_upload);
+}
+
 }
@@ -23,9 +23,9 @@ SOFTWARE.
 #define YAVE_MESHES_STATICMESH_H
 
 #include "MeshData.h"
+#include "MeshAllocator.h"
 
-#include <yave/graphics/buffers/buffers.h>
-#include <yave/graphics/buffers/TypedWrapper.h>
+#include <yave/graphics/buffers/UploadFence.h>
 
 #include <yave/assets/AssetTraits.h>
 
@@ -38,18 +38,36 @@ class StaticMesh : NonCopyable {
 
 		StaticMesh(DevicePtr dptr, const MeshData& mesh_data);
 
-		const TriangleBuffer<>& triangle_buffer() const;
-		const VertexBuffer<>& vertex_buffer() const;
+		~StaticMesh();
+
+		StaticMesh(StaticMesh&& other);
+		StaticMesh& operator=(StaticMesh&& other);
+
+		const MeshAllocator::TriangleAllocation& triangle_buffer() const;
+		const MeshAllocator::VertexAllocation& vertex_buffer() const;
 		const vk::DrawIndexedIndirectCommand& indirect_data() const;
 
+		// page of the MeshAllocator holding this mesh and draw command relative to the whole page buffers
+		u32 pool_page() const;
+		vk::DrawIndexedIndirectCommand pool_indirect_data() const;
+
 		float radius() const;
+		const AABB& aabb() const;
+
+		// the mesh can only be drawn once its data has been uploaded, or by command buffers that wait for it
+		UploadFence upload_fence() const;
+		bool is_ready() const;
 
 	private:
-		TriangleBuffer<> _triangle_buffer;
-		VertexBuffer<> _vertex_buffer;
+		void swap(StaticMesh& other);
+
+		MeshAllocator::Allocation _allocation;
 		vk::DrawIndexedIndirectCommand _indirect_data;
 
-		float _radius;
+		float _radius = 0.0f;
+		AABB _aabb;
+
+		UploadFence _upload;
 };
 
 YAVE_DECLARE_ASSET_TRAITS(StaticMesh, MeshData, AssetType::Mesh);
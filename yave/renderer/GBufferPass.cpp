@@ -46,9 +46,8 @@ GBufferPass GBufferPass::create(FrameGraph& framegraph, const SceneView& view, c
 	builder.add_depth_output(depth);
 	builder.add_color_output(color);
 	builder.add_color_output(normal);
-	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
-			auto render_pass = recorder.bind_framebuffer(self->framebuffer());
-			pass.scene_pass.render(render_pass, self);
+	builder.set_secondary_render_func([=](const FrameGraphPass* self) {
+			return pass.scene_pass.render_secondaries(self);
 		});
 
 	return pass;
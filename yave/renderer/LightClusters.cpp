@@ -0,0 +1,192 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "LightClusters.h"
+
+#include <y/concurrent/concurrent.h>
+
+#include <cmath>
+
+namespace yave {
+
+namespace {
+struct ClusterRange {
+	math::Vec3ui min;
+	math::Vec3ui max;
+
+	bool is_empty() const {
+		return max.x() < min.x() || max.y() < min.y() || max.z() < min.z();
+	}
+};
+}
+
+static ClusterRange empty_range() {
+	return ClusterRange{math::Vec3ui(1), math::Vec3ui(0)};
+}
+
+// closest depth at which anything gets shaded
+static constexpr float min_visible_depth = 1.0e-3f;
+
+static u32 tile_index(float ndc, u32 size, u32 grid) {
+	const float pixel = (ndc * 0.5f + 0.5f) * size;
+	if(pixel <= 0.0f) {
+		return 0;
+	}
+	if(pixel >= float(size)) {
+		return grid - 1;
+	}
+	return std::min(grid - 1, u32(pixel / LightClusters::tile_size));
+}
+
+// Conservative cluster bounds of a light: the projection of the view space AABB of the sphere
+static ClusterRange light_range(const math::Matrix4<>& view, const math::Matrix4<>& proj, const math::Vec2ui& size, const math::Vec3ui& grid, const uniform::Light& light) {
+	const math::Vec3 center = (view * math::Vec4(light.position, 1.0f)).to<3>();
+	const float radius = light.radius;
+	const float depth = -center.z();
+
+	if(depth + radius < min_visible_depth) {
+		return empty_range();
+	}
+
+	ClusterRange range;
+	range.min.z() = LightClusters::slice(depth - radius);
+	range.max.z() = LightClusters::slice(depth + radius);
+
+	// only the part of the sphere in front of the camera can light anything:
+	// clip its view space AABB before projecting it, so that lights straddling the camera plane don't cover the whole screen
+	const float near_depth = std::max(depth - radius, min_visible_depth);
+	const float far_depth = depth + radius;
+
+	math::Vec2 ndc_min(std::numeric_limits<float>::max());
+	math::Vec2 ndc_max(-std::numeric_limits<float>::max());
+	for(usize i = 0; i != 8; ++i) {
+		const math::Vec3 corner(center.x() + (i & 0x01 ? radius : -radius),
+								center.y() + (i & 0x02 ? radius : -radius),
+								i & 0x04 ? -far_depth : -near_depth);
+		const math::Vec4 clip = proj * math::Vec4(corner, 1.0f);
+		const math::Vec2 ndc = clip.to<2>() / clip.w();
+		for(usize k = 0; k != 2; ++k) {
+			ndc_min[k] = std::min(ndc_min[k], ndc[k]);
+			ndc_max[k] = std::max(ndc_max[k], ndc[k]);
+		}
+	}
+
+	for(usize k = 0; k != 2; ++k) {
+		if(ndc_max[k] < -1.0f || ndc_min[k] > 1.0f) {
+			return empty_range();
+		}
+		range.min[k] = tile_index(ndc_min[k], size[k], grid[k]);
+		range.max[k] = tile_index(ndc_max[k], size[k], grid[k]);
+	}
+
+	return range;
+}
+
+
+LightClusters::LightClusters(const math::Matrix4<>& view, const math::Matrix4<>& proj, const math::Vec2ui& size, core::Span<uniform::Light> point_lights) {
+	y_profile();
+
+	_grid_size = math::Vec3ui((size.x() + tile_size - 1) / tile_size,
+							  (size.y() + tile_size - 1) / tile_size,
+							  slice_count);
+	_grid_size.x() = std::max(_grid_size.x(), 1u);
+	_grid_size.y() = std::max(_grid_size.y(), 1u);
+
+	const usize light_count = point_lights.size();
+	const usize slice_cluster_count = _grid_size.x() * _grid_size.y();
+	_clusters = core::Vector<Cluster>(slice_cluster_count * slice_count, Cluster{});
+
+	core::Vector<ClusterRange> ranges(light_count, empty_range());
+	concurrent::parallel_for(usize(0), light_count, [&](usize i) {
+		ranges[i] = light_range(view, proj, size, _grid_size, point_lights[i]);
+	});
+
+	// Each slice is owned by a single task so counting and filling need no atomics
+	concurrent::parallel_for(u32(0), slice_count, [&](u32 z) {
+		Cluster* slice_clusters = _clusters.data() + z * slice_cluster_count;
+		for(const ClusterRange& range : ranges) {
+			if(range.is_empty() || z < range.min.z() || z > range.max.z()) {
+				continue;
+			}
+			for(u32 y = range.min.y(); y <= range.max.y(); ++y) {
+				for(u32 x = range.min.x(); x <= range.max.x(); ++x) {
+					++slice_clusters[y * _grid_size.x() + x].count;
+				}
+			}
+		}
+	});
+
+	u32 offset = 0;
+	for(Cluster& cluster : _clusters) {
+		cluster.offset = offset;
+		offset += cluster.count;
+		cluster.count = 0;
+	}
+
+	_light_indices = core::Vector<u32>(usize(offset), 0u);
+
+	concurrent::parallel_for(u32(0), slice_count, [&](u32 z) {
+		Cluster* slice_clusters = _clusters.data() + z * slice_cluster_count;
+		for(usize i = 0; i != light_count; ++i) {
+			const ClusterRange& range = ranges[i];
+			if(range.is_empty() || z < range.min.z() || z > range.max.z()) {
+				continue;
+			}
+			for(u32 y = range.min.y(); y <= range.max.y(); ++y) {
+				for(u32 x = range.min.x(); x <= range.max.x(); ++x) {
+					Cluster& cluster = slice_clusters[y * _grid_size.x() + x];
+					_light_indices[cluster.offset + cluster.count++] = u32(i);
+				}
+			}
+		}
+	});
+}
+
+const math::Vec3ui& LightClusters::grid_size() const {
+	return _grid_size;
+}
+
+core::Span<LightClusters::Cluster> LightClusters::clusters() const {
+	return _clusters;
+}
+
+core::Span<u32> LightClusters::light_indices() const {
+	return _light_indices;
+}
+
+usize LightClusters::cluster_index(u32 x, u32 y, u32 slice) const {
+	return (usize(slice) * _grid_size.y() + y) * _grid_size.x() + x;
+}
+
+u32 LightClusters::slice(float depth) {
+	if(depth <= min_depth) {
+		return 0;
+	}
+	const float s = std::floor(std::log2(depth / min_depth) * depth_scale());
+	return std::min(slice_count - 1, 1 + u32(s));
+}
+
+float LightClusters::depth_scale() {
+	return (slice_count - 2) / std::log2(max_depth / min_depth);
+}
+
+}
@@ -0,0 +1,74 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_LIGHTCLUSTERS_H
+#define YAVE_RENDERER_LIGHTCLUSTERS_H
+
+#include <yave/graphics/bindings/uniforms.h>
+
+#include <y/core/Vector.h>
+#include <y/core/Span.h>
+
+namespace yave {
+
+// Bins point lights into a froxel grid: screen tiles of tile_size pixels times
+// exponential view depth slices. Everything is computed on the CPU so it can be
+// checked against a brute force reference without a device.
+class LightClusters {
+	public:
+		static constexpr u32 tile_size = 64;
+		static constexpr u32 slice_count = 24;
+		static constexpr float min_depth = 0.5f;
+		static constexpr float max_depth = 500.0f;
+
+		struct Cluster {
+			u32 offset = 0;
+			u32 count = 0;
+		};
+
+		static_assert(sizeof(Cluster) == 2 * sizeof(u32));
+
+		LightClusters() = default;
+
+		// view and proj are the camera matrices, size is the viewport in pixels
+		LightClusters(const math::Matrix4<>& view, const math::Matrix4<>& proj, const math::Vec2ui& size, core::Span<uniform::Light> point_lights);
+
+		const math::Vec3ui& grid_size() const;
+
+		core::Span<Cluster> clusters() const;
+		core::Span<u32> light_indices() const;
+
+		usize cluster_index(u32 x, u32 y, u32 slice) const;
+
+		// depth is the distance along the camera forward axis
+		static u32 slice(float depth);
+		static float depth_scale();
+
+	private:
+		math::Vec3ui _grid_size;
+
+		core::Vector<Cluster> _clusters;
+		core::Vector<u32> _light_indices;
+};
+
+}
+
+#endif // YAVE_RENDERER_LIGHTCLUSTERS_H
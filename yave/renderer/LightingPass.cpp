@@ -21,6 +21,7 @@ SOFTWARE.
 **********************************/
 
 #include "LightingPass.h"
+#include "LightClusters.h"
 
 #include <yave/device/Device.h>
 #include <yave/framegraph/FrameGraph.h>
@@ -92,8 +93,6 @@ TextureView IBLData::brdf_lut() const  {
 }
 
 
-static constexpr usize max_light_count = 1024;
-
 LightingPass LightingPass::create(FrameGraph& framegraph, const GBufferPass& gbuffer, const std::shared_ptr<IBLData>& ibl_data) {
 	y_profile();
 
@@ -101,11 +100,46 @@ LightingPass LightingPass::create(FrameGraph& framegraph, const GBufferPass& gbu
 	math::Vec2ui size = framegraph.image_size(gbuffer.depth);
 
 	const SceneView& scene = gbuffer.scene_pass.scene_view;
+	const Camera& camera = scene.camera();
+
+	struct LightData {
+		core::Vector<uniform::Light> lights;
+		u32 point_count = 0;
+		LightClusters clusters;
+	};
+
+	auto light_data = std::make_shared<LightData>();
+	{
+		for(const auto& [t, l] : scene.world().view(PointLightArchetype()).components()) {
+			light_data->lights << uniform::Light{
+					t.position(),
+					l.radius(),
+					l.color() * l.intensity(),
+					uniform::Light::Type::Point
+				};
+		}
+		light_data->point_count = u32(light_data->lights.size());
+
+		light_data->clusters = LightClusters(camera.view_matrix(), camera.proj_matrix(), size,
+											 core::Span<uniform::Light>(light_data->lights.data(), light_data->point_count));
+
+		for(const auto& [l] : scene.world().view(DirectionalLightArchetype()).components()) {
+			light_data->lights << uniform::Light{
+					-l.direction().normalized(),
+					0.0f,
+					l.color() * l.intensity(),
+					uniform::Light::Type::Directional
+				};
+		}
+	}
 
 	FrameGraphPassBuilder builder = framegraph.add_pass("Lighting pass");
 
+	// Buffers are sized to fit this frame's lights, they can not be empty
 	auto lit = builder.declare_image(lighting_format, size);
-	auto light_buffer = builder.declare_typed_buffer<uniform::Light>(max_light_count);
+	auto light_buffer = builder.declare_typed_buffer<uniform::Light>(std::max(usize(1), light_data->lights.size()));
+	auto cluster_buffer = builder.declare_typed_buffer<LightClusters::Cluster>(light_data->clusters.clusters().size());
+	auto index_buffer = builder.declare_typed_buffer<u32>(std::max(usize(1), light_data->clusters.light_indices().size()));
 
 	LightingPass pass;
 	pass.lit = lit;
@@ -116,8 +150,12 @@ LightingPass LightingPass::create(FrameGraph& framegraph, const GBufferPass& gbu
 	builder.add_uniform_input(ibl_data->envmap(), 0, PipelineStage::ComputeBit);
 	builder.add_uniform_input(ibl_data->brdf_lut(), 0, PipelineStage::ComputeBit);
 	builder.add_storage_input(light_buffer, 0, PipelineStage::ComputeBit);
+	builder.add_storage_input(cluster_buffer, 0, PipelineStage::ComputeBit);
+	builder.add_storage_input(index_buffer, 0, PipelineStage::ComputeBit);
 	builder.add_storage_output(lit, 0, PipelineStage::ComputeBit);
 	builder.map_update(light_buffer);
+	builder.map_update(cluster_buffer);
+	builder.map_update(index_buffer);
 	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
 			struct CameraData {
 				math::Matrix4<> inv_matrix;
@@ -130,33 +168,33 @@ LightingPass LightingPass::create(FrameGraph& framegraph, const GBufferPass& gbu
 				CameraData camera;
 				u32 point_count = 0;
 				u32 directional_count = 0;
+				u32 cluster_tile_size = LightClusters::tile_size;
+				u32 cluster_slices = LightClusters::slice_count;
+				float cluster_min_depth = LightClusters::min_depth;
+				float cluster_depth_scale = LightClusters::depth_scale();
 			} push_data;
 
-			const Camera& camera = scene.camera();
+			static_assert(sizeof(PushData) <= 128);
+
 			push_data.camera.inv_matrix = camera.inverse_matrix();
 			push_data.camera.position = camera.position();
 			push_data.camera.forward = camera.forward();
+			push_data.point_count = light_data->point_count;
+			push_data.directional_count = u32(light_data->lights.size()) - light_data->point_count;
 
-
-			TypedMapping<uniform::Light> mapping = self->resources()->mapped_buffer(light_buffer);
 			{
-				for(const auto& [t, l] : scene.world().view(PointLightArchetype()).components()) {
-					mapping[push_data.point_count++] = uniform::Light{
-							t.position(),
-							l.radius(),
-							l.color() * l.intensity(),
-							uniform::Light::Type::Point
-						};
-				}
-
-				for(const auto& [l] : scene.world().view(DirectionalLightArchetype()).components()) {
-					mapping[push_data.point_count + push_data.directional_count++] = uniform::Light{
-							-l.direction().normalized(),
-							0.0f,
-							l.color() * l.intensity(),
-							uniform::Light::Type::Directional
-						};
-				}
+				TypedMapping<uniform::Light> mapping = self->resources()->mapped_buffer(light_buffer);
+				std::copy(light_data->lights.begin(), light_data->lights.end(), mapping.begin());
+			}
+			{
+				TypedMapping<LightClusters::Cluster> mapping = self->resources()->mapped_buffer(cluster_buffer);
+				const auto clusters = light_data->clusters.clusters();
+				std::copy(clusters.begin(), clusters.end(), mapping.begin());
+			}
+			{
+				TypedMapping<u32> mapping = self->resources()->mapped_buffer(index_buffer);
+				const auto indices = light_data->clusters.light_indices();
+				std::copy(indices.begin(), indices.end(), mapping.begin());
 			}
 
 			const auto& program = recorder.device()->device_resources()[DeviceResources::DeferredLightingProgram];
@@ -25,49 +25,236 @@ SOFTWARE.
 #include <yave/framegraph/FrameGraph.h>
 
 #include <yave/ecs/EntityWorld.h>
+#include <yave/scene/SceneBVH.h>
+#include <yave/meshes/MeshAllocator.h>
+#include <yave/device/Device.h>
 
 #include <yave/components/TransformableComponent.h>
 #include <yave/components/StaticMeshComponent.h>
 #include <yave/entities/entities.h>
 
+#include <y/concurrent/concurrent.h>
+
+#include <numeric>
+
 
 namespace yave {
 
 SceneRenderSubPass SceneRenderSubPass::create(FrameGraphPassBuilder& builder, const SceneView& view) {
 	auto camera_buffer = builder.declare_typed_buffer<Renderable::CameraData>();
 	auto transform_buffer = builder.declare_typed_buffer<math::Transform<>>(max_batch_size);
+	auto indirect_buffer = builder.declare_typed_buffer<vk::DrawIndexedIndirectCommand>(max_batch_size);
 
 	SceneRenderSubPass pass;
 	pass.scene_view = view;
 	pass.camera_buffer = camera_buffer;
 	pass.transform_buffer = transform_buffer;
+	pass.indirect_buffer = indirect_buffer;
 
 	builder.add_uniform_input(camera_buffer);
 	builder.add_attrib_input(transform_buffer);
+	builder.add_indirect_input(indirect_buffer);
 	builder.map_update(camera_buffer);
 	builder.map_update(transform_buffer);
+	builder.map_update(indirect_buffer);
 
 	return pass;
 }
 
-static usize render_world(const SceneRenderSubPass* sub_pass, RenderPassRecorder& recorder, const FrameGraphPass* pass, usize index = 0) {
+static bool is_visible(const Frustum& frustum, const TransformableComponent& tr, const StaticMeshComponent& me) {
+	if(!me.mesh() || !me.material()) {
+		return false;
+	}
+
+	const AABB& aabb = me.mesh()->aabb();
+	const math::Transform<>& transform = tr.transform();
+
+	float scale = 0.0f;
+	for(usize i = 0; i != 3; ++i) {
+		scale = std::max(scale, transform.column(i).to<3>().length());
+	}
+
+	math::Vec3 center = (transform * math::Vec4(aabb.center(), 1.0f)).to<3>();
+	return frustum.is_inside(center, aabb.radius() * scale);
+}
+
+// meshes and textures still being streamed in are skipped instead of making the frame wait on the transfer queue
+static bool is_ready(const StaticMeshComponent& me) {
+	return me.mesh()->is_ready() && me.material()->descriptor_set().is_ready();
+}
+
+// spreads pointer values over the given number of bits. collisions only make sorting less effective
+static u64 key_bits(const void* ptr, usize bits) {
+	return (u64(reinterpret_cast<uintptr_t>(ptr)) * 0x9e3779b97f4a7c15) >> (64 - bits);
+}
+
+static u64 sort_key(const StaticMeshComponent& me) {
+	const Material* material = me.material().get();
+	const StaticMesh* mesh = me.mesh().get();
+	return (key_bits(material->mat_template(), 20) << 44) |
+		   (key_bits(material, 20) << 24) |
+		   (u64(std::min(mesh->pool_page(), u32(63))) << 18) |
+			key_bits(mesh, 18);
+}
+
+// one indirect draw, for runs of draws sharing a material and a mesh allocator page
+struct DrawBatch {
+	const StaticMeshComponent* mesh;
+	usize first_command;
+	usize command_count;
+};
+
+static core::Vector<DrawBatch> prepare_world(const SceneRenderSubPass* sub_pass, const FrameGraphPass* pass, usize& index, SceneRenderStats& stats) {
 	y_profile();
 
+	using RenderEntity = std::pair<const TransformableComponent*, const StaticMeshComponent*>;
+
 	const ecs::EntityWorld& world = sub_pass->scene_view.world();
+	const Frustum frustum = sub_pass->scene_view.camera().frustum();
+
+	usize total = 0;
+	core::Vector<RenderEntity> visible;
+	if(sub_pass->scene_view.has_bvh()) {
+		const SceneBVH& bvh = sub_pass->scene_view.bvh();
+		total = bvh.size();
+		bvh.for_each_in_frustum(frustum, [&](ecs::EntityIndex index) {
+			ecs::EntityId id = world.id_from_index(index);
+			const TransformableComponent* tr = world.component<TransformableComponent>(id);
+			const StaticMeshComponent* me = world.component<StaticMeshComponent>(id);
+			if(tr && me && is_visible(frustum, *tr, *me)) {
+				visible.emplace_back(tr, me);
+			}
+		});
+	} else {
+		core::Vector<RenderEntity> entities;
+		for(const auto& [tr, me] : world.view(StaticMeshArchetype()).components()) {
+			entities.emplace_back(&tr, &me);
+		}
+		total = entities.size();
+
+		visible = concurrent::parallel_collect(entities.begin(), entities.end(), [&](const auto& range) {
+			core::Vector<RenderEntity> vis;
+			for(const RenderEntity& e : range) {
+				if(is_visible(frustum, *e.first, *e.second)) {
+					vis << e;
+				}
+			}
+			return vis;
+		});
+	}
+
+	{
+		core::Vector<RenderEntity> ready;
+		ready.set_min_capacity(visible.size());
+		std::copy_if(visible.begin(), visible.end(), std::back_inserter(ready), [](const RenderEntity& e) { return is_ready(*e.second); });
+		stats.pending_uploads = visible.size() - ready.size();
+		visible = std::move(ready);
+	}
+
+	struct DrawItem {
+		u64 key;
+		const TransformableComponent* transformable;
+		const StaticMeshComponent* mesh;
+	};
+
+	core::Vector<DrawItem> draws(visible.size(), DrawItem{});
+	concurrent::parallel_for(usize(0), visible.size(), [&](usize i) {
+		const auto& [tr, me] = visible[i];
+		draws[i] = DrawItem{sort_key(*me), tr, me};
+	});
+
+	concurrent::parallel_radix_sort(draws.begin(), draws.end(), [](const DrawItem& d) { return d.key; });
+
+	// every draw takes one transform and at most one indirect command, anything past the buffers is dropped and reported
+	y_debug_assert(index <= SceneRenderSubPass::max_batch_size);
+	const usize draw_count = std::min(draws.size(), SceneRenderSubPass::max_batch_size - index);
+	stats.dropped_meshes = draws.size() - draw_count;
 
 	auto transform_mapping = pass->resources()->mapped_buffer(sub_pass->transform_buffer);
+	auto indirect_mapping = pass->resources()->mapped_buffer(sub_pass->indirect_buffer);
+
+	// runs with the same mesh and material become one instanced indirect command
+	// and runs sharing a material and a mesh allocator page are submitted with a single indirect draw
+	core::Vector<DrawBatch> batches;
+	usize command_count = 0;
+	for(usize i = 0; i != draw_count;) {
+		const StaticMeshComponent& me = *draws[i].mesh;
+		const Material* material = me.material().get();
+		const u32 page = me.mesh()->pool_page();
+
+		auto same_bucket = [&](const DrawItem& d) {
+			return d.mesh->material().get() == material && d.mesh->mesh()->pool_page() == page;
+		};
+
+		const usize first_command = command_count;
+		while(i != draw_count && same_bucket(draws[i])) {
+			const StaticMesh* mesh = draws[i].mesh->mesh().get();
+			const usize first_instance = index;
+			for(; i != draw_count && same_bucket(draws[i]) && draws[i].mesh->mesh().get() == mesh; ++i) {
+				transform_mapping[index++] = draws[i].transformable->transform();
+			}
+
+			auto command = mesh->pool_indirect_data();
+			command.setFirstInstance(u32(first_instance));
+			command.setInstanceCount(u32(index - first_instance));
+			indirect_mapping[command_count++] = command;
+		}
+
+		batches << DrawBatch{&me, first_command, command_count - first_command};
+	}
+
+	y_debug_assert(index <= SceneRenderSubPass::max_batch_size);
+	y_debug_assert(command_count <= SceneRenderSubPass::max_batch_size);
+
+	stats.visible_meshes = draw_count;
+	stats.culled_meshes = total - visible.size() - stats.pending_uploads;
+	stats.draw_calls = batches.size();
+
+	return batches;
+}
+
+// returns the number of batches skipped because their pipeline is still being compiled
+static usize record_batches(const SceneRenderSubPass* sub_pass, RenderPassRecorder& recorder, const FrameGraphPass* pass, core::Span<DrawBatch> batches) {
+	y_profile();
+
+	const bool async_pipelines = sub_pass->scene_view.async_pipeline_compilation();
+	const RenderPass& render_pass = pass->framebuffer().render_pass();
+
 	auto transforms = pass->resources()->buffer<BufferUsage::AttributeBit>(sub_pass->transform_buffer);
+	auto indirect_buffer = pass->resources()->buffer<BufferUsage::IndirectBit>(sub_pass->indirect_buffer);
 	const auto& descriptor_set = pass->descriptor_sets()[0];
+	const MeshAllocator& mesh_allocator = recorder.device()->mesh_allocator();
 
 	recorder.bind_attrib_buffers({transforms, transforms});
 
-	for(const auto& [tr, me] : world.view(StaticMeshArchetype()).components()) {
-		transform_mapping[index] = tr.transform();
-		me.render(recorder, Renderable::SceneData{descriptor_set, u32(index)});
-		++index;
+	usize skipped = 0;
+	const Material* bound_material = nullptr;
+	const Material* pending_material = nullptr;
+	u32 bound_page = u32(-1);
+	for(const DrawBatch& batch : batches) {
+		const Material* material = batch.mesh->material().get();
+		const u32 page = batch.mesh->mesh()->pool_page();
+		if(material == pending_material) {
+			++skipped;
+			continue;
+		}
+		if(material != bound_material) {
+			if(async_pipelines && !material->mat_template()->compile_async(render_pass)) {
+				pending_material = material;
+				++skipped;
+				continue;
+			}
+			batch.mesh->bind_material(recorder, descriptor_set);
+			bound_material = material;
+		}
+		if(page != bound_page) {
+			recorder.bind_buffers(TriangleSubBuffer(mesh_allocator.triangle_buffer(page)), {VertexSubBuffer(mesh_allocator.vertex_buffer(page))});
+			bound_page = page;
+		}
+		recorder.draw_indirect(indirect_buffer, batch.first_command, batch.command_count);
 	}
 
-	return index;
+	return skipped;
 }
 
 void SceneRenderSubPass::render(RenderPassRecorder& recorder, const FrameGraphPass* pass) const {
@@ -79,8 +266,60 @@ void SceneRenderSubPass::render(RenderPassRecorder& recorder, const FrameGraphPa
 
 	usize index = 0;
 	if(scene_view.has_world()) {
-		index = render_world(this, recorder, pass, index);
+		SceneRenderStats stats;
+		const auto batches = prepare_world(this, pass, index, stats);
+		stats.pending_pipelines = record_batches(this, recorder, pass, batches);
+		scene_view.publish_stats(stats);
 	}
 }
 
+core::Vector<RecordedSecondaryCmdBuffer> SceneRenderSubPass::render_secondaries(const FrameGraphPass* pass) const {
+	y_profile();
+
+	// fill render data
+	auto camera_mapping = pass->resources()->mapped_buffer(camera_buffer);
+	camera_mapping[0] = scene_view.camera().viewproj_matrix();
+
+	usize index = 0;
+	SceneRenderStats stats;
+	core::Vector<DrawBatch> batches;
+	if(scene_view.has_world()) {
+		batches = prepare_world(this, pass, index, stats);
+	}
+
+	const Framebuffer& framebuffer = pass->framebuffer();
+
+	// pipelines are compiled before recording so that recording threads never wait on each other
+	if(!scene_view.async_pipeline_compilation()) {
+		for(const DrawBatch& batch : batches) {
+			batch.mesh->material()->mat_template()->compile(framebuffer.render_pass());
+		}
+	}
+
+	const usize chunk_count = std::clamp(batches.size() / min_secondary_batches, usize(1), concurrent::default_thread_pool().concurency());
+
+	core::Vector<RecordedSecondaryCmdBuffer> secondaries;
+	for(usize i = 0; i != chunk_count; ++i) {
+		secondaries.emplace_back();
+	}
+
+	// every thread records in a buffer from its own pool, they are executed in order by the primary buffer
+	core::Vector<usize> skipped(chunk_count, usize(0));
+	concurrent::parallel_for(usize(0), chunk_count, [&](usize chunk) {
+		const usize begin = chunk * batches.size() / chunk_count;
+		const usize end = (chunk + 1) * batches.size() / chunk_count;
+
+		SecondaryCmdBufferRecorder recorder(pass->resources()->device()->create_secondary_cmd_buffer(), framebuffer);
+		skipped[chunk] = record_batches(this, recorder.render_pass(), pass, core::Span<DrawBatch>(batches.data() + begin, end - begin));
+		secondaries[chunk] = RecordedSecondaryCmdBuffer(std::move(recorder));
+	});
+
+	if(scene_view.has_world()) {
+		stats.pending_pipelines = std::accumulate(skipped.begin(), skipped.end(), usize(0));
+		scene_view.publish_stats(stats);
+	}
+
+	return secondaries;
+}
+
 }
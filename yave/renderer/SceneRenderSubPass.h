@@ -30,19 +30,27 @@ SOFTWARE.
 namespace yave {
 
 class RenderPassRecorder;
+class RecordedSecondaryCmdBuffer;
 class FrameGraphPassBuilder;
 
 struct SceneRenderSubPass {
 	static constexpr usize max_batch_size = 128 * 1024;
 
+	// fewer draws aren't worth recording on another thread
+	static constexpr usize min_secondary_batches = 64;
+
 	SceneView scene_view;
 
 	FrameGraphMutableTypedBufferId<Renderable::CameraData> camera_buffer;
 	FrameGraphMutableTypedBufferId<math::Transform<>> transform_buffer;
+	FrameGraphMutableTypedBufferId<vk::DrawIndexedIndirectCommand> indirect_buffer;
 
 	static SceneRenderSubPass create(FrameGraphPassBuilder& builder, const SceneView& view);
 	void render(RenderPassRecorder& recorder, const FrameGraphPass* pass) const;
 
+	// Records the draws in as many secondary buffers as there are threads available
+	core::Vector<RecordedSecondaryCmdBuffer> render_secondaries(const FrameGraphPass* pass) const;
+
 };
 
 
@@ -0,0 +1,426 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "AABBTree.h"
+
+#include <y/concurrent/concurrent.h>
+
+namespace yave {
+
+static usize split_items(u32* order, usize count, const math::Vec3* centers) {
+	y_debug_assert(count > 1);
+
+	math::Vec3 min(std::numeric_limits<float>::max());
+	math::Vec3 max(-std::numeric_limits<float>::max());
+	for(usize i = 0; i != count; ++i) {
+		const math::Vec3& center = centers[order[i]];
+		min = min.min(center);
+		max = max.max(center);
+	}
+
+	math::Vec3 ext = max - min;
+	usize axis = 0;
+	for(usize i = 1; i != 3; ++i) {
+		if(ext[i] > ext[axis]) {
+			axis = i;
+		}
+	}
+
+	usize half = count / 2;
+	std::nth_element(order, order + half, order + count, [&](u32 a, u32 b) {
+		return centers[a][axis] < centers[b][axis];
+	});
+	return half;
+}
+
+
+AABBTree::AABBTree(float margin) : _margin(margin) {
+}
+
+AABBTree::NodeId AABBTree::insert(const AABB& aabb, u32 data) {
+	NodeId leaf = alloc_node();
+	Node& node = _nodes[leaf];
+	node.aabb = aabb.expanded(_margin);
+	node.data = data;
+	node.height = 0;
+
+	insert_leaf(leaf);
+	++_leaf_count;
+
+	return leaf;
+}
+
+void AABBTree::remove(NodeId node) {
+	y_debug_assert(node < _nodes.size() && _nodes[node].is_leaf());
+
+	remove_leaf(node);
+	free_node(node);
+	--_leaf_count;
+}
+
+bool AABBTree::update(NodeId node, const AABB& aabb) {
+	y_debug_assert(node < _nodes.size() && _nodes[node].is_leaf());
+
+	if(_nodes[node].aabb.contains(aabb)) {
+		return false;
+	}
+
+	remove_leaf(node);
+	_nodes[node].aabb = aabb.expanded(_margin);
+	insert_leaf(node);
+
+	return true;
+}
+
+core::Vector<AABBTree::NodeId> AABBTree::build(core::Span<Item> items) {
+	y_profile();
+
+	clear();
+
+	const usize count = items.size();
+	if(!count) {
+		return {};
+	}
+
+	// a full binary tree with n leaves always has 2n - 1 nodes:
+	// every subtree gets a contiguous range of nodes which makes it possible to build them independently
+	_nodes = core::Vector<Node>(2 * count - 1, Node());
+	_leaf_count = count;
+	_root = 0;
+
+	auto order = core::vector_with_capacity<u32>(count);
+	auto centers = core::vector_with_capacity<math::Vec3>(count);
+	for(usize i = 0; i != count; ++i) {
+		order << u32(i);
+		centers << items[i].aabb.center();
+	}
+	core::Vector<NodeId> leaves(count, invalid_node);
+
+	struct BuildTask {
+		usize first;
+		usize count;
+		NodeId offset;
+		NodeId parent;
+	};
+
+	const usize task_size = std::max(usize(1024), count / (concurrent::default_thread_pool().concurency() * 4));
+
+	// split the top of the tree until subtrees are small enough
+	core::Vector<BuildTask> tasks;
+	core::Vector<NodeId> top_nodes;
+	core::Vector<BuildTask> to_split = {BuildTask{0, count, 0, invalid_node}};
+	while(!to_split.is_empty()) {
+		BuildTask task = to_split.pop();
+		if(task.count <= task_size) {
+			tasks << task;
+			continue;
+		}
+
+		usize left = split_items(order.data() + task.first, task.count, centers.data());
+		Node& node = _nodes[task.offset];
+		node.parent = task.parent;
+		node.left = task.offset + 1;
+		node.right = NodeId(task.offset + 2 * left);
+		top_nodes << task.offset;
+
+		to_split << BuildTask{task.first + left, task.count - left, node.right, task.offset};
+		to_split << BuildTask{task.first, left, node.left, task.offset};
+	}
+
+	concurrent::parallel_for_each(tasks.begin(), tasks.end(), [&](const BuildTask& task) {
+		build_node(order.data() + task.first, task.count, items, centers.data(), task.offset, task.parent, leaves.data());
+	});
+
+	// top nodes are in pre-order, so children are always fitted before their parents
+	for(auto it = top_nodes.end(); it != top_nodes.begin();) {
+		fit_node(*(--it));
+	}
+
+	return leaves;
+}
+
+void AABBTree::build_node(u32* order, usize count, core::Span<Item> items, const math::Vec3* centers, NodeId offset, NodeId parent, NodeId* leaves) {
+	Node& node = _nodes[offset];
+	node.parent = parent;
+
+	if(count == 1) {
+		const Item& item = items[order[0]];
+		node.aabb = item.aabb.expanded(_margin);
+		node.data = item.data;
+		node.height = 0;
+		leaves[order[0]] = offset;
+		return;
+	}
+
+	usize left = split_items(order, count, centers);
+	node.left = offset + 1;
+	node.right = NodeId(offset + 2 * left);
+
+	build_node(order, left, items, centers, node.left, offset, leaves);
+	build_node(order + left, count - left, items, centers, node.right, offset, leaves);
+
+	fit_node(offset);
+}
+
+void AABBTree::clear() {
+	_nodes.clear();
+	_root = invalid_node;
+	_free = invalid_node;
+	_leaf_count = 0;
+}
+
+u32 AABBTree::data(NodeId node) const {
+	y_debug_assert(node < _nodes.size() && _nodes[node].is_leaf());
+	return _nodes[node].data;
+}
+
+const AABB& AABBTree::fat_aabb(NodeId node) const {
+	y_debug_assert(node < _nodes.size());
+	return _nodes[node].aabb;
+}
+
+usize AABBTree::size() const {
+	return _leaf_count;
+}
+
+usize AABBTree::height() const {
+	return _root == invalid_node ? 0 : usize(_nodes[_root].height);
+}
+
+bool AABBTree::is_empty() const {
+	return _root == invalid_node;
+}
+
+
+AABBTree::NodeId AABBTree::alloc_node() {
+	if(_free == invalid_node) {
+		_nodes.emplace_back();
+		return NodeId(_nodes.size() - 1);
+	}
+
+	NodeId node = _free;
+	_free = _nodes[node].parent;
+	_nodes[node] = Node();
+	return node;
+}
+
+void AABBTree::free_node(NodeId node) {
+	_nodes[node] = Node();
+	_nodes[node].parent = _free;
+	_free = node;
+}
+
+void AABBTree::fit_node(NodeId index) {
+	Node& node = _nodes[index];
+	const Node& left = _nodes[node.left];
+	const Node& right = _nodes[node.right];
+	node.aabb = left.aabb.merged(right.aabb);
+	node.height = 1 + std::max(left.height, right.height);
+}
+
+void AABBTree::insert_leaf(NodeId leaf) {
+	if(_root == invalid_node) {
+		_root = leaf;
+		_nodes[leaf].parent = invalid_node;
+		return;
+	}
+
+	// find the best sibling using the surface area heuristic
+	const AABB leaf_aabb = _nodes[leaf].aabb;
+	NodeId index = _root;
+	while(!_nodes[index].is_leaf()) {
+		const Node& node = _nodes[index];
+
+		float area = node.aabb.surface_area();
+		float combined_area = node.aabb.merged(leaf_aabb).surface_area();
+
+		// cost of creating a new parent for this node and the new leaf
+		float cost = 2.0f * combined_area;
+		// minimum cost of pushing the leaf further down the tree
+		float inheritance_cost = 2.0f * (combined_area - area);
+
+		auto descend_cost = [&](NodeId child_index) {
+			const Node& child = _nodes[child_index];
+			float merged_area = child.aabb.merged(leaf_aabb).surface_area();
+			return inheritance_cost + (child.is_leaf() ? merged_area : merged_area - child.aabb.surface_area());
+		};
+
+		float left_cost = descend_cost(node.left);
+		float right_cost = descend_cost(node.right);
+
+		if(cost < left_cost && cost < right_cost) {
+			break;
+		}
+		index = left_cost < right_cost ? node.left : node.right;
+	}
+
+	const NodeId sibling = index;
+	const NodeId old_parent = _nodes[sibling].parent;
+	const NodeId new_parent = alloc_node();
+	{
+		Node& parent = _nodes[new_parent];
+		parent.parent = old_parent;
+		parent.aabb = leaf_aabb.merged(_nodes[sibling].aabb);
+		parent.height = _nodes[sibling].height + 1;
+		parent.left = sibling;
+		parent.right = leaf;
+	}
+
+	if(old_parent != invalid_node) {
+		Node& parent = _nodes[old_parent];
+		(parent.left == sibling ? parent.left : parent.right) = new_parent;
+	} else {
+		_root = new_parent;
+	}
+	_nodes[sibling].parent = new_parent;
+	_nodes[leaf].parent = new_parent;
+
+	for(index = _nodes[leaf].parent; index != invalid_node; index = _nodes[index].parent) {
+		index = balance(index);
+		fit_node(index);
+	}
+}
+
+void AABBTree::remove_leaf(NodeId leaf) {
+	if(leaf == _root) {
+		_root = invalid_node;
+		return;
+	}
+
+	const NodeId parent = _nodes[leaf].parent;
+	const NodeId grand_parent = _nodes[parent].parent;
+	const NodeId sibling = _nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left;
+
+	if(grand_parent != invalid_node) {
+		Node& grand = _nodes[grand_parent];
+		(grand.left == parent ? grand.left : grand.right) = sibling;
+		_nodes[sibling].parent = grand_parent;
+		free_node(parent);
+
+		for(NodeId index = grand_parent; index != invalid_node; index = _nodes[index].parent) {
+			index = balance(index);
+			fit_node(index);
+		}
+	} else {
+		_root = sibling;
+		_nodes[sibling].parent = invalid_node;
+		free_node(parent);
+	}
+
+	_nodes[leaf].parent = invalid_node;
+}
+
+// performs a left or right rotation if node a is imbalanced, returns the new root of the subtree
+AABBTree::NodeId AABBTree::balance(NodeId ia) {
+	Node& a = _nodes[ia];
+	if(a.is_leaf() || a.height < 2) {
+		return ia;
+	}
+
+	const NodeId ib = a.left;
+	const NodeId ic = a.right;
+	const i32 diff = _nodes[ic].height - _nodes[ib].height;
+
+	// rotates child x up in place of a
+	auto rotate_up = [&](NodeId ix) {
+		Node& x = _nodes[ix];
+		const NodeId i1 = x.left;
+		const NodeId i2 = x.right;
+
+		x.left = ia;
+		x.parent = a.parent;
+		a.parent = ix;
+
+		if(x.parent != invalid_node) {
+			Node& p = _nodes[x.parent];
+			(p.left == ia ? p.left : p.right) = ix;
+		} else {
+			_root = ix;
+		}
+
+		// the highest grandchild goes up with x, the other one replaces x under a
+		const bool keep_first = _nodes[i1].height > _nodes[i2].height;
+		const NodeId up = keep_first ? i1 : i2;
+		const NodeId down = keep_first ? i2 : i1;
+
+		x.right = up;
+		(a.left == ix ? a.left : a.right) = down;
+		_nodes[down].parent = ia;
+
+		fit_node(ia);
+		fit_node(ix);
+
+		return ix;
+	};
+
+	if(diff > 1) {
+		return rotate_up(ic);
+	}
+	if(diff < -1) {
+		return rotate_up(ib);
+	}
+	return ia;
+}
+
+
+bool AABBTree::intersects(const Frustum& frustum, const AABB& aabb) {
+	for(const Plane& plane : frustum) {
+		// test the corner that is the furthest along the plane normal
+		math::Vec3 p(plane.x() >= 0.0f ? aabb.max().x() : aabb.min().x(),
+					 plane.y() >= 0.0f ? aabb.max().y() : aabb.min().y(),
+					 plane.z() >= 0.0f ? aabb.max().z() : aabb.min().z());
+		if(plane.to<3>().dot(p) + plane.w() < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool AABBTree::intersects(const math::Vec3& center, float radius, const AABB& aabb) {
+	float dist2 = 0.0f;
+	for(usize i = 0; i != 3; ++i) {
+		float v = std::clamp(center[i], aabb.min()[i], aabb.max()[i]) - center[i];
+		dist2 += v * v;
+	}
+	return dist2 <= radius * radius;
+}
+
+bool AABBTree::intersects(const math::Vec3& origin, const math::Vec3& inv_dir, float max_dist, const AABB& aabb, float& dist) {
+	float t_min = 0.0f;
+	float t_max = max_dist;
+	for(usize i = 0; i != 3; ++i) {
+		float t0 = (aabb.min()[i] - origin[i]) * inv_dir[i];
+		float t1 = (aabb.max()[i] - origin[i]) * inv_dir[i];
+		if(t0 > t1) {
+			std::swap(t0, t1);
+		}
+		t_min = std::max(t_min, t0);
+		t_max = std::min(t_max, t1);
+		if(t_min > t_max) {
+			return false;
+		}
+	}
+	dist = t_min;
+	return true;
+}
+
+}
@@ -0,0 +1,144 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SCENE_AABBTREE_H
+#define YAVE_SCENE_AABBTREE_H
+
+#include <yave/meshes/AABB.h>
+#include <yave/camera/Frustum.h>
+
+#include <y/core/Span.h>
+
+namespace yave {
+
+// Incrementally updated bounding volume hierarchy.
+// Leaves store "fat" AABBs so that small moves don't require touching the tree.
+// Insertion uses the surface area heuristic and the tree is kept balanced using rotations.
+class AABBTree : NonCopyable {
+	public:
+		using NodeId = u32;
+		static constexpr NodeId invalid_node = NodeId(-1);
+
+		struct Item {
+			AABB aabb;
+			u32 data = 0;
+		};
+
+		AABBTree(float margin = 0.1f);
+
+		NodeId insert(const AABB& aabb, u32 data);
+		void remove(NodeId node);
+
+		// returns true if the leaf had to be reinserted
+		bool update(NodeId node, const AABB& aabb);
+
+		// rebuilds the whole tree from scratch (in parallel), returns the leaf created for each item
+		core::Vector<NodeId> build(core::Span<Item> items);
+		void clear();
+
+		u32 data(NodeId node) const;
+		const AABB& fat_aabb(NodeId node) const;
+
+		usize size() const;
+		usize height() const;
+		bool is_empty() const;
+
+		template<typename F>
+		void for_each_in_frustum(const Frustum& frustum, F&& func) const {
+			query([&](const AABB& aabb) { return intersects(frustum, aabb); }, func);
+		}
+
+		template<typename F>
+		void for_each_in_sphere(const math::Vec3& center, float radius, F&& func) const {
+			query([&](const AABB& aabb) { return intersects(center, radius, aabb); }, func);
+		}
+
+		// func is called with the leaf data and the distance along the ray at which its fat AABB is entered
+		template<typename F>
+		void for_each_on_ray(const math::Vec3& origin, const math::Vec3& dir, float max_dist, F&& func) const {
+			const math::Vec3 inv_dir(1.0f / dir.x(), 1.0f / dir.y(), 1.0f / dir.z());
+			float dist = 0.0f;
+			query([&](const AABB& aabb) { return intersects(origin, inv_dir, max_dist, aabb, dist); },
+				  [&](u32 data) { func(data, dist); });
+		}
+
+		static bool intersects(const Frustum& frustum, const AABB& aabb);
+		static bool intersects(const math::Vec3& center, float radius, const AABB& aabb);
+		static bool intersects(const math::Vec3& origin, const math::Vec3& inv_dir, float max_dist, const AABB& aabb, float& dist);
+
+	private:
+		struct Node {
+			AABB aabb;
+			NodeId parent = invalid_node;
+			NodeId left = invalid_node;
+			NodeId right = invalid_node;
+			i32 height = -1;
+			u32 data = 0;
+
+			bool is_leaf() const {
+				return left == invalid_node;
+			}
+		};
+
+		template<typename T, typename F>
+		void query(T&& test, F&& func) const {
+			if(_root == invalid_node) {
+				return;
+			}
+
+			auto stack = core::vector_with_capacity<NodeId>(64);
+			stack << _root;
+			while(!stack.is_empty()) {
+				const Node& node = _nodes[stack.pop()];
+				if(!test(node.aabb)) {
+					continue;
+				}
+				if(node.is_leaf()) {
+					func(node.data);
+				} else {
+					stack << node.right;
+					stack << node.left;
+				}
+			}
+		}
+
+		NodeId alloc_node();
+		void free_node(NodeId node);
+
+		void insert_leaf(NodeId leaf);
+		void remove_leaf(NodeId leaf);
+
+		NodeId balance(NodeId node);
+
+		void build_node(u32* order, usize count, core::Span<Item> items, const math::Vec3* centers, NodeId offset, NodeId parent, NodeId* leaves);
+		void fit_node(NodeId node);
+
+		core::Vector<Node> _nodes;
+		NodeId _root = invalid_node;
+		NodeId _free = invalid_node;
+
+		usize _leaf_count = 0;
+		float _margin;
+};
+
+}
+
+#endif // YAVE_SCENE_AABBTREE_H
@@ -0,0 +1,171 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "SceneBVH.h"
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/entities/entities.h>
+
+#include <y/concurrent/concurrent.h>
+
+namespace yave {
+
+namespace {
+struct Bounds {
+	ecs::EntityIndex index;
+	const TransformableComponent* transformable;
+	const StaticMesh* mesh;
+	AABB aabb;
+};
+
+void compute_aabbs(core::Vector<Bounds>& bounds) {
+	concurrent::parallel_for_each(bounds.begin(), bounds.end(), [](Bounds& b) {
+		b.aabb = b.mesh->aabb().transformed(b.transformable->transform());
+	});
+}
+}
+
+void SceneBVH::update(const ecs::EntityWorld& world) {
+	y_profile();
+
+	const bool incremental =
+		_world == &world &&
+		world.flush_count() == _flush_count + 1 &&
+		!world.flushed_mutations<TransformableComponent>().all &&
+		!world.flushed_mutations<StaticMeshComponent>().all;
+
+	_world = &world;
+	_flush_count = world.flush_count();
+
+	if(incremental) {
+		update_dirty(world);
+	} else {
+		update_all(world);
+	}
+}
+
+void SceneBVH::update_dirty(const ecs::EntityWorld& world) {
+	y_profile();
+
+	for(ecs::EntityId id : world.flushed_deletions()) {
+		if(const Entry* entry = _entries.try_get(id.index())) {
+			_tree.remove(entry->node);
+			_entries.erase(id.index());
+		}
+	}
+
+	core::Vector<Bounds> bounds;
+	auto add_dirty = [&](core::Span<ecs::EntityIndex> indexes) {
+		for(ecs::EntityIndex index : indexes) {
+			const ecs::EntityId id = world.id_from_index(index);
+			const TransformableComponent* tr = world.component<TransformableComponent>(id);
+			const StaticMeshComponent* me = world.component<StaticMeshComponent>(id);
+			if(tr && me && me->mesh()) {
+				bounds << Bounds{index, tr, me->mesh().get(), AABB()};
+			} else if(const Entry* entry = _entries.try_get(index)) {
+				_tree.remove(entry->node);
+				_entries.erase(index);
+			}
+		}
+	};
+	add_dirty(world.flushed_mutations<TransformableComponent>().indexes);
+	add_dirty(world.flushed_mutations<StaticMeshComponent>().indexes);
+
+	compute_aabbs(bounds);
+
+	for(const Bounds& b : bounds) {
+		if(Entry* entry = _entries.try_get(b.index)) {
+			_tree.update(entry->node, b.aabb);
+		} else {
+			_entries.insert(b.index, Entry{_tree.insert(b.aabb, u32(b.index)), _generation});
+		}
+	}
+}
+
+void SceneBVH::update_all(const ecs::EntityWorld& world) {
+	y_profile();
+
+	core::Vector<Bounds> bounds;
+	for(auto e : world.view(StaticMeshArchetype())) {
+		const auto& [tr, me] = e.components();
+		if(me.mesh()) {
+			bounds << Bounds{e.index(), &tr, me.mesh().get(), AABB()};
+		}
+	}
+
+	compute_aabbs(bounds);
+
+	const u32 generation = ++_generation;
+
+	if(_tree.is_empty() && bounds.size() >= rebuild_threshold) {
+		// large import: build the whole tree at once
+		_entries.clear();
+		auto items = core::vector_with_capacity<AABBTree::Item>(bounds.size());
+		for(const Bounds& b : bounds) {
+			items << AABBTree::Item{b.aabb, u32(b.index)};
+		}
+		auto leaves = _tree.build(items);
+		for(usize i = 0; i != bounds.size(); ++i) {
+			_entries.insert(bounds[i].index, Entry{leaves[i], generation});
+		}
+		return;
+	}
+
+	for(const Bounds& b : bounds) {
+		if(Entry* entry = _entries.try_get(b.index)) {
+			_tree.update(entry->node, b.aabb);
+			entry->generation = generation;
+		} else {
+			_entries.insert(b.index, Entry{_tree.insert(b.aabb, u32(b.index)), generation});
+		}
+	}
+
+	core::Vector<ecs::EntityIndex> removed;
+	for(const auto& [index, entry] : _entries.as_pairs()) {
+		if(entry.generation != generation) {
+			_tree.remove(entry.node);
+			removed << index;
+		}
+	}
+	for(ecs::EntityIndex index : removed) {
+		_entries.erase(index);
+	}
+}
+
+void SceneBVH::clear() {
+	_tree.clear();
+	_entries.clear();
+	_world = nullptr;
+}
+
+const AABBTree& SceneBVH::tree() const {
+	return _tree;
+}
+
+usize SceneBVH::size() const {
+	return _tree.size();
+}
+
+}
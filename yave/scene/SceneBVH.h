@@ -0,0 +1,89 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SCENE_SCENEBVH_H
+#define YAVE_SCENE_SCENEBVH_H
+
+#include "AABBTree.h"
+
+#include <yave/ecs/EntityId.h>
+
+#include <y/core/SparseVector.h>
+
+namespace yave {
+
+namespace ecs {
+class EntityWorld;
+}
+
+// Keeps an AABBTree in sync with the static meshes of an EntityWorld.
+// Entities are identified by their index in the tree.
+// update() should be called after every EntityWorld::flush: it then only refits the entities
+// whose components were modified or removed since the previous flush.
+// Skipping a flush (or changing world) falls back to rescanning every entity.
+class SceneBVH : NonCopyable {
+	public:
+		SceneBVH() = default;
+
+		void update(const ecs::EntityWorld& world);
+		void clear();
+
+		const AABBTree& tree() const;
+		usize size() const;
+
+		template<typename F>
+		void for_each_in_frustum(const Frustum& frustum, F&& func) const {
+			_tree.for_each_in_frustum(frustum, [&](u32 index) { func(ecs::EntityIndex(index)); });
+		}
+
+		template<typename F>
+		void for_each_in_sphere(const math::Vec3& center, float radius, F&& func) const {
+			_tree.for_each_in_sphere(center, radius, [&](u32 index) { func(ecs::EntityIndex(index)); });
+		}
+
+		template<typename F>
+		void for_each_on_ray(const math::Vec3& origin, const math::Vec3& dir, float max_dist, F&& func) const {
+			_tree.for_each_on_ray(origin, dir, max_dist, [&](u32 index, float dist) { func(ecs::EntityIndex(index), dist); });
+		}
+
+	private:
+		void update_all(const ecs::EntityWorld& world);
+		void update_dirty(const ecs::EntityWorld& world);
+
+		// below this, inserting entities one by one is cheap enough
+		static constexpr usize rebuild_threshold = 1024;
+
+		struct Entry {
+			AABBTree::NodeId node;
+			u32 generation;
+		};
+
+		AABBTree _tree;
+		core::SparseVector<Entry, ecs::EntityIndex> _entries;
+		u32 _generation = 0;
+
+		const ecs::EntityWorld* _world = nullptr;
+		u64 _flush_count = 0;
+};
+
+}
+
+#endif // YAVE_SCENE_SCENEBVH_H
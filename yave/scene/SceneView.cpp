@@ -31,15 +31,30 @@ SceneView::SceneView(const ecs::EntityWorld* wor, Camera cam) :
 		_camera(cam) {
 }
 
+SceneView::SceneView(const ecs::EntityWorld* wor, const SceneBVH* bvh, Camera cam) :
+		_world(wor),
+		_bvh(bvh),
+		_camera(cam) {
+}
+
 const ecs::EntityWorld& SceneView::world() const {
 	y_debug_assert(has_world());
 	return *_world;
 }
 
+const SceneBVH& SceneView::bvh() const {
+	y_debug_assert(has_bvh());
+	return *_bvh;
+}
+
 bool SceneView::has_world() const {
 	return _world;
 }
 
+bool SceneView::has_bvh() const {
+	return _bvh;
+}
+
 const Camera& SceneView::camera() const {
 	return _camera;
 }
@@ -48,4 +63,22 @@ Camera& SceneView::camera() {
 	return _camera;
 }
 
+SceneRenderStats SceneView::stats() const {
+	std::unique_lock lock(_stats->lock);
+	return _stats->stats;
+}
+
+void SceneView::publish_stats(const SceneRenderStats& stats) const {
+	std::unique_lock lock(_stats->lock);
+	_stats->stats = stats;
+}
+
+void SceneView::set_async_pipeline_compilation(bool async) {
+	_async_pipelines = async;
+}
+
+bool SceneView::async_pipeline_compilation() const {
+	return _async_pipelines;
+}
+
 }
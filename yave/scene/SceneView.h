@@ -24,29 +24,65 @@ SOFTWARE.
 
 #include <yave/camera/Camera.h>
 
+#include <memory>
+#include <mutex>
+
 namespace yave {
 
 namespace ecs {
 class EntityWorld;
 }
 
+class SceneBVH;
+
+struct SceneRenderStats {
+	usize visible_meshes = 0;
+	usize culled_meshes = 0;
+	usize draw_calls = 0;
+	usize pending_pipelines = 0;
+	usize pending_uploads = 0;
+	usize dropped_meshes = 0;
+};
+
 class SceneView {
 	public:
 		SceneView() = default;
 		SceneView(const ecs::EntityWorld* wor, Camera cam = Camera());
+		SceneView(const ecs::EntityWorld* wor, const SceneBVH* bvh, Camera cam = Camera());
 
 		const ecs::EntityWorld& world() const;
+		const SceneBVH& bvh() const;
 
 		bool has_scene() const;
 		bool has_world() const;
+		bool has_bvh() const;
 
 
 		const Camera& camera() const;
 		Camera& camera();
 
+		// Stats are shared between copies so that stats published during rendering are visible from the original view.
+		// Renderers fill their own SceneRenderStats and publish it once recording is done, readers get a copy.
+		SceneRenderStats stats() const;
+		void publish_stats(const SceneRenderStats& stats) const;
+
+		// When enabled, meshes whose material pipeline isn't compiled yet are skipped while it compiles on the thread pool
+		void set_async_pipeline_compilation(bool async);
+		bool async_pipeline_compilation() const;
+
 	private:
 		const ecs::EntityWorld* _world = nullptr;
+		const SceneBVH* _bvh = nullptr;
 		Camera _camera;
+
+		bool _async_pipelines = false;
+
+		struct SharedStats {
+			std::mutex lock;
+			SceneRenderStats stats;
+		};
+
+		std::shared_ptr<SharedStats> _stats = std::make_shared<SharedStats>();
 };
 
 }
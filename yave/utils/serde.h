@@ -35,6 +35,7 @@ static constexpr u32 magic_number = 0x65766179;
 }
 
 class AssetLoader;
+class AssetPrefetch;
 
 using WritableAssetArchive = serde2::WritableArchive;
 
@@ -49,12 +50,22 @@ class ReadableAssetArchive : public serde2::ReadableArchiveBase<ReadableAssetArc
 		ReadableAssetArchive(const io2::ReaderPtr& reader, AssetLoader& loader) : ReadableAssetArchive(*reader, loader) {
 		}
 
+		// Referenced assets are scheduled into prefetch instead of being loaded
+		ReadableAssetArchive(io2::Reader& reader, AssetLoader& loader, AssetPrefetch& prefetch) : ReadableAssetArchive(reader, loader) {
+			_prefetch = &prefetch;
+		}
+
 		AssetLoader& loader() {
 			return _loader;
 		}
 
+		AssetPrefetch* prefetch() {
+			return _prefetch;
+		}
+
 	private:
 		AssetLoader& _loader;
+		AssetPrefetch* _prefetch = nullptr;
 
 };
 